@@ -0,0 +1,156 @@
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <random>
+
+#include "../src/s21_map/s21_map.h"
+#include "../src/s21_vector/s21_vector.h"
+
+// Counter workload: m[key]++ over a stream of keys drawn from a smaller key
+// space, so most calls hit a key that is already present.
+
+namespace {
+
+constexpr int kStream = 2000000;
+constexpr int kDistinct = 100000;
+
+// keeps results alive so the loops are not optimized away
+volatile long sink = 0;
+
+template <typename Fn>
+double time_ms(Fn fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+s21::vector<int> key_stream() {
+  std::mt19937 gen(7);
+  s21::vector<int> keys;
+  keys.reserve(kStream);
+  for (int i = 0; i < kStream; ++i) {
+    keys.push_back(static_cast<int>(gen() % kDistinct));
+  }
+  return keys;
+}
+
+void report(const char* label, double s21_ms, double std_ms) {
+  std::printf("  %-18s S21Map: %9.2f ms  std::map: %9.2f ms\n", label,
+              s21_ms, std_ms);
+}
+
+template <typename Map>
+double count_keys(const s21::vector<int>& keys) {
+  return time_ms([&] {
+    Map m;
+    for (int key : keys) m[key]++;
+    sink = sink + static_cast<long>(m.size());
+  });
+}
+
+template <typename Map>
+double insert_keys(const s21::vector<int>& keys) {
+  return time_ms([&] {
+    Map m;
+    for (int key : keys) m.insert({key, key});
+    sink = sink + static_cast<long>(m.size());
+  });
+}
+
+template <typename Map>
+double iterate(const Map& m) {
+  return time_ms([&] {
+    long total = 0;
+    for (int pass = 0; pass < 20; ++pass) {
+      for (auto it = m.begin(); it != m.end(); ++it) total += (*it).second;
+    }
+    sink = sink + total;
+  });
+}
+
+}  // namespace
+
+int main() {
+  std::printf("s21::S21Map vs std::map, %d keys over %d distinct\n", kStream,
+              kDistinct);
+  s21::vector<int> keys = key_stream();
+  report("m[key]++", count_keys<s21::S21Map<int, long>>(keys),
+         count_keys<std::map<int, long>>(keys));
+  report("insert", insert_keys<s21::S21Map<int, int>>(keys),
+         insert_keys<std::map<int, int>>(keys));
+
+  // nodes inserted in random key order, so neighbours are scattered
+  s21::S21Map<int, long> counts;
+  std::map<int, long> std_counts;
+  for (int key : keys) {
+    counts[key]++;
+    std_counts[key]++;
+  }
+  report("iterate x20", iterate(counts), iterate(std_counts));
+  double compact_ms = time_ms([&] { counts.compact(); });
+  report("compact", compact_ms, 0.0);
+  report("iterate compacted", iterate(counts), iterate(std_counts));
+
+  // leaderboard queries: S21RankedMap in O(log n), std::map walks from begin
+  s21::S21RankedMap<int, long> ranked;
+  for (int key : keys) ranked[key]++;
+  double ranked_ms = time_ms([&] {
+    long total = 0;
+    for (int i = 0; i < 100; ++i) {
+      total += static_cast<long>(ranked.rank(keys[i]));
+      total += (*ranked.select(static_cast<std::size_t>(i) * 997)).first;
+    }
+    sink = sink + total;
+  });
+  double walk_ms = time_ms([&] {
+    long total = 0;
+    for (int i = 0; i < 100; ++i) {
+      total += std::distance(std_counts.begin(),
+                             std_counts.lower_bound(keys[i]));
+      total += std::next(std_counts.begin(), i * 997)->first;
+    }
+    sink = sink + total;
+  });
+  report("rank+select x100", ranked_ms, walk_ms);
+
+  // a sorted dump: one O(n) build against n inserts
+  s21::vector<std::pair<int, int>> dump;
+  for (int i = 0; i < kStream / 2; ++i) dump.push_back({i * 2, i});
+  double sorted_ms = time_ms([&] {
+    s21::S21Map<int, int> m(s21::sorted_unique, dump.begin(), dump.end());
+    sink = sink + static_cast<long>(m.size());
+  });
+  double inserts_ms = time_ms([&] {
+    s21::S21Map<int, int> m;
+    for (const auto& item : dump) m.insert(item.first, item.second);
+    sink = sink + static_cast<long>(m.size());
+  });
+  report("sorted build", sorted_ms, 0.0);
+  report("insert sorted", inserts_ms, 0.0);
+
+  s21::S21Map<int, int> evens(s21::sorted_unique, dump.begin(), dump.end());
+  s21::S21Map<int, int> odds;
+  std::map<int, int> std_evens(dump.begin(), dump.end());
+  std::map<int, int> std_odds;
+  for (int i = 0; i < kStream / 2; ++i) {
+    odds.insert(i * 2 + 1, i);
+    std_odds.emplace(i * 2 + 1, i);
+  }
+  report("merge", time_ms([&] { evens.merge(odds); }),
+         time_ms([&] { std_evens.merge(std_odds); }));
+
+  // re-keying through node handles: no allocation per entry
+  auto rekey = [](auto& m) {
+    return time_ms([&] {
+      for (int i = 0; i < kStream / 4; ++i) {
+        auto nh = m.extract(i);
+        nh.key() = -1 - i;
+        m.insert(std::move(nh));
+      }
+    });
+  };
+  report("extract+insert", rekey(evens), rekey(std_evens));
+  return 0;
+}
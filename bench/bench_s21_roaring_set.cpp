@@ -0,0 +1,94 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+#include "../src/s21_roaring_set/s21_roaring_set.h"
+#include "../src/s21_set/s21_set.h"
+
+// Dense ids: ten million slots of which about 3/4 (and a shifted 3/4 for
+// the second set) are present, as s21::set<uint32_t> and as roaring_set.
+
+namespace {
+
+constexpr std::uint32_t kIds = 10000000;
+
+// keeps results alive so the loops are not optimized away
+volatile std::size_t sink = 0;
+
+template <typename Fn>
+double time_ms(Fn fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+s21::vector<std::uint32_t> dense_ids(unsigned seed) {
+  std::mt19937 gen(seed);
+  s21::vector<std::uint32_t> ids;
+  for (std::uint32_t id = 0; id < kIds; ++id) {
+    if (gen() % 4 != 0) ids.push_back(id);
+  }
+  return ids;
+}
+
+void report(const char* label, double set_value, double roaring_value,
+            const char* unit) {
+  std::printf("  %-18s set: %9.2f %s  roaring_set: %9.2f %s\n", label,
+              set_value, unit, roaring_value, unit);
+}
+
+}  // namespace
+
+int main() {
+  std::printf("s21::roaring_set vs s21::set, %u dense ids\n", kIds);
+  s21::vector<std::uint32_t> left_ids = dense_ids(1);
+  s21::vector<std::uint32_t> right_ids = dense_ids(2);
+
+  s21::set<std::uint32_t> left(left_ids.begin(), left_ids.end());
+  s21::set<std::uint32_t> right(right_ids.begin(), right_ids.end());
+  s21::roaring_set<> roaring_left(left_ids.begin(), left_ids.end());
+  s21::roaring_set<> roaring_right(right_ids.begin(), right_ids.end());
+
+  // the set also keeps vector slack and its search index on top of this
+  double set_bytes = static_cast<double>(left.size() * sizeof(std::uint32_t));
+  report("memory", set_bytes / 1e6,
+         static_cast<double>(roaring_left.memory_usage()) / 1e6, "MB");
+
+  std::mt19937 gen(3);
+  s21::vector<std::uint32_t> probes;
+  for (int i = 0; i < 2000000; ++i) probes.push_back(gen() % kIds);
+  auto lookups = [&](const auto& s) {
+    return time_ms([&] {
+      std::size_t found = 0;
+      for (std::uint32_t id : probes) found += s.contains(id);
+      sink = found;
+    });
+  };
+  report("2M lookups", lookups(left), lookups(roaring_left), "ms");
+
+  report("intersection",
+         time_ms([&] { sink = s21::set_intersection(left, right).size(); }),
+         time_ms([&] {
+           sink = s21::set_intersection(roaring_left, roaring_right).size();
+         }),
+         "ms");
+  report("union", time_ms([&] { sink = s21::set_union(left, right).size(); }),
+         time_ms([&] {
+           sink = s21::set_union(roaring_left, roaring_right).size();
+         }),
+         "ms");
+  report("iteration", time_ms([&] {
+           std::size_t sum = 0;
+           for (std::uint32_t id : left) sum += id;
+           sink = sum;
+         }),
+         time_ms([&] {
+           std::size_t sum = 0;
+           for (std::uint32_t id : roaring_left) sum += id;
+           sink = sum;
+         }),
+         "ms");
+  return 0;
+}
@@ -0,0 +1,186 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "../src/s21_set/s21_set.h"
+
+namespace {
+
+constexpr int kSmall = 100000;
+constexpr int kLarge = 1000000;
+
+// keeps lookup results alive so the loops are not optimized away
+volatile int sink = 0;
+
+template <typename Fn>
+double time_ms(Fn fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+s21::vector<int> random_ints(int n) {
+  std::mt19937 gen(7);
+  s21::vector<int> keys;
+  keys.reserve(n);
+  for (int i = 0; i < n; ++i) keys.push_back(static_cast<int>(gen()));
+  return keys;
+}
+
+s21::vector<std::string> random_strings(int n) {
+  std::mt19937 gen(7);
+  s21::vector<std::string> keys;
+  keys.reserve(n);
+  for (int i = 0; i < n; ++i) keys.push_back(std::to_string(gen()));
+  return keys;
+}
+
+void report(const char* label, int n, double ms) {
+  std::printf("  %-18s %8d keys: %9.2f ms\n", label, n, ms);
+}
+
+// the search every set used before branchless_lower_bound
+template <typename T>
+bool branching_contains(const s21::vector<T>& keys, T key) {
+  std::size_t left = 0;
+  std::size_t right = keys.size();
+  while (left < right) {
+    std::size_t mid = left + (right - left) / 2;
+    if (keys[mid] == key) {
+      return true;
+    } else if (keys[mid] < key) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return false;
+}
+
+template <typename T>
+bool branchless_contains(const s21::vector<T>& keys, T key) {
+  const T* pos = s21::branchless_lower_bound(keys.data(), keys.size(), key);
+  return pos != keys.data() + keys.size() && *pos == key;
+}
+
+// random probes, half of them hits, on n sorted keys of type T
+template <typename T>
+void search_kernels(const char* type, int n) {
+  s21::vector<T> keys;
+  for (int i = 0; i < n; ++i) keys.push_back(static_cast<T>(2 * i));
+  std::mt19937 gen(13);
+  s21::vector<T> probes;
+  for (int i = 0; i < 2000000; ++i) {
+    probes.push_back(static_cast<T>(gen() % (2u * n)));
+  }
+  auto run = [&](auto contains) {
+    return time_ms([&] {
+      int found = 0;
+      for (T key : probes) found += contains(keys, key);
+      sink = found;
+    });
+  };
+  std::printf("  %s\n", type);
+  report("branching", n, run(branching_contains<T>));
+  report("branchless", n, run(branchless_contains<T>));
+}
+
+}  // namespace
+
+int main() {
+  std::printf("s21::set construction\n");
+
+  s21::vector<int> small = random_ints(kSmall);
+  report("insert per int", kSmall, time_ms([&] {
+           s21::set<int> s;
+           for (int key : small) s.insert(key);
+         }));
+  report("buffered per int", kSmall, time_ms([&] {
+           s21::set<int> s;
+           for (int key : small) s.buffered_insert(key);
+           s.flush();
+         }));
+  report("hinted ascending", kLarge, time_ms([&] {
+           s21::set<int> s;
+           for (int key = 0; key < kLarge; ++key) s.insert(s.end(), key);
+         }));
+  report("bulk int", kSmall,
+         time_ms([&] { s21::set<int> s(small.begin(), small.end()); }));
+
+  s21::vector<int> large = random_ints(kLarge);
+  report("bulk int", kLarge,
+         time_ms([&] { s21::set<int> s(std::move(large)); }));
+
+  s21::vector<std::string> words = random_strings(kLarge);
+  report("bulk string", kLarge,
+         time_ms([&] { s21::set<std::string> s(std::move(words)); }));
+
+  s21::set<int> source(random_ints(kLarge));
+  report("copy int", kLarge, time_ms([&] { s21::set<int> copy(source); }));
+
+  s21::vector<int> evens, odds;
+  for (int i = 0; i < kLarge; ++i) {
+    evens.push_back(2 * i);
+    odds.push_back(2 * i + 1);
+  }
+  s21::set<int> left(std::move(evens));
+  s21::set<int> right(std::move(odds));
+  report("merge interleaved", kLarge, time_ms([&] { left.merge(right); }));
+
+  // random lookups, half of them hits, on a set far larger than the caches
+  constexpr int kHuge = 10000000;
+  constexpr int kLookups = 2000000;
+  s21::vector<int> even;
+  even.reserve(kHuge);
+  for (int i = 0; i < kHuge; ++i) even.push_back(2 * i);
+  s21::set<int> indexed(std::move(even));
+  std::mt19937 gen(11);
+  s21::vector<int> probes;
+  for (int i = 0; i < kLookups; ++i) {
+    probes.push_back(static_cast<int>(gen() % (2u * kHuge)));
+  }
+  auto lookups = [&](const s21::set<int>& s) {
+    return time_ms([&] {
+      int found = 0;
+      for (int key : probes) found += s.contains(key);
+      sink = found;
+    });
+  };
+  report("eytzinger lookups", kHuge, lookups(indexed));
+  indexed.insert(-1);
+  report("branchless lookups", kHuge, lookups(indexed));
+
+  std::printf("s21::set intersection\n");
+  for (int small_size : {kLarge, kLarge / 100, 1000}) {
+    s21::set<int> big(random_ints(kLarge));
+    s21::vector<int> picked;
+    std::mt19937 pick(3);
+    // half of the keys are taken from big, half are random
+    for (int i = 0; i < small_size; ++i) {
+      int hit = *(big.begin() + static_cast<int>(pick() % kLarge));
+      picked.push_back(i % 2 ? static_cast<int>(pick()) : hit);
+    }
+    s21::set<int> other(std::move(picked));
+    report("contains loop", small_size, time_ms([&] {
+             s21::set<int> result;
+             for (int key : other) {
+               if (big.contains(key)) result.insert(result.end(), key);
+             }
+             sink = static_cast<int>(result.size());
+           }));
+    report("set_intersection", small_size, time_ms([&] {
+             sink = static_cast<int>(s21::set_intersection(big, other).size());
+           }));
+  }
+
+  std::printf("s21::set lower_bound kernels, 2M lookups\n");
+  for (int n : {1000, 64000, kLarge}) {
+    search_kernels<int>("int", n);
+    search_kernels<std::uint64_t>("uint64_t", n);
+    search_kernels<double>("double", n);
+  }
+  return 0;
+}
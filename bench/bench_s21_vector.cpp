@@ -0,0 +1,149 @@
+#include <chrono>
+#include <cstdio>
+
+#include "../src/s21_vector/s21_mmap_allocator.h"
+#include "../src/s21_vector/s21_vector.h"
+
+// int takes the memmove/memcpy paths, BoxedInt has the same layout but a
+// user-provided copy, so it is shifted and relocated element by element.
+
+namespace {
+
+struct BoxedInt {
+  int value;
+
+  BoxedInt(int v = 0) : value(v) {}
+  BoxedInt(const BoxedInt& other) : value(other.value) {}
+  BoxedInt& operator=(const BoxedInt& other) {
+    value = other.value;
+    return *this;
+  }
+};
+
+constexpr int kSize = 1000000;
+constexpr int kOps = 2000;
+
+template <typename T>
+double middle_insert_erase() {
+  s21::vector<T> v;
+  v.reserve(kSize + kOps);
+  for (int i = 0; i < kSize; ++i) v.push_back(T(i));
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kOps; ++i) {
+    v.insert(v.begin() + v.size() / 2, T(i));
+  }
+  for (int i = 0; i < kOps; ++i) {
+    v.erase(v.begin() + v.size() / 2);
+  }
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+template <typename T>
+double middle_insert_many() {
+  s21::vector<T> v;
+  v.reserve(kSize + 3 * kOps);
+  for (int i = 0; i < kSize; ++i) v.push_back(T(i));
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kOps; ++i) {
+    v.insert_many(v.begin() + v.size() / 2, T(i), T(i + 1), T(i + 2));
+  }
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+template <typename T>
+double growth() {
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < 10; ++round) {
+    s21::vector<T> v;
+    for (int i = 0; i < kSize; ++i) v.push_back(T(i));
+    v.shrink_to_fit();
+  }
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+// Average share of allocated bytes left idle while a vector grows by
+// push_back, sampled after every insertion, plus the reallocation count.
+template <typename Growth>
+void growth_waste(const char* name) {
+  s21::vector<int, std::allocator<int>, Growth> v;
+  double waste = 0;
+  int reallocations = 0;
+  for (int i = 0; i < kSize; ++i) {
+    std::size_t before = v.capacity();
+    v.push_back(i);
+    if (v.capacity() != before) ++reallocations;
+    waste += double(v.wasted_capacity()) / double(v.capacity());
+  }
+  std::printf("  %-13s idle %5.1f%%, %2d reallocations\n", name,
+              100.0 * waste / kSize, reallocations);
+}
+
+// Splices kOps elements into the middle of a kSize vector, element by
+// element or as one range.
+template <bool Range>
+double splice() {
+  s21::vector<BoxedInt> v;
+  for (int i = 0; i < kSize; ++i) v.push_back(BoxedInt(i));
+  s21::vector<BoxedInt> items(kOps);
+
+  auto start = std::chrono::steady_clock::now();
+  if constexpr (Range) {
+    v.insert(v.begin() + kSize / 2, items.begin(), items.end());
+  } else {
+    for (int i = 0; i < kOps; ++i) {
+      v.insert(v.begin() + kSize / 2 + i, items[i]);
+    }
+  }
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+// push_back into a vector that ends up at kHugeSize elements; with
+// mmap_allocator every growth past 64 MiB is an mremap instead of a copy.
+constexpr int kHugeSize = 128 << 20;
+
+template <typename Vector>
+double huge_growth() {
+  auto start = std::chrono::steady_clock::now();
+  Vector v;
+  for (int i = 0; i < kHugeSize; ++i) v.push_back(i);
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+void report(const char* title, double trivial, double generic) {
+  std::printf("%s\n", title);
+  std::printf("  trivially copyable (memmove): %8.2f ms\n", trivial);
+  std::printf("  element-wise:                 %8.2f ms\n", generic);
+  std::printf("  speedup:                      %8.2fx\n", generic / trivial);
+}
+
+}  // namespace
+
+int main() {
+  std::printf("s21::vector, %d elements\n", kSize);
+  report("middle insert + erase (2000 each):",
+         middle_insert_erase<int>(), middle_insert_erase<BoxedInt>());
+  report("middle insert_many of 3 (2000 calls):",
+         middle_insert_many<int>(), middle_insert_many<BoxedInt>());
+  report("push_back growth + shrink_to_fit (x10):", growth<int>(),
+         growth<BoxedInt>());
+  std::printf("growth policy, push_back of %d ints:\n", kSize);
+  growth_waste<s21::growth::doubling>("doubling");
+  growth_waste<s21::growth::one_and_half>("one_and_half");
+  growth_waste<s21::growth::usable_size>("usable_size");
+  std::printf("splice of %d elements into the middle:\n", kOps);
+  std::printf("  insert per element: %8.2f ms\n", splice<false>());
+  std::printf("  range insert:       %8.2f ms\n", splice<true>());
+  std::printf("push_back of %d ints (512 MiB):\n", kHugeSize);
+  std::printf("  s21::vector:      %8.2f ms\n",
+              huge_growth<s21::vector<int>>());
+  std::printf("  s21::huge_vector: %8.2f ms\n",
+              huge_growth<s21::huge_vector<int>>());
+  return 0;
+}
@@ -4,10 +4,14 @@
 #include "./src/s21_array/s21_array.h"
 #include "./src/s21_list/s21_list.h"
 #include "./src/s21_map/s21_map.h"
+#include "./src/s21_mapped_vector/s21_mapped_vector.h"
 #include "./src/s21_multiset/s21_multiset.h"
 #include "./src/s21_queue/s21_queue.h"
+#include "./src/s21_roaring_set/s21_roaring_set.h"
 #include "./src/s21_set/s21_set.h"
+#include "./src/s21_small_vector/s21_small_vector.h"
 #include "./src/s21_stack/s21_stack.h"
+#include "./src/s21_vector/s21_mmap_allocator.h"
 #include "./src/s21_vector/s21_vector.h"
 
 #endif
\ No newline at end of file
@@ -4,11 +4,17 @@
 #include <initializer_list>
 // #include <iostream>  // for debug
 #include <limits>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+#include "../s21_node_pool/s21_node_pool.h"
 
 using std::size_t;
 
 namespace s21 {
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>>
 class S21List {
  private:
   struct Node {
@@ -18,18 +24,40 @@ class S21List {
 
     // constructor for struct Node
     Node(T d, Node* p = nullptr, Node* n = nullptr)
-        : data(d), prev(p), next(n) {}
+        : data(std::move(d)), prev(p), next(n) {}
   };
 
+  using node_allocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<Node>;
+  using node_traits = std::allocator_traits<node_allocator>;
+
+  static constexpr bool nothrow_move_assign =
+      node_traits::propagate_on_container_move_assignment::value ||
+      node_traits::is_always_equal::value;
+
   Node* head;
   Node* tail;
   size_t size_;
+  [[no_unique_address]] node_allocator node_alloc_;
+  // slabs the nodes are carved from, released by clear()
+  node_pool<Node, node_allocator> pool_;
+
+  /**
+   * @brief takes a node from the pool and constructs it through the list
+   * allocator
+   */
+  Node* createNode(const T& value, Node* prev, Node* next);
+
+  /**
+   * @brief destroys a node created by createNode and returns it to the pool
+   */
+  void destroyNode(Node* node);
 
  public:
   class ListIterator {
    private:
     Node* node_;
-    friend class S21List<T>;
+    friend class S21List<T, Allocator>;
 
    public:
     // constructor for iterator
@@ -79,7 +107,7 @@ class S21List {
   class ListConstIterator {
    private:
     Node* node_;
-    friend class S21List<T>;
+    friend class S21List<T, Allocator>;
 
    public:
     // constructor for iterator
@@ -124,6 +152,7 @@ class S21List {
   };
 
   using value_type = T;
+  using allocator_type = Allocator;
   using reference = T&;
   using const_reference = const T&;
   using iterator = ListIterator;
@@ -139,6 +168,9 @@ class S21List {
   // constructor default
   S21List();
 
+  // constructor with allocator
+  explicit S21List(const Allocator& alloc);
+
   // constructor with one parameter size_
   S21List(size_t n);
 
@@ -154,8 +186,25 @@ class S21List {
   // destructor
   ~S21List();
 
+  /**
+   * @brief returns the allocator associated with the container
+   */
+  allocator_type get_allocator() const;
+
+  /**
+   * @brief clears the contents and returns the node slabs to the allocator
+   */
   void clear() noexcept;
 
+  /**
+   * @brief moves every element into one new slab in list order, so that
+   * iteration reads memory front to back; old slabs are released.
+   * Invalidates iterators and references, the allocator briefly holds
+   * both copies
+   */
+  void compact()
+    requires std::is_nothrow_move_constructible_v<T>;
+
   /**
    * @brief inserts element into concrete pos and returns the iterator that
    * points to the new element
@@ -208,7 +257,10 @@ class S21List {
   void reverse() noexcept;
 
   /**
-   * @brief transfers elements from list other starting from pos
+   * @brief transfers elements from list other starting from pos, together
+   * with the slabs they live in (the allocators must compare equal). The
+   * slabs stay with this list until clear(), compact() or destruction, and
+   * other takes new slabs when it is refilled
    */
   void splice(const ListIterator pos, S21List& other);
 
@@ -254,7 +306,7 @@ class S21List {
 
   S21List& operator=(const S21List& other);
 
-  S21List& operator=(S21List&& other) noexcept;
+  S21List& operator=(S21List&& other) noexcept(nothrow_move_assign);
 
   /**
    * @brief inserts new elements into the container directly before pos
@@ -283,6 +335,13 @@ class S21List {
   // FOR DEBUG
 };
 
+namespace pmr {
+
+template <typename T>
+using S21List = s21::S21List<T, std::pmr::polymorphic_allocator<T>>;
+
+}  // namespace pmr
+
 }  // namespace s21
 
 #include "s21_list.tpp"
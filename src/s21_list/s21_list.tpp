@@ -2,22 +2,32 @@
 #define S21_LIST_TPP
 
 namespace s21 {
-template <typename T>
-S21List<T>::S21List() : head(nullptr), tail(nullptr), size_(0){};
+template <typename T, typename Allocator>
+S21List<T, Allocator>::S21List() : head(nullptr), tail(nullptr), size_(0){};
 
-template <typename T>
-S21List<T>::S21List(size_t n) : head(nullptr), tail(nullptr), size_(n){};
+template <typename T, typename Allocator>
+S21List<T, Allocator>::S21List(const Allocator& alloc)
+    : head(nullptr), tail(nullptr), size_(0), node_alloc_(alloc){};
 
-template <typename T>
-S21List<T>::S21List(std::initializer_list<T> const& items) : S21List{} {
+template <typename T, typename Allocator>
+S21List<T, Allocator>::S21List(size_t n)
+    : head(nullptr), tail(nullptr), size_(n){};
+
+template <typename T, typename Allocator>
+S21List<T, Allocator>::S21List(std::initializer_list<T> const& items)
+    : S21List{} {
   for (const auto& item : items) {
     push_back(item);
   }
 };
 
-template <typename T>
-S21List<T>::S21List(const S21List& other)
-    : head(nullptr), tail(nullptr), size_(0) {
+template <typename T, typename Allocator>
+S21List<T, Allocator>::S21List(const S21List& other)
+    : head(nullptr),
+      tail(nullptr),
+      size_(0),
+      node_alloc_(node_traits::select_on_container_copy_construction(
+          other.node_alloc_)) {
   Node* current = other.head;
   while (current) {
     push_back(current->data);
@@ -25,50 +35,114 @@ S21List<T>::S21List(const S21List& other)
   }
 };
 
-template <typename T>
-S21List<T>::S21List(S21List&& other) noexcept
-    : head(other.head), tail(other.tail), size_(other.size_) {
+template <typename T, typename Allocator>
+S21List<T, Allocator>::S21List(S21List&& other) noexcept
+    : head(other.head),
+      tail(other.tail),
+      size_(other.size_),
+      node_alloc_(std::move(other.node_alloc_)),
+      pool_(std::move(other.pool_)) {
   other.head = nullptr;
   other.tail = nullptr;
   other.size_ = 0;
 };
 
-template <typename T>
-S21List<T>::~S21List() {
+template <typename T, typename Allocator>
+S21List<T, Allocator>::~S21List() {
   clear();
 };
 
-template <typename T>
-void S21List<T>::clear() noexcept {
-  while (head) {
-    Node* tmp = head;
-    head = head->next;
-    delete tmp;
+template <typename T, typename Allocator>
+typename S21List<T, Allocator>::allocator_type
+S21List<T, Allocator>::get_allocator() const {
+  return allocator_type(node_alloc_);
+}
+
+template <typename T, typename Allocator>
+typename S21List<T, Allocator>::Node* S21List<T, Allocator>::createNode(
+    const T& value, Node* prev, Node* next) {
+  Node* node = pool_.allocate(node_alloc_);
+  try {
+    node_traits::construct(node_alloc_, node, value, prev, next);
+  } catch (...) {
+    pool_.deallocate(node);
+    throw;
+  }
+  return node;
+}
+
+template <typename T, typename Allocator>
+void S21List<T, Allocator>::destroyNode(Node* node) {
+  node_traits::destroy(node_alloc_, node);
+  pool_.deallocate(node);
+}
+
+template <typename T, typename Allocator>
+void S21List<T, Allocator>::clear() noexcept {
+  // nodes without destructors are not walked, the slabs go back at once
+  if constexpr (!std::is_trivially_destructible_v<Node>) {
+    for (Node* current = head; current;) {
+      Node* next = current->next;
+      node_traits::destroy(node_alloc_, current);
+      current = next;
+    }
   }
+  pool_.release(node_alloc_);
+  head = nullptr;
   tail = nullptr;
   size_ = 0;
 };
 
-template <typename T>
-typename S21List<T>::ListIterator S21List<T>::begin() {
+template <typename T, typename Allocator>
+void S21List<T, Allocator>::compact()
+  requires std::is_nothrow_move_constructible_v<T>
+{
+  if (!head) return;
+  node_pool<Node, node_allocator> fresh;
+  // after reserve nothing below allocates or throws
+  fresh.reserve(node_alloc_, size_);
+  Node* prev = nullptr;
+  for (Node* current = head; current;) {
+    Node* moved = fresh.allocate(node_alloc_);
+    node_traits::construct(node_alloc_, moved, std::move(current->data), prev,
+                           nullptr);
+    if (prev) {
+      prev->next = moved;
+    } else {
+      head = moved;
+    }
+    prev = moved;
+    Node* next = current->next;
+    node_traits::destroy(node_alloc_, current);
+    current = next;
+  }
+  tail = prev;
+  pool_.release(node_alloc_);
+  pool_.swap(fresh);
+}
+
+template <typename T, typename Allocator>
+typename S21List<T, Allocator>::ListIterator S21List<T, Allocator>::begin() {
   return ListIterator(head);
 }
-template <typename T>
-typename S21List<T>::ListIterator S21List<T>::end() {
+template <typename T, typename Allocator>
+typename S21List<T, Allocator>::ListIterator S21List<T, Allocator>::end() {
   return ListIterator(nullptr);
 }
 
-template <typename T>
-typename S21List<T>::ListConstIterator S21List<T>::begin() const {
+template <typename T, typename Allocator>
+typename S21List<T, Allocator>::ListConstIterator S21List<T, Allocator>::begin()
+    const {
   return ListConstIterator(head);
 }
-template <typename T>
-typename S21List<T>::ListConstIterator S21List<T>::end() const {
+template <typename T, typename Allocator>
+typename S21List<T, Allocator>::ListConstIterator S21List<T, Allocator>::end()
+    const {
   return ListConstIterator(nullptr);
 }
 
-template <typename T>
-void S21List<T>::erase(ListIterator pos) {
+template <typename T, typename Allocator>
+void S21List<T, Allocator>::erase(ListIterator pos) {
   if (pos == end() || !pos.node_) return;
 
   Node* nodeToDelete = pos.node_;
@@ -86,13 +160,13 @@ void S21List<T>::erase(ListIterator pos) {
     nodeToDelete->next->prev = nodeToDelete->prev;
   }
 
-  delete nodeToDelete;
+  destroyNode(nodeToDelete);
   size_--;
 };
 
-template <typename T>
-typename S21List<T>::ListIterator S21List<T>::insert(ListIterator pos,
-                                                     const T& value) {
+template <typename T, typename Allocator>
+typename S21List<T, Allocator>::ListIterator S21List<T, Allocator>::insert(
+    ListIterator pos, const T& value) {
   if (pos == end()) {
     // insert in back
     push_back(value);
@@ -105,7 +179,7 @@ typename S21List<T>::ListIterator S21List<T>::insert(ListIterator pos,
     // insert between head and tail
     Node* current = pos.node_;
 
-    Node* newNode = new Node(value, current->prev, current);
+    Node* newNode = createNode(value, current->prev, current);
     newNode->next = current;
     newNode->prev = current->prev;
     current->prev->next = newNode;
@@ -114,8 +188,8 @@ typename S21List<T>::ListIterator S21List<T>::insert(ListIterator pos,
   }
 }
 
-template <typename T>
-void S21List<T>::pop_front() {
+template <typename T, typename Allocator>
+void S21List<T, Allocator>::pop_front() {
   if (!head) return;
 
   Node* old = head;
@@ -129,11 +203,11 @@ void S21List<T>::pop_front() {
     head->prev = nullptr;
   }
   size_--;
-  delete old;
+  destroyNode(old);
 };
 
-template <typename T>
-void S21List<T>::pop_back() {
+template <typename T, typename Allocator>
+void S21List<T, Allocator>::pop_back() {
   if (!tail) return;
 
   Node* old = tail;
@@ -147,12 +221,12 @@ void S21List<T>::pop_back() {
     tail->next = nullptr;
   }
   size_--;
-  delete old;
+  destroyNode(old);
 };
 
-template <typename T>
-void S21List<T>::push_front(const T& value) {
-  Node* newNode = new Node(value, nullptr, head);
+template <typename T, typename Allocator>
+void S21List<T, Allocator>::push_front(const T& value) {
+  Node* newNode = createNode(value, nullptr, head);
 
   if (head == nullptr) {  // list is empty
     head = newNode;
@@ -164,9 +238,9 @@ void S21List<T>::push_front(const T& value) {
   size_++;
 };
 
-template <typename T>
-void S21List<T>::push_back(const T& value) {
-  Node* newNode = new Node(value, tail, nullptr);
+template <typename T, typename Allocator>
+void S21List<T, Allocator>::push_back(const T& value) {
+  Node* newNode = createNode(value, tail, nullptr);
   if (head == nullptr) {
     head = newNode;
     tail = newNode;
@@ -177,12 +251,17 @@ void S21List<T>::push_back(const T& value) {
   size_++;
 };
 
-template <typename T>
-void S21List<T>::swap(S21List& other) noexcept {
+template <typename T, typename Allocator>
+void S21List<T, Allocator>::swap(S21List& other) noexcept {
   if (this == &other) {
     return;
   }
 
+  if constexpr (node_traits::propagate_on_container_swap::value) {
+    std::swap(node_alloc_, other.node_alloc_);
+  }
+  pool_.swap(other.pool_);
+
   Node* temp_head = head;
   Node* temp_tail = tail;
   size_t temp_size = size_;
@@ -196,8 +275,8 @@ void S21List<T>::swap(S21List& other) noexcept {
   other.size_ = temp_size;
 };
 
-template <typename T>
-void S21List<T>::sort() {
+template <typename T, typename Allocator>
+void S21List<T, Allocator>::sort() {
   if (size_ <= 1) return;
 
   for (ListIterator it_a = begin(); it_a != end(); it_a++) {
@@ -215,8 +294,8 @@ void S21List<T>::sort() {
   }
 };
 
-template <typename T>
-void S21List<T>::unique() {
+template <typename T, typename Allocator>
+void S21List<T, Allocator>::unique() {
   if (size_ <= 1) return;
 
   auto it = begin();
@@ -236,8 +315,8 @@ void S21List<T>::unique() {
   }
 };
 
-template <typename T>
-void S21List<T>::reverse() noexcept {
+template <typename T, typename Allocator>
+void S21List<T, Allocator>::reverse() noexcept {
   if (size_ <= 1) return;
   Node* old_head = head;
   Node* old_tail = tail;
@@ -253,8 +332,8 @@ void S21List<T>::reverse() noexcept {
   tail = old_head;
 };
 
-template <typename T>
-void S21List<T>::splice(const ListIterator pos, S21List& other) {
+template <typename T, typename Allocator>
+void S21List<T, Allocator>::splice(const ListIterator pos, S21List& other) {
   if (other.empty() || &other == this) return;
 
   Node* insert_before = pos.node_;  // если pos == end
@@ -284,14 +363,17 @@ void S21List<T>::splice(const ListIterator pos, S21List& other) {
     size_ += other.size_;
   }
 
+  // узлы other переходят вместе со своими слабами
+  pool_.adopt(other.pool_);
+
   // очистка other
   other.head = nullptr;
   other.tail = nullptr;
   other.size_ = 0;
 }
 
-template <typename T>
-void S21List<T>::merge(S21List& other) {
+template <typename T, typename Allocator>
+void S21List<T, Allocator>::merge(S21List& other) {
   if (&other == this || other.empty()) return;
   if (empty()) {
     splice(begin(), other);
@@ -307,25 +389,25 @@ void S21List<T>::merge(S21List& other) {
       ++it;
     }
 
-    S21List tmp;
+    S21List tmp(get_allocator());
     tmp.splice(tmp.begin(), other);
 
     splice(it, tmp);
   }
 }
 
-template <typename T>
-bool S21List<T>::empty() {
+template <typename T, typename Allocator>
+bool S21List<T, Allocator>::empty() {
   return size_ == 0;
 };
 
-template <typename T>
-size_t S21List<T>::size() {
+template <typename T, typename Allocator>
+size_t S21List<T, Allocator>::size() {
   return size_;
 };
 
-template <typename T>
-size_t S21List<T>::max_size() const noexcept {
+template <typename T, typename Allocator>
+size_t S21List<T, Allocator>::max_size() const noexcept {
   const size_t node_size = sizeof(Node);
 
   const size_t max_size_t = std::numeric_limits<T>::max();
@@ -335,30 +417,34 @@ size_t S21List<T>::max_size() const noexcept {
   return max_size_t / node_size;
 };
 
-template <typename T>
-T& S21List<T>::front() noexcept {
+template <typename T, typename Allocator>
+T& S21List<T, Allocator>::front() noexcept {
   return head->data;
 };
 
-template <typename T>
-T& S21List<T>::back() noexcept {
+template <typename T, typename Allocator>
+T& S21List<T, Allocator>::back() noexcept {
   return tail->data;
 };
 
-template <typename T>
-const T& S21List<T>::front() const {
+template <typename T, typename Allocator>
+const T& S21List<T, Allocator>::front() const {
   return head->data;
 };
 
-template <typename T>
-const T& S21List<T>::back() const {
+template <typename T, typename Allocator>
+const T& S21List<T, Allocator>::back() const {
   return tail->data;
 };
 
-template <typename T>
-S21List<T>& S21List<T>::operator=(const S21List& other) {
+template <typename T, typename Allocator>
+S21List<T, Allocator>& S21List<T, Allocator>::operator=(
+    const S21List& other) {
   if (this != &other) {
     clear();
+    if constexpr (node_traits::propagate_on_container_copy_assignment::value) {
+      node_alloc_ = other.node_alloc_;
+    }
 
     Node* current = other.head;
     while (current) {
@@ -369,14 +455,27 @@ S21List<T>& S21List<T>::operator=(const S21List& other) {
   return *this;
 };
 
-template <typename T>
-S21List<T>& S21List<T>::operator=(S21List&& other) noexcept {
+template <typename T, typename Allocator>
+S21List<T, Allocator>& S21List<T, Allocator>::operator=(
+    S21List&& other) noexcept(nothrow_move_assign) {
   if (this != &other) {
     clear();
 
+    if constexpr (node_traits::propagate_on_container_move_assignment::value) {
+      node_alloc_ = std::move(other.node_alloc_);
+    } else if (node_alloc_ != other.node_alloc_) {
+      // nodes of other belong to another allocator and cannot be adopted
+      for (Node* current = other.head; current; current = current->next) {
+        push_back(current->data);
+      }
+      other.clear();
+      return *this;
+    }
+
     head = other.head;
     tail = other.tail;
     size_ = other.size_;
+    pool_.swap(other.pool_);
 
     other.head = nullptr;
     other.tail = nullptr;
@@ -385,15 +484,15 @@ S21List<T>& S21List<T>::operator=(S21List&& other) noexcept {
   return *this;
 };
 
-template <typename T>
+template <typename T, typename Allocator>
 template <class... Args>
-typename S21List<T>::ListIterator S21List<T>::insert_many(ListIterator pos,
-                                                          Args&&... args) {
+typename S21List<T, Allocator>::ListIterator
+S21List<T, Allocator>::insert_many(ListIterator pos, Args&&... args) {
   if constexpr (sizeof...(Args) == 0) {
     return pos;
   }
 
-  S21List<T> tmp;
+  S21List tmp(get_allocator());
   for (auto& arg : {args...}) {
     tmp.push_front(arg);
   }
@@ -409,17 +508,17 @@ typename S21List<T>::ListIterator S21List<T>::insert_many(ListIterator pos,
   return result;
 }
 
-template <typename T>
+template <typename T, typename Allocator>
 template <class... Args>
-void S21List<T>::insert_many_back(Args&&... args) {
+void S21List<T, Allocator>::insert_many_back(Args&&... args) {
   for (auto& arg : {args...}) {
     push_back(arg);
   }
 }
 
-template <typename T>
+template <typename T, typename Allocator>
 template <class... Args>
-void S21List<T>::insert_many_front(Args&&... args) {
+void S21List<T, Allocator>::insert_many_front(Args&&... args) {
   for (auto& arg : {args...}) {
     push_front(arg);
   }
@@ -428,7 +527,7 @@ void S21List<T>::insert_many_front(Args&&... args) {
 // FOR DEBUG
 
 // template <typename T>
-// void S21List<T>::printForward() {
+// void S21List<T, Allocator>::printForward() {
 //   Node* currentNode = head;
 //   while (currentNode) {
 //     std::cout << currentNode->data << " ";
@@ -438,7 +537,7 @@ void S21List<T>::insert_many_front(Args&&... args) {
 // }
 
 // template <typename T>
-// void S21List<T>::printBackward() {
+// void S21List<T, Allocator>::printBackward() {
 //   Node* currentNode = tail;
 //   while (currentNode) {
 //     std::cout << currentNode->data << " ";
@@ -1,16 +1,41 @@
 #ifndef S21_MAP_H
 #define S21_MAP_H
 
+#include <bit>
+#include <cstddef>
+#include <functional>
 #include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "../s21_node_pool/s21_node_pool.h"
 
 namespace s21 {
 
 using std::pair;
 
-template <typename Key, typename T>
+// Tag for constructors whose input is already sorted by the comparator and
+// holds no equivalent keys, as std::sorted_unique of C++23.
+struct sorted_unique_t {
+  explicit sorted_unique_t() = default;
+};
+inline constexpr sorted_unique_t sorted_unique{};
+
+// Ranked = true keeps the size of every subtree in its root node and
+// enables rank(), select(), index_of() and distance() in O(log n); the
+// default map has neither the field nor the bookkeeping.
+template <typename Key, typename T,
+          typename Allocator = std::allocator<std::pair<const Key, T>>,
+          typename Compare = std::less<Key>, bool Ranked = false>
 class S21Map {
  private:
+  struct NoSubtreeSize {};
+
   struct MapNode {
     Key key;
     T value;
@@ -18,25 +43,46 @@ class S21Map {
     MapNode* right;
     MapNode* parent;
     bool is_red;
-
-    MapNode(const pair<Key, T>& item, MapNode* p = nullptr)
-        : key(item.first),
-          value(item.second),
+    // число узлов поддерева вместе с этим, только при Ranked
+    [[no_unique_address]] std::conditional_t<Ranked, size_t, NoSubtreeSize>
+        subtree_size;
+
+    // value is built from args in place, value-initialized when args is
+    // empty
+    template <typename K, typename... Args>
+    MapNode(MapNode* p, K&& k, Args&&... args)
+        : key(std::forward<K>(k)),
+          value(std::forward<Args>(args)...),
           left(nullptr),
           right(nullptr),
           parent(p),
-          is_red(true){};
+          is_red(true),
+          subtree_size() {
+      if constexpr (Ranked) subtree_size = 1;
+    }
   };
 
+  using node_allocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<MapNode>;
+  using node_traits = std::allocator_traits<node_allocator>;
+
+  static constexpr bool nothrow_move_assign =
+      node_traits::propagate_on_container_move_assignment::value ||
+      node_traits::is_always_equal::value;
+
   MapNode* root_;
   size_t size_;
+  [[no_unique_address]] node_allocator node_alloc_;
+  [[no_unique_address]] Compare comp_;
+  // slabs the nodes are carved from, released by clear()
+  node_pool<MapNode, node_allocator> pool_;
 
   class MapIterator {
    private:
     MapNode* iter_;
 
    public:
-    friend class S21Map<Key, T>;
+    friend class S21Map<Key, T, Allocator, Compare, Ranked>;
 
     MapIterator(MapNode* ptr = nullptr) : iter_(ptr) {}
 
@@ -110,7 +156,7 @@ class S21Map {
     const MapNode* iter_;
 
    public:
-    friend class S21Map<Key, T>;
+    friend class S21Map<Key, T, Allocator, Compare, Ranked>;
 
     MapConstIterator(const MapNode* ptr = nullptr) : iter_(ptr) {}
 
@@ -175,6 +221,41 @@ class S21Map {
     }
   };
 
+  using node_handle_base = node_handle<MapNode, node_allocator, Allocator>;
+
+ public:
+  /**
+   * @brief owning handle of a node taken out by extract(); key() may be
+   * changed before the node is inserted again
+   */
+  class node_type : public node_handle_base {
+   public:
+    using key_type = Key;
+    using mapped_type = T;
+
+    constexpr node_type() noexcept = default;
+
+    key_type& key() const { return this->node_->key; }
+    mapped_type& mapped() const { return this->node_->value; }
+
+   private:
+    friend class S21Map<Key, T, Allocator, Compare, Ranked>;
+
+    node_type(MapNode* node, const node_allocator& alloc)
+        : node_handle_base(node, alloc) {}
+  };
+
+  /**
+   * @brief result of insert(node_type&&): where the key is, whether the
+   * node was linked and the node itself when it was not
+   */
+  struct insert_return_type {
+    MapIterator position;
+    bool inserted;
+    node_type node;
+  };
+
+ private:
   /**
    * @brief левосторонее вращение
    * правый ребенок - красный
@@ -192,6 +273,17 @@ class S21Map {
    */
   void flipColors(MapNode* node);
 
+  /**
+   * @brief size of the subtree rooted at node, 0 for nullptr (Ranked only)
+   */
+  static size_t subtreeSize(const MapNode* node);
+
+  /**
+   * @brief recomputes the subtree size of node from its children; does
+   * nothing unless Ranked
+   */
+  static void updateSubtreeSize(MapNode* node);
+
   /**
    * @brief balance leftRBT
    * если правая нода красная и левая нода черная - левосторонний поворот
@@ -209,37 +301,162 @@ class S21Map {
 
   MapNode* moveRedRight(MapNode* node);
 
-  MapNode* eraseMin(MapNode* node);
+  /**
+   * @brief unhooks the smallest node of the subtree into removed and
+   * returns the rebalanced subtree
+   */
+  MapNode* eraseMin(MapNode* node, MapNode*& removed);
 
-  MapNode* eraseRecursive(MapNode* node, const Key& key);
+  /**
+   * @brief unhooks the node with key into removed and returns the
+   * rebalanced subtree; nodes are relinked, never their contents moved
+   */
+  MapNode* eraseRecursive(MapNode* node, const Key& key, MapNode*& removed);
 
+  /**
+   * @brief takes node out of the tree without destroying it
+   */
+  MapNode* unlinkNode(const MapNode* node);
+
+  /**
+   * @brief destroys the nodes of the subtree; their storage goes back with
+   * the pool
+   */
   void clearRecursive(MapNode* node);
 
-  MapNode* insert_recursive(MapNode* node, MapNode* parent,
-                            const pair<Key, T>& value, bool& inserted);
+  /**
+   * @brief moves the subtree into nodes of fresh taken in key order and
+   * returns its new root; every node of fresh has been reserved
+   */
+  MapNode* compactRecursive(MapNode* node, MapNode* parent,
+                            node_pool<MapNode, node_allocator>& fresh);
+
+  /**
+   * @brief one root-to-leaf descent that returns the node with key as is or,
+   * where the descent ends, links a node created from key and args; T is
+   * only constructed for a new node. Returns the node and whether it was
+   * created
+   */
+  template <typename K, typename... Args>
+  pair<MapNode*, bool> emplaceUnique(K&& key, Args&&... args);
+
+  /**
+   * @brief descends to key: returns its node, or nullptr with parent and
+   * toLeft naming the empty slot where a node with key belongs
+   */
+  template <typename K>
+  MapNode* findSlot(const K& key, MapNode*& parent, bool& toLeft) const;
+
+  /**
+   * @brief hangs the detached node into the slot found by findSlot and
+   * rebalances up to the root
+   */
+  void linkNode(MapNode* node, MapNode* parent, bool toLeft);
+
+  /**
+   * @brief black height of the tree buildBalanced makes from n nodes: the
+   * largest h with 2^h - 1 <= n, for which n <= 3^h - 1 holds as well
+   */
+  static int blackHeightFor(size_t n);
+
+  /**
+   * @brief builds a perfectly balanced, valid LLRB subtree of n nodes with
+   * black height blackHeight. Nodes come in key order from next(), which
+   * may create them or hand out existing ones; subtrees split evenly under
+   * a black node (2-node) or, when that cannot hold n, into three under a
+   * black node and its red left child (3-node)
+   */
+  template <typename NextNode>
+  MapNode* buildBalanced(size_t n, int blackHeight, NextNode& next);
+
+  /**
+   * @brief unhooks the subtree and appends its nodes in key order to the
+   * chain [head, tail], linked through their right pointers
+   */
+  static void chainInOrder(MapNode* node, MapNode*& head, MapNode*& tail);
+
+  /**
+   * @brief merge that moves the nodes of other instead of copying them;
+   * other has to share the allocator
+   */
+  void mergeRelinking(S21Map& other);
+
+  /**
+   * @brief rebalances every node from node up to the root after an insert
+   * below it, relinking rotated subtrees into their parents
+   */
+  void balanceUp(MapNode* node);
 
   MapNode* copyTreeRecursive(MapNode* node, MapNode* parent);
 
+  /**
+   * @brief takes a node from the pool and constructs it through the map
+   * allocator
+   */
+  template <typename K, typename... Args>
+  MapNode* createNode(MapNode* parent, K&& key, Args&&... args);
+
+  /**
+   * @brief destroys a node created by createNode and returns it to the pool
+   */
+  void destroyNode(MapNode* node);
+
+  /**
+   * @brief descends by comp_ alone and returns the node with a key
+   * equivalent to key (neither orders before the other), or nullptr
+   */
+  template <typename K>
+  MapNode* findNode(const K& key) const;
+
  public:
   using key_type = Key;
   using value_type = T;
+  using allocator_type = Allocator;
+  using key_compare = Compare;
   using reference = value_type&;
   using const_reference = const value_type&;
   using iterator = MapIterator;
   using const_iterator = MapConstIterator;
   using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+
+  /**
+   * @brief true when Compare declares is_transparent; find, contains and
+   * count then also take any key type the comparator accepts
+   */
+  static constexpr bool is_transparent =
+      requires { typename Compare::is_transparent; };
 
   /**
    * @brief default constructor, creates empty map
    */
   S21Map();
 
+  /**
+   * @brief creates empty map that allocates nodes with alloc
+   */
+  explicit S21Map(const Allocator& alloc);
+
+  /**
+   * @brief creates empty map ordered by comp
+   */
+  explicit S21Map(const Compare& comp, const Allocator& alloc = Allocator());
+
   /**
    * @brief initializer list constructor, creates the map initizialized using
    * std::initializer_list
    */
   S21Map(std::initializer_list<std::pair<const Key, T>> const& items);
 
+  /**
+   * @brief builds the map in O(n) from [first, last), which must be sorted
+   * by comp and free of equivalent keys; the tree comes out perfectly
+   * balanced with its nodes laid out in key order
+   */
+  template <std::forward_iterator It>
+  S21Map(sorted_unique_t, It first, It last, const Compare& comp = Compare(),
+         const Allocator& alloc = Allocator());
+
   /**
    * @brief copy constructor
    */
@@ -256,14 +473,29 @@ class S21Map {
   ~S21Map() noexcept;
 
   /**
-   * @brief clears the contents
+   * @brief returns the allocator associated with the container
+   */
+  allocator_type get_allocator() const;
+
+  /**
+   * @brief clears the contents and returns the node slabs to the allocator
    */
   void clear();
 
+  /**
+   * @brief moves every element into one new slab in key order, so that an
+   * in-order walk reads memory front to back; old slabs are released.
+   * Invalidates iterators and references, the allocator briefly holds
+   * both copies
+   */
+  void compact()
+    requires std::is_nothrow_move_constructible_v<Key> &&
+             std::is_nothrow_move_constructible_v<T>;
+
   /**
    * @brief assignment operator overload for moving object
    */
-  S21Map& operator=(S21Map&& m) noexcept;
+  S21Map& operator=(S21Map&& m) noexcept(nothrow_move_assign);
 
   /**
    * @brief returns an iterator to the beginnin
@@ -291,6 +523,11 @@ class S21Map {
    */
   pair<MapIterator, bool> insert(const pair<const Key, T>& value);
 
+  /**
+   * @brief inserts value, moving its mapped value into the new node
+   */
+  pair<MapIterator, bool> insert(pair<const Key, T>&& value);
+
   /**
    * @brief inserts value by key and returns iterator to where the element is in
    * the container and bool denoting whether the insertion took place
@@ -303,11 +540,41 @@ class S21Map {
    */
   pair<MapIterator, bool> insert_or_assign(const Key& key, const T& obj);
 
+  /**
+   * @brief inserts a value constructed from args when key is absent; when
+   * it is present nothing is constructed and args are left untouched
+   */
+  template <typename... Args>
+  pair<MapIterator, bool> try_emplace(const Key& key, Args&&... args);
+
+  /**
+   * @brief try_emplace that moves key into the new node
+   */
+  template <typename... Args>
+  pair<MapIterator, bool> try_emplace(Key&& key, Args&&... args);
+
+  /**
+   * @brief inserts a pair<const Key, T> built from args; like std::map the
+   * pair is built before the lookup, prefer try_emplace to skip building T
+   * for a key that is present
+   */
+  template <typename... Args>
+  pair<MapIterator, bool> emplace(Args&&... args);
+
   /**
    * @brief finds an element by key
    */
   MapIterator find(const Key& key);
 
+  /**
+   * @brief heterogeneous find for transparent comparators
+   */
+  template <typename K>
+    requires is_transparent
+  MapIterator find(const K& key) {
+    return MapIterator(findNode(key));
+  }
+
   /**
    * @brief erases element at pos
    * 1. спуск к ноде и балансировка
@@ -328,10 +595,10 @@ class S21Map {
    * Лист или Узел с одним ребенком (лист - удаяем, один ребенок - заменяем)
    * Узел с двумя детьми:
    * находим минимальный узел в правом поддереве (преемник)
-   * скопировать ключ и значение преемника в текущий узел
-   * удалить преемника (delMinimum)
+   * вынуть преемника (delMinimum) и поставить его на место текущего узла,
+   * итераторы на другие элементы остаются действительными
    * 2. Удаление минимума (delMinimum)
-   * если левого ребенка нет - удалитьтекущий узел
+   * если левого ребенка нет - вынуть текущий узел
    * если текущий узел и его левый ребенок черные && левый ребенок левого
    ребенка черные - MoveRedLeft
    * рекурсивный спуск влево, обратно - балансировка
@@ -349,13 +616,39 @@ class S21Map {
    */
   void erase(MapIterator pos);
 
+  /**
+   * @brief unlinks the element at pos and moves it into a node owned by the
+   * handle, which does not depend on this map; an empty handle for end().
+   * The element is copied instead when its move may throw
+   */
+  node_type extract(const_iterator pos);
+
+  /**
+   * @brief extract() of the element with key, an empty handle without it
+   */
+  node_type extract(const Key& key);
+
+  /**
+   * @brief links the node of nh unless its key is present, without
+   * allocating; nh has to come from a map with an equal allocator. A node
+   * that was not linked is handed back in the result
+   */
+  insert_return_type insert(node_type&& nh);
+
   /**
    * @brief swaps the contents
    */
   void swap(S21Map& other) noexcept;
 
   /**
-   * @brief splices nodes from another container
+   * @brief splices nodes from another container: the nodes whose keys are
+   * missing here are relinked into this map, the rest stay in other. With
+   * equal allocators and noexcept moves nothing is copied: the tree is
+   * rebuilt in O(n + m), or the m nodes are linked one by one when other is
+   * much smaller; the slabs of other stay here until clear(), compact() or
+   * destruction, and keys left in other move to nodes of its own new pool,
+   * so the two maps do not share storage afterwards. Otherwise the missing
+   * elements are copied over
    */
   void merge(S21Map& other);
 
@@ -365,6 +658,34 @@ class S21Map {
    */
   bool contains(const Key& key);
 
+  /**
+   * @brief heterogeneous contains for transparent comparators
+   */
+  template <typename K>
+    requires is_transparent
+  bool contains(const K& key) {
+    return findNode(key) != nullptr;
+  }
+
+  /**
+   * @brief returns the number of elements with key equivalent to key, 0 or 1
+   */
+  size_type count(const Key& key);
+
+  /**
+   * @brief heterogeneous count for transparent comparators
+   */
+  template <typename K>
+    requires is_transparent
+  size_type count(const K& key) {
+    return findNode(key) != nullptr;
+  }
+
+  /**
+   * @brief returns the function that orders the keys
+   */
+  key_compare key_comp() const;
+
   /**
    * @brief checks whether the container is empty
    */
@@ -390,6 +711,38 @@ class S21Map {
    */
   T& operator[](const Key& key);
 
+  /**
+   * @brief access or insert specified element, moving key into a new node
+   */
+  T& operator[](Key&& key);
+
+  /**
+   * @brief number of keys ordered before key, whether key is present or not
+   */
+  size_type rank(const Key& key) const
+    requires Ranked;
+
+  /**
+   * @brief iterator to the element with k keys before it, end() when k is
+   * not less than size()
+   */
+  iterator select(size_type k)
+    requires Ranked;
+  const_iterator select(size_type k) const
+    requires Ranked;
+
+  /**
+   * @brief number of elements before pos, size() for end()
+   */
+  size_type index_of(const_iterator pos) const
+    requires Ranked;
+
+  /**
+   * @brief number of increments from first to last, without walking them
+   */
+  difference_type distance(const_iterator first, const_iterator last) const
+    requires Ranked;
+
   // FOR DEBUG
 
   // void printTree() const;
@@ -401,6 +754,18 @@ class S21Map {
 
 };  // class S21Map
 
+namespace pmr {
+
+template <typename Key, typename T, typename Compare = std::less<Key>>
+using S21Map = s21::S21Map<
+    Key, T, std::pmr::polymorphic_allocator<std::pair<const Key, T>>, Compare>;
+
+}  // namespace pmr
+
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, T>>>
+using S21RankedMap = S21Map<Key, T, Allocator, Compare, true>;
+
 }  // namespace s21
 
 #include "s21_map.tpp"
@@ -6,8 +6,10 @@
 
 namespace s21 {
 
-template <typename Key, typename T>
-S21Map<Key, T>::MapNode* S21Map<Key, T>::moveRedLeft(MapNode* node) {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+S21Map<Key, T, Allocator, Compare, Ranked>::MapNode*
+S21Map<Key, T, Allocator, Compare, Ranked>::moveRedLeft(MapNode* node) {
   flipColors(node);
   if (node->right && isRed(node->right->left)) {
     node->right = rightRotate(node->right);
@@ -17,8 +19,10 @@ S21Map<Key, T>::MapNode* S21Map<Key, T>::moveRedLeft(MapNode* node) {
   return node;
 }
 
-template <typename Key, typename T>
-S21Map<Key, T>::MapNode* S21Map<Key, T>::moveRedRight(MapNode* node) {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+S21Map<Key, T, Allocator, Compare, Ranked>::MapNode*
+S21Map<Key, T, Allocator, Compare, Ranked>::moveRedRight(MapNode* node) {
   flipColors(node);
   if (node->left && isRed(node->left->left)) {
     node = rightRotate(node);
@@ -27,10 +31,13 @@ S21Map<Key, T>::MapNode* S21Map<Key, T>::moveRedRight(MapNode* node) {
   return node;
 }
 
-template <typename Key, typename T>
-S21Map<Key, T>::MapNode* S21Map<Key, T>::eraseMin(MapNode* node) {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+S21Map<Key, T, Allocator, Compare, Ranked>::MapNode*
+S21Map<Key, T, Allocator, Compare, Ranked>::eraseMin(MapNode* node,
+                                                     MapNode*& removed) {
   if (!node->left) {
-    delete node;
+    removed = node;
     return nullptr;
   }
 
@@ -39,21 +46,23 @@ S21Map<Key, T>::MapNode* S21Map<Key, T>::eraseMin(MapNode* node) {
     node = moveRedLeft(node);
   }
 
-  node->left = eraseMin(node->left);
+  node->left = eraseMin(node->left, removed);
   return balanceTree(node);
 }
 
-template <typename Key, typename T>
-S21Map<Key, T>::MapNode* S21Map<Key, T>::eraseRecursive(MapNode* node,
-                                                        const Key& key) {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+S21Map<Key, T, Allocator, Compare, Ranked>::MapNode*
+S21Map<Key, T, Allocator, Compare, Ranked>::eraseRecursive(
+    MapNode* node, const Key& key, MapNode*& removed) {
   if (!node) return nullptr;
 
   // 1. Спуск влево
-  if (key < node->key) {
+  if (comp_(key, node->key)) {
     if (!isRed(node->left) && !isRed(node->left->left)) {
       node = moveRedLeft(node);
     }
-    node->left = eraseRecursive(node->left, key);
+    node->left = eraseRecursive(node->left, key, removed);
   }
 
   // 2. Спуск вправо (или найден узел)
@@ -62,8 +71,9 @@ S21Map<Key, T>::MapNode* S21Map<Key, T>::eraseRecursive(MapNode* node,
       node = rightRotate(node);
     }
 
-    if (key == node->key && !node->right) {
-      delete node;
+    // здесь key не меньше node->key: равенство - это !(node->key < key)
+    if (!comp_(node->key, key) && !node->right) {
+      removed = node;
       return nullptr;
     }
 
@@ -71,68 +81,220 @@ S21Map<Key, T>::MapNode* S21Map<Key, T>::eraseRecursive(MapNode* node,
       node = moveRedRight(node);
     }
 
-    if (key == node->key) {
+    if (!comp_(node->key, key)) {
       if (node->right != nullptr) {
-        MapNode* minNode = node->right;
-        while (minNode->left) minNode = minNode->left;
-        node->key = minNode->key;
-        node->value = minNode->value;
-        node->right = eraseMin(node->right);
+        // преемник встает на место узла целиком, данные не копируются
+        MapNode* minNode = nullptr;
+        MapNode* right = eraseMin(node->right, minNode);
+        minNode->left = node->left;
+        minNode->right = right;
+        minNode->parent = node->parent;
+        minNode->is_red = node->is_red;
+        if (minNode->left) minNode->left->parent = minNode;
+        if (minNode->right) minNode->right->parent = minNode;
+        removed = node;
+        node = minNode;
       }
     } else {
-      node->right = eraseRecursive(node->right, key);
+      node->right = eraseRecursive(node->right, key, removed);
     }
   }
 
   return balanceTree(node);
 }
 
-template <typename Key, typename T>
-void S21Map<Key, T>::clearRecursive(MapNode* node) {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+void S21Map<Key, T, Allocator, Compare, Ranked>::clearRecursive(MapNode* node) {
   if (!node) return;
 
   clearRecursive(node->left);
   clearRecursive(node->right);
 
-  delete node;
+  node_traits::destroy(node_alloc_, node);
 }
 
-template <typename Key, typename T>
-S21Map<Key, T>::MapNode* S21Map<Key, T>::insert_recursive(
-    MapNode* node, MapNode* parent, const pair<Key, T>& value, bool& inserted) {
-  // базовый случай: node == nullptr
-  if (!node) {
-    inserted = true;
-    return new MapNode(value, parent);
-    // std::cout << "элемент " << value.first << " вставлен" << std::endl;
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+S21Map<Key, T, Allocator, Compare, Ranked>::MapNode*
+S21Map<Key, T, Allocator, Compare, Ranked>::compactRecursive(
+    MapNode* node, MapNode* parent, node_pool<MapNode, node_allocator>& fresh) {
+  if (!node) return nullptr;
+
+  // левое поддерево раньше узла, чтобы узлы шли в памяти по порядку ключей
+  MapNode* left = compactRecursive(node->left, nullptr, fresh);
+  MapNode* moved = fresh.allocate(node_alloc_);
+  node_traits::construct(node_alloc_, moved, parent, std::move(node->key),
+                         std::move(node->value));
+  moved->is_red = node->is_red;
+  moved->subtree_size = node->subtree_size;
+  moved->left = left;
+  if (left) left->parent = moved;
+  moved->right = compactRecursive(node->right, moved, fresh);
+
+  node_traits::destroy(node_alloc_, node);
+  return moved;
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+template <typename K, typename... Args>
+pair<typename S21Map<Key, T, Allocator, Compare, Ranked>::MapNode*, bool>
+S21Map<Key, T, Allocator, Compare, Ranked>::emplaceUnique(K&& key,
+                                                          Args&&... args) {
+  MapNode* parent = nullptr;
+  bool toLeft = false;
+  // найденный ключ возвращается сразу, дерево при этом не меняется
+  if (MapNode* found = findSlot(key, parent, toLeft)) return {found, false};
+
+  MapNode* created =
+      createNode(parent, std::forward<K>(key), std::forward<Args>(args)...);
+  linkNode(created, parent, toLeft);
+  return {created, true};
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+template <typename K>
+S21Map<Key, T, Allocator, Compare, Ranked>::MapNode*
+S21Map<Key, T, Allocator, Compare, Ranked>::findSlot(
+    const K& key, MapNode*& parent, bool& toLeft) const {
+  MapNode* node = root_;
+  while (node) {
+    parent = node;
+    if (comp_(key, node->key)) {
+      toLeft = true;
+      node = node->left;
+    } else if (comp_(node->key, key)) {
+      toLeft = false;
+      node = node->right;
+    } else {
+      return node;
+    }
   }
+  return nullptr;
+}
 
-  if (value.first < node->key) {
-    node->left = insert_recursive(node->left, node, value, inserted);
-    if (node->left) node->left->parent = node;
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+void S21Map<Key, T, Allocator, Compare, Ranked>::linkNode(MapNode* node,
+                                                     MapNode* parent,
+                                                     bool toLeft) {
+  node->parent = parent;
+  if (!parent) {
+    root_ = node;
+  } else if (toLeft) {
+    parent->left = node;
+  } else {
+    parent->right = node;
   }
+  ++size_;
+  balanceUp(parent);
+  root_->is_red = false;
+}
 
-  else if (value.first > node->key) {
-    node->right = insert_recursive(node->right, node, value, inserted);
-    if (node->right) node->right->parent = node;
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+int S21Map<Key, T, Allocator, Compare, Ranked>::blackHeightFor(size_t n) {
+  return static_cast<int>(std::bit_width(n + 1)) - 1;
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+template <typename NextNode>
+S21Map<Key, T, Allocator, Compare, Ranked>::MapNode*
+S21Map<Key, T, Allocator, Compare, Ranked>::buildBalanced(
+    size_t n, int blackHeight, NextNode& next) {
+  if (n == 0) return nullptr;
+
+  // поддерево черной высоты h вмещает от 2^h - 1 до 3^h - 1 узлов
+  size_t childMax = 0;
+  for (int h = 0; h < blackHeight - 1 && childMax < n; ++h) {
+    childMax = childMax * 3 + 2;
   }
 
-  else {
-    inserted = false;
-    return balanceTree(node);
+  auto attach = [](MapNode* node, MapNode* left, MapNode* right, bool red) {
+    node->left = left;
+    node->right = right;
+    if (left) left->parent = node;
+    if (right) right->parent = node;
+    node->is_red = red;
+    updateSubtreeSize(node);
+  };
+
+  size_t rest = n - 1;
+  if (rest - rest / 2 <= childMax) {
+    // 2-узел: черный корень и два поддерева поровну
+    MapNode* left = buildBalanced(rest / 2, blackHeight - 1, next);
+    MapNode* node = next();
+    MapNode* right = buildBalanced(rest - rest / 2, blackHeight - 1, next);
+    attach(node, left, right, false);
+    return node;
   }
 
-  return balanceTree(node);
+  // 3-узел: черный корень с красным левым ребенком и три поддерева
+  rest = n - 2;
+  size_t first = rest / 3;
+  size_t second = (rest - first) / 2;
+  MapNode* leftLeft = buildBalanced(first, blackHeight - 1, next);
+  MapNode* red = next();
+  MapNode* middle = buildBalanced(second, blackHeight - 1, next);
+  attach(red, leftLeft, middle, true);
+  MapNode* node = next();
+  MapNode* right =
+      buildBalanced(rest - first - second, blackHeight - 1, next);
+  attach(node, red, right, false);
+  return node;
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+void S21Map<Key, T, Allocator, Compare, Ranked>::chainInOrder(MapNode* node,
+                                                         MapNode*& head,
+                                                         MapNode*& tail) {
+  if (!node) return;
+  chainInOrder(node->left, head, tail);
+  MapNode* right = node->right;
+  node->left = node->right = nullptr;
+  if (tail) {
+    tail->right = node;
+  } else {
+    head = node;
+  }
+  tail = node;
+  chainInOrder(right, head, tail);
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+void S21Map<Key, T, Allocator, Compare, Ranked>::balanceUp(MapNode* node) {
+  // повороты перевешивают узлы, но не переносят их данные, так что
+  // созданный узел остается на месте
+  while (node) {
+    MapNode* parent = node->parent;
+    bool isLeft = parent && parent->left == node;
+    MapNode* top = balanceTree(node);
+    if (!parent) {
+      root_ = top;
+    } else if (isLeft) {
+      parent->left = top;
+    } else {
+      parent->right = top;
+    }
+    node = parent;
+  }
 }
 
-template <typename Key, typename T>
-S21Map<Key, T>::MapNode* S21Map<Key, T>::copyTreeRecursive(MapNode* node,
-                                                           MapNode* parent) {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+S21Map<Key, T, Allocator, Compare, Ranked>::MapNode*
+S21Map<Key, T, Allocator, Compare, Ranked>::copyTreeRecursive(MapNode* node,
+                                                              MapNode* parent) {
   if (!node) return nullptr;
 
-  MapNode* newNode =
-      new MapNode(std::pair<Key, T>(node->key, node->value), parent);
+  MapNode* newNode = createNode(parent, node->key, node->value);
   newNode->is_red = node->is_red;
+  newNode->subtree_size = node->subtree_size;
 
   newNode->left = copyTreeRecursive(node->left, newNode);
   newNode->right = copyTreeRecursive(node->right, newNode);
@@ -140,13 +302,44 @@ S21Map<Key, T>::MapNode* S21Map<Key, T>::copyTreeRecursive(MapNode* node,
   return newNode;
 }
 
-template <typename Key, typename T>
-bool S21Map<Key, T>::isRed(MapNode* node) const {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+template <typename K, typename... Args>
+S21Map<Key, T, Allocator, Compare, Ranked>::MapNode*
+S21Map<Key, T, Allocator, Compare, Ranked>::createNode(MapNode* parent,
+                                                           K&& key,
+                                                           Args&&... args) {
+  MapNode* node = pool_.allocate(node_alloc_);
+  try {
+    node_traits::construct(node_alloc_, node, parent, std::forward<K>(key),
+                           std::forward<Args>(args)...);
+  } catch (...) {
+    pool_.deallocate(node);
+    throw;
+  }
+  return node;
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+void S21Map<Key, T, Allocator, Compare, Ranked>::destroyNode(MapNode* node) {
+  node_traits::destroy(node_alloc_, node);
+  pool_.deallocate(node);
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+bool S21Map<Key, T, Allocator, Compare, Ranked>::isRed(MapNode* node) const {
   return node && node->is_red;
 }
 
-template <typename Key, typename T>
-S21Map<Key, T>::MapNode* S21Map<Key, T>::balanceTree(MapNode* node) {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+S21Map<Key, T, Allocator, Compare, Ranked>::MapNode*
+S21Map<Key, T, Allocator, Compare, Ranked>::balanceTree(MapNode* node) {
+  // все пути вставки и удаления поднимаются через balanceTree, так что
+  // размер поддерева здесь пересчитывается по уже верным детям
+  updateSubtreeSize(node);
   //  правая нода красная и левая нода черная - левосторонний поворот
   if (node->right && node->right->is_red &&
       (!node->left || !node->left->is_red)) {
@@ -167,8 +360,29 @@ S21Map<Key, T>::MapNode* S21Map<Key, T>::balanceTree(MapNode* node) {
   return node;
 }
 
-template <typename Key, typename T>
-void S21Map<Key, T>::flipColors(MapNode* node) {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+size_t S21Map<Key, T, Allocator, Compare, Ranked>::subtreeSize(
+    const MapNode* node) {
+  if constexpr (Ranked) {
+    return node ? node->subtree_size : 0;
+  } else {
+    return 0;
+  }
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+void S21Map<Key, T, Allocator, Compare, Ranked>::updateSubtreeSize(
+    MapNode* node) {
+  if constexpr (Ranked) {
+    node->subtree_size = 1 + subtreeSize(node->left) + subtreeSize(node->right);
+  }
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+void S21Map<Key, T, Allocator, Compare, Ranked>::flipColors(MapNode* node) {
   if (!node || !node->left || !node->right) return;
 
   node->is_red = !node->is_red;
@@ -176,8 +390,10 @@ void S21Map<Key, T>::flipColors(MapNode* node) {
   node->right->is_red = !node->right->is_red;
 }
 
-template <typename Key, typename T>
-S21Map<Key, T>::MapNode* S21Map<Key, T>::rightRotate(MapNode* current) {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+S21Map<Key, T, Allocator, Compare, Ranked>::MapNode*
+S21Map<Key, T, Allocator, Compare, Ranked>::rightRotate(MapNode* current) {
   MapNode* leftChild = current->left;
 
   current->left = leftChild->right;
@@ -190,11 +406,18 @@ S21Map<Key, T>::MapNode* S21Map<Key, T>::rightRotate(MapNode* current) {
   leftChild->is_red = current->is_red;
   current->is_red = true;
 
+  if constexpr (Ranked) {
+    leftChild->subtree_size = current->subtree_size;
+    updateSubtreeSize(current);
+  }
+
   return leftChild;
 }
 
-template <typename Key, typename T>
-S21Map<Key, T>::MapNode* S21Map<Key, T>::leftRotate(MapNode* current) {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+S21Map<Key, T, Allocator, Compare, Ranked>::MapNode*
+S21Map<Key, T, Allocator, Compare, Ranked>::leftRotate(MapNode* current) {
   MapNode* rightChild = current->right;
   if (!rightChild) return current;
 
@@ -208,51 +431,163 @@ S21Map<Key, T>::MapNode* S21Map<Key, T>::leftRotate(MapNode* current) {
   rightChild->is_red = current->is_red;
   current->is_red = true;
 
+  if constexpr (Ranked) {
+    rightChild->subtree_size = current->subtree_size;
+    updateSubtreeSize(current);
+  }
+
   return rightChild;
 }
 
-template <typename Key, typename T>
-S21Map<Key, T>::S21Map() : root_(nullptr), size_(0) {}
-
-template <typename Key, typename T>
-S21Map<Key, T>::S21Map(
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+S21Map<Key, T, Allocator, Compare, Ranked>::S21Map()
+    : root_(nullptr), size_(0) {}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+S21Map<Key, T, Allocator, Compare, Ranked>::S21Map(const Allocator& alloc)
+    : root_(nullptr), size_(0), node_alloc_(alloc) {}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+S21Map<Key, T, Allocator, Compare, Ranked>::S21Map(const Compare& comp,
+                                                   const Allocator& alloc)
+    : root_(nullptr), size_(0), node_alloc_(alloc), comp_(comp) {}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+S21Map<Key, T, Allocator, Compare, Ranked>::S21Map(
     std::initializer_list<std::pair<const Key, T>> const& items)
     : root_(nullptr), size_(0) {
   for (auto i = items.begin(); i != items.end(); ++i) insert(*i);
 }
 
-template <typename Key, typename T>
-S21Map<Key, T>::S21Map(const S21Map& other) : root_(nullptr), size_(0) {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+template <std::forward_iterator It>
+S21Map<Key, T, Allocator, Compare, Ranked>::S21Map(sorted_unique_t, It first,
+                                                   It last,
+                                                   const Compare& comp,
+                                                   const Allocator& alloc)
+    : root_(nullptr), size_(0), node_alloc_(alloc), comp_(comp) {
+  size_t n = static_cast<size_t>(std::distance(first, last));
+  if (n == 0) return;
+
+  // пустой пул после reserve выдает n узлов подряд, так что при исключении
+  // созданные узлы - это первые built узлов начиная с firstNode
+  pool_.reserve(node_alloc_, n);
+  MapNode* firstNode = nullptr;
+  size_t built = 0;
+  auto next = [&] {
+    auto&& item = *first;
+    MapNode* node = createNode(nullptr, item.first, item.second);
+    ++first;
+    if (built++ == 0) firstNode = node;
+    return node;
+  };
+  try {
+    root_ = buildBalanced(n, blackHeightFor(n), next);
+  } catch (...) {
+    for (size_t i = 0; i < built; ++i) {
+      node_traits::destroy(node_alloc_, firstNode + i);
+    }
+    pool_.release(node_alloc_);
+    throw;
+  }
+  root_->parent = nullptr;
+  size_ = n;
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+S21Map<Key, T, Allocator, Compare, Ranked>::S21Map(const S21Map& other)
+    : root_(nullptr),
+      size_(0),
+      node_alloc_(node_traits::select_on_container_copy_construction(
+          other.node_alloc_)),
+      comp_(other.comp_) {
   if (other.root_) {
     root_ = copyTreeRecursive(other.root_, nullptr);
     size_ = other.size_;
   }
 }
 
-template <typename Key, typename T>
-S21Map<Key, T>::S21Map(S21Map&& m) noexcept : root_(m.root_), size_(m.size_) {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+S21Map<Key, T, Allocator, Compare, Ranked>::S21Map(S21Map&& m) noexcept
+    : root_(m.root_),
+      size_(m.size_),
+      node_alloc_(std::move(m.node_alloc_)),
+      comp_(m.comp_),
+      pool_(std::move(m.pool_)) {
   m.root_ = nullptr;
   m.size_ = 0;
 }
 
-template <typename Key, typename T>
-S21Map<Key, T>::~S21Map() noexcept {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+S21Map<Key, T, Allocator, Compare, Ranked>::~S21Map() noexcept {
   clear();
 }
 
-template <typename Key, typename T>
-void S21Map<Key, T>::clear() {
-  clearRecursive(root_);
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+typename S21Map<Key, T, Allocator, Compare, Ranked>::allocator_type
+S21Map<Key, T, Allocator, Compare, Ranked>::get_allocator() const {
+  return allocator_type(node_alloc_);
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+void S21Map<Key, T, Allocator, Compare, Ranked>::clear() {
+  // узлы без деструкторов не обходятся, слабы освобождаются разом
+  if constexpr (!std::is_trivially_destructible_v<MapNode>) {
+    clearRecursive(root_);
+  }
+  pool_.release(node_alloc_);
   root_ = nullptr;
   size_ = 0;
 }
 
-template <typename Key, typename T>
-S21Map<Key, T>& S21Map<Key, T>::operator=(S21Map&& m) noexcept {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+void S21Map<Key, T, Allocator, Compare, Ranked>::compact()
+  requires std::is_nothrow_move_constructible_v<Key> &&
+           std::is_nothrow_move_constructible_v<T>
+{
+  if (!root_) return;
+  node_pool<MapNode, node_allocator> fresh;
+  // после reserve перенос уже ничего не выделяет и не бросает
+  fresh.reserve(node_alloc_, size_);
+  root_ = compactRecursive(root_, nullptr, fresh);
+  pool_.release(node_alloc_);
+  pool_.swap(fresh);
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+S21Map<Key, T, Allocator, Compare, Ranked>&
+S21Map<Key, T, Allocator, Compare, Ranked>::operator=(
+    S21Map&& m) noexcept(nothrow_move_assign) {
   if (this != &m) {
     clear();
+    comp_ = m.comp_;
+
+    if constexpr (node_traits::propagate_on_container_move_assignment::value) {
+      node_alloc_ = std::move(m.node_alloc_);
+    } else if (node_alloc_ != m.node_alloc_) {
+      // nodes of m belong to another allocator and cannot be adopted
+      if (m.root_) {
+        root_ = copyTreeRecursive(m.root_, nullptr);
+        size_ = m.size_;
+      }
+      m.clear();
+      return *this;
+    }
     root_ = m.root_;
     size_ = m.size_;
+    pool_.swap(m.pool_);
 
     m.root_ = nullptr;
     m.size_ = 0;
@@ -260,90 +595,219 @@ S21Map<Key, T>& S21Map<Key, T>::operator=(S21Map&& m) noexcept {
   return *this;
 }
 
-template <typename Key, typename T>
-typename S21Map<Key, T>::iterator S21Map<Key, T>::begin() {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+typename S21Map<Key, T, Allocator, Compare, Ranked>::iterator
+S21Map<Key, T, Allocator, Compare, Ranked>::begin() {
   if (!root_) return end();
   MapNode* node = root_;
   while (node->left) node = node->left;
   return MapIterator(node);
 }
 
-template <typename Key, typename T>
-typename S21Map<Key, T>::iterator S21Map<Key, T>::end() {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+typename S21Map<Key, T, Allocator, Compare, Ranked>::iterator
+S21Map<Key, T, Allocator, Compare, Ranked>::end() {
   return MapIterator(nullptr);
 }
 
-template <typename Key, typename T>
-typename S21Map<Key, T>::const_iterator S21Map<Key, T>::begin() const {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+typename S21Map<Key, T, Allocator, Compare, Ranked>::const_iterator
+S21Map<Key, T, Allocator, Compare, Ranked>::begin() const {
   if (!root_) return end();
   const MapNode* node = root_;
   while (node->left) node = node->left;
   return MapConstIterator(node);
 }
 
-template <typename Key, typename T>
-typename S21Map<Key, T>::const_iterator S21Map<Key, T>::end() const {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+typename S21Map<Key, T, Allocator, Compare, Ranked>::const_iterator
+S21Map<Key, T, Allocator, Compare, Ranked>::end() const {
   return MapConstIterator(nullptr);
 }
 
-template <typename Key, typename T>
-pair<typename S21Map<Key, T>::iterator, bool> S21Map<Key, T>::insert(
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+pair<typename S21Map<Key, T, Allocator, Compare, Ranked>::iterator, bool>
+S21Map<Key, T, Allocator, Compare, Ranked>::insert(
     const pair<const Key, T>& value) {
-  bool inserted = false;
-  root_ = insert_recursive(root_, nullptr, value, inserted);
-  if (inserted) {
-    ++size_;
-    if (root_) root_->is_red = false;
-  }
-  return {find(value.first), inserted};
+  auto [node, inserted] = emplaceUnique(value.first, value.second);
+  return {MapIterator(node), inserted};
 }
 
-template <typename Key, typename T>
-pair<typename S21Map<Key, T>::iterator, bool> S21Map<Key, T>::insert(
-    const Key& key, const T& obj) {
-  return insert(pair<const Key, T>(key, obj));
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+pair<typename S21Map<Key, T, Allocator, Compare, Ranked>::iterator, bool>
+S21Map<Key, T, Allocator, Compare, Ranked>::insert(pair<const Key, T>&& value) {
+  auto [node, inserted] = emplaceUnique(value.first, std::move(value.second));
+  return {MapIterator(node), inserted};
 }
 
-template <typename Key, typename T>
-pair<typename S21Map<Key, T>::iterator, bool> S21Map<Key, T>::insert_or_assign(
-    const Key& key, const T& obj) {
-  MapIterator it = find(key);
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+pair<typename S21Map<Key, T, Allocator, Compare, Ranked>::iterator, bool>
+S21Map<Key, T, Allocator, Compare, Ranked>::insert(const Key& key,
+                                                   const T& obj) {
+  auto [node, inserted] = emplaceUnique(key, obj);
+  return {MapIterator(node), inserted};
+}
 
-  if (it != end()) {
-    it.iter_->value = obj;
-    return pair<MapIterator, bool>(it, false);
-  } else {
-    auto res = insert(key, obj);
-    return pair<MapIterator, bool>(res.first, true);
-  }
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+pair<typename S21Map<Key, T, Allocator, Compare, Ranked>::iterator, bool>
+S21Map<Key, T, Allocator, Compare, Ranked>::insert_or_assign(const Key& key,
+                                                             const T& obj) {
+  auto [node, inserted] = emplaceUnique(key, obj);
+  if (!inserted) node->value = obj;
+  return {MapIterator(node), inserted};
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+template <typename... Args>
+pair<typename S21Map<Key, T, Allocator, Compare, Ranked>::iterator, bool>
+S21Map<Key, T, Allocator, Compare, Ranked>::try_emplace(const Key& key,
+                                                        Args&&... args) {
+  auto [node, inserted] = emplaceUnique(key, std::forward<Args>(args)...);
+  return {MapIterator(node), inserted};
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+template <typename... Args>
+pair<typename S21Map<Key, T, Allocator, Compare, Ranked>::iterator, bool>
+S21Map<Key, T, Allocator, Compare, Ranked>::try_emplace(Key&& key,
+                                                        Args&&... args) {
+  auto [node, inserted] =
+      emplaceUnique(std::move(key), std::forward<Args>(args)...);
+  return {MapIterator(node), inserted};
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+template <typename... Args>
+pair<typename S21Map<Key, T, Allocator, Compare, Ranked>::iterator, bool>
+S21Map<Key, T, Allocator, Compare, Ranked>::emplace(Args&&... args) {
+  pair<Key, T> item(std::forward<Args>(args)...);
+  auto [node, inserted] =
+      emplaceUnique(std::move(item.first), std::move(item.second));
+  return {MapIterator(node), inserted};
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+typename S21Map<Key, T, Allocator, Compare, Ranked>::iterator
+S21Map<Key, T, Allocator, Compare, Ranked>::find(const Key& key) {
+  return MapIterator(findNode(key));
 }
 
-template <typename Key, typename T>
-typename S21Map<Key, T>::iterator S21Map<Key, T>::find(const Key& key) {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+template <typename K>
+S21Map<Key, T, Allocator, Compare, Ranked>::MapNode*
+S21Map<Key, T, Allocator, Compare, Ranked>::findNode(const K& key) const {
   MapNode* node = root_;
   while (node) {
-    if (key == node->key) {
-      return MapIterator(node);
-    } else if (key < node->key) {
+    if (comp_(key, node->key)) {
       node = node->left;
-    } else {
+    } else if (comp_(node->key, key)) {
       node = node->right;
+    } else {
+      return node;
     }
   }
-  return end();
+  return nullptr;
 }
 
-template <typename Key, typename T>
-void S21Map<Key, T>::erase(MapIterator pos) {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+void S21Map<Key, T, Allocator, Compare, Ranked>::erase(MapIterator pos) {
   if (pos.iter_ == nullptr) return;
-  Key key = pos.iter_->key;
-  root_ = eraseRecursive(root_, key);
+  destroyNode(unlinkNode(pos.iter_));
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+S21Map<Key, T, Allocator, Compare, Ranked>::MapNode*
+S21Map<Key, T, Allocator, Compare, Ranked>::unlinkNode(const MapNode* node) {
+  // ключ узла остается на месте, пока узел не вынут из дерева
+  MapNode* removed = nullptr;
+  root_ = eraseRecursive(root_, node->key, removed);
   --size_;
-  if (root_) root_->is_red = false;
+  if (root_) {
+    root_->parent = nullptr;
+    root_->is_red = false;
+  }
+  return removed;
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+typename S21Map<Key, T, Allocator, Compare, Ranked>::node_type
+S21Map<Key, T, Allocator, Compare, Ranked>::extract(const_iterator pos) {
+  if (pos.iter_ == nullptr) return node_type();
+  // элемент переезжает в отдельный узел дескриптора, слабы остаются пулу;
+  // ключ нужен для спуска, поэтому переносится уже после unlinkNode
+  using pool_type = node_pool<MapNode, node_allocator>;
+  MapNode* detached = pool_type::allocate_single(node_alloc_);
+  MapNode* node = nullptr;
+  if constexpr (std::is_nothrow_move_constructible_v<Key> &&
+                std::is_nothrow_move_constructible_v<T>) {
+    node = unlinkNode(pos.iter_);
+    node_traits::construct(node_alloc_, detached, nullptr,
+                           std::move(node->key), std::move(node->value));
+  } else {
+    try {
+      node_traits::construct(node_alloc_, detached, nullptr, pos.iter_->key,
+                             pos.iter_->value);
+    } catch (...) {
+      pool_type::deallocate_single(node_alloc_, detached);
+      throw;
+    }
+    node = unlinkNode(pos.iter_);
+  }
+  destroyNode(node);
+  return node_type(detached, node_alloc_);
 }
 
-template <typename Key, typename T>
-void S21Map<Key, T>::swap(S21Map& other) noexcept {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+typename S21Map<Key, T, Allocator, Compare, Ranked>::node_type
+S21Map<Key, T, Allocator, Compare, Ranked>::extract(const Key& key) {
+  return extract(const_iterator(findNode(key)));
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+typename S21Map<Key, T, Allocator, Compare, Ranked>::insert_return_type
+S21Map<Key, T, Allocator, Compare, Ranked>::insert(node_type&& nh) {
+  if (nh.empty()) return {end(), false, node_type()};
+
+  MapNode* parent = nullptr;
+  bool toLeft = false;
+  if (MapNode* found = findSlot(nh.key(), parent, toLeft)) {
+    return {MapIterator(found), false, std::move(nh)};
+  }
+
+  // узел переходит в пул этой карты: в свободный узел или со своим слабом
+  MapNode* node = pool_.adopt_single(node_alloc_, nh.release());
+  node->left = node->right = nullptr;
+  node->is_red = true;
+  if constexpr (Ranked) node->subtree_size = 1;
+  linkNode(node, parent, toLeft);
+  return {MapIterator(node), true, node_type()};
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+void S21Map<Key, T, Allocator, Compare, Ranked>::swap(S21Map& other) noexcept {
+  if constexpr (node_traits::propagate_on_container_swap::value) {
+    std::swap(node_alloc_, other.node_alloc_);
+  }
+
   MapNode* tmp = root_;
   root_ = other.root_;
   other.root_ = tmp;
@@ -351,11 +815,25 @@ void S21Map<Key, T>::swap(S21Map& other) noexcept {
   size_t tmp_size = size_;
   size_ = other.size_;
   other.size_ = tmp_size;
+
+  std::swap(comp_, other.comp_);
+  pool_.swap(other.pool_);
 }
 
-template <typename Key, typename T>
-void S21Map<Key, T>::merge(S21Map& other) {
-  if (this == &other) return;
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+void S21Map<Key, T, Allocator, Compare, Ranked>::merge(S21Map& other) {
+  if (this == &other || !other.root_) return;
+
+  // узлы переносятся, только если оставшиеся в other можно переместить на
+  // новые узлы без исключений
+  if constexpr (std::is_nothrow_move_constructible_v<Key> &&
+                std::is_nothrow_move_constructible_v<T>) {
+    if (node_alloc_ == other.node_alloc_) {
+      mergeRelinking(other);
+      return;
+    }
+  }
 
   S21List<Key> keys_to_move;
 
@@ -379,30 +857,168 @@ void S21Map<Key, T>::merge(S21Map& other) {
   }
 }
 
-template <typename Key, typename T>
-bool S21Map<Key, T>::contains(const Key& key) {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+void S21Map<Key, T, Allocator, Compare, Ranked>::mergeRelinking(S21Map& other) {
+  // мало узлов в other - вставляем их по одному, иначе пересобираем дерево
+  bool oneByOne = other.size_ * std::bit_width(size_ + 1) < size_;
+
+  // 1. ключи, которые уже есть здесь, остаются в other
+  size_t kept = 0;
+  if (oneByOne) {
+    for (auto it = other.begin(); it != other.end(); ++it) {
+      if (findNode(it.iter_->key)) ++kept;
+    }
+  } else {
+    const_iterator mine = begin();
+    for (auto theirs = other.begin(); theirs != other.end(); ++theirs) {
+      while (mine.iter_ && comp_(mine.iter_->key, theirs.iter_->key)) ++mine;
+      if (mine.iter_ && !comp_(theirs.iter_->key, mine.iter_->key)) ++kept;
+    }
+  }
+
+  // только дубликаты: ничего не переносится, пулы остаются раздельными
+  if (kept == other.size_) return;
+
+  // 2. слабы other со всеми его узлами переходят сюда, у other свой пул;
+  // после reserve ничего дальше не бросает
+  node_pool<MapNode, node_allocator> fresh;
+  fresh.reserve(other.node_alloc_, kept);
+  pool_.adopt(other.pool_);
+  other.pool_.swap(fresh);
+
+  MapNode* theirs = nullptr;
+  MapNode* theirsTail = nullptr;
+  chainInOrder(other.root_, theirs, theirsTail);
+  other.root_ = nullptr;
+  other.size_ = 0;
+
+  MapNode* keptHead = nullptr;
+  MapNode* keptTail = nullptr;
+  auto keep = [&](MapNode* node) {
+    node->right = nullptr;
+    if (keptTail) {
+      keptTail->right = node;
+    } else {
+      keptHead = node;
+    }
+    keptTail = node;
+  };
+
+  // 3. остальные узлы перевешиваются в это дерево
+  if (oneByOne) {
+    while (theirs) {
+      MapNode* node = theirs;
+      theirs = theirs->right;
+      MapNode* parent = nullptr;
+      bool toLeft = false;
+      if (findSlot(node->key, parent, toLeft)) {
+        keep(node);
+      } else {
+        node->right = nullptr;
+        node->is_red = true;
+        if constexpr (Ranked) node->subtree_size = 1;
+        linkNode(node, parent, toLeft);
+      }
+    }
+  } else {
+    MapNode* mine = nullptr;
+    MapNode* mineTail = nullptr;
+    chainInOrder(root_, mine, mineTail);
+    MapNode* merged = nullptr;
+    MapNode* mergedTail = nullptr;
+    size_t count = 0;
+    while (mine || theirs) {
+      MapNode* node = nullptr;
+      if (!theirs || (mine && comp_(mine->key, theirs->key))) {
+        node = mine;
+        mine = mine->right;
+      } else if (!mine || comp_(theirs->key, mine->key)) {
+        node = theirs;
+        theirs = theirs->right;
+      } else {
+        node = theirs;
+        theirs = theirs->right;
+        keep(node);
+        continue;
+      }
+      if (mergedTail) {
+        mergedTail->right = node;
+      } else {
+        merged = node;
+      }
+      mergedTail = node;
+      ++count;
+    }
+    auto next = [&] {
+      MapNode* node = merged;
+      merged = merged->right;
+      return node;
+    };
+    root_ = buildBalanced(count, blackHeightFor(count), next);
+    root_->parent = nullptr;
+    size_ = count;
+  }
+
+  // 4. оставшиеся в other ключи переезжают на узлы из его нового пула
+  if (kept == 0) return;
+  auto rehome = [&] {
+    MapNode* old = keptHead;
+    keptHead = keptHead->right;
+    MapNode* node = other.createNode(nullptr, std::move(old->key),
+                                     std::move(old->value));
+    destroyNode(old);
+    return node;
+  };
+  other.root_ = other.buildBalanced(kept, blackHeightFor(kept), rehome);
+  other.root_->parent = nullptr;
+  other.size_ = kept;
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+bool S21Map<Key, T, Allocator, Compare, Ranked>::contains(const Key& key) {
   // if (find(key))
   //   return true;
   // else
   //   return false;
-  return find(key) != end();
+  return findNode(key) != nullptr;
 }
 
-template <typename Key, typename T>
-bool S21Map<Key, T>::empty() {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+typename S21Map<Key, T, Allocator, Compare, Ranked>::size_type
+S21Map<Key, T, Allocator, Compare, Ranked>::count(const Key& key) {
+  return findNode(key) != nullptr;
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+typename S21Map<Key, T, Allocator, Compare, Ranked>::key_compare
+S21Map<Key, T, Allocator, Compare, Ranked>::key_comp() const {
+  return comp_;
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+bool S21Map<Key, T, Allocator, Compare, Ranked>::empty() {
   if (!size_)
     return true;
   else
     return false;
 }
 
-template <typename Key, typename T>
-typename S21Map<Key, T>::size_type S21Map<Key, T>::size() {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+typename S21Map<Key, T, Allocator, Compare, Ranked>::size_type
+S21Map<Key, T, Allocator, Compare, Ranked>::size() {
   return size_;
 }
 
-template <typename Key, typename T>
-typename S21Map<Key, T>::size_type S21Map<Key, T>::max_size() const noexcept {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+typename S21Map<Key, T, Allocator, Compare, Ranked>::size_type
+S21Map<Key, T, Allocator, Compare, Ranked>::max_size() const noexcept {
   const size_t node_size = sizeof(MapNode);
   const size_t max_size_t = std::numeric_limits<T>::max();
   if (node_size == 0) return max_size_t;
@@ -410,8 +1026,9 @@ typename S21Map<Key, T>::size_type S21Map<Key, T>::max_size() const noexcept {
   return max_size_t / node_size;
 };
 
-template <typename Key, typename T>
-T& S21Map<Key, T>::at(const Key& key) {
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+T& S21Map<Key, T, Allocator, Compare, Ranked>::at(const Key& key) {
   MapIterator it = find(key);
   if (it == end()) {
     throw std::out_of_range("s21::S21Map::at: key not found");
@@ -419,18 +1036,20 @@ T& S21Map<Key, T>::at(const Key& key) {
   return it.iter_->value;
 }
 
-template <typename Key, typename T>
-T& S21Map<Key, T>::operator[](const Key& key) {
-  MapIterator it = find(key);
-  if (it != end()) {
-    return it.iter_->value;
-  }
-  auto res = insert(pair<const Key, T>(key, T()));
-  return res.first.iter_->value;
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+T& S21Map<Key, T, Allocator, Compare, Ranked>::operator[](const Key& key) {
+  return emplaceUnique(key).first->value;
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+T& S21Map<Key, T, Allocator, Compare, Ranked>::operator[](Key&& key) {
+  return emplaceUnique(std::move(key)).first->value;
 }
 
 // template <typename Key, typename T>
-// void S21Map<Key, T>::printTree() const {
+// void S21Map<Key, T, Allocator, Compare>::printTree() const {
 //   if (!root_) {
 //     std::cout << "(empty)\n";
 //     return;
@@ -441,7 +1060,7 @@ T& S21Map<Key, T>::operator[](const Key& key) {
 // }
 
 // template <typename Key, typename T>
-// void S21Map<Key, T>::printTreeRecursive(MapNode* node,
+// void S21Map<Key, T, Allocator, Compare>::printTreeRecursive(MapNode* node,
 //                                         const std::string& prefix,
 //                                         bool is_left) const {
 //   if (!node) return;
@@ -478,5 +1097,83 @@ T& S21Map<Key, T>::operator[](const Key& key) {
 //   }
 // }
 
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+typename S21Map<Key, T, Allocator, Compare, Ranked>::size_type
+S21Map<Key, T, Allocator, Compare, Ranked>::rank(const Key& key) const
+  requires Ranked
+{
+  size_type before = 0;
+  for (const MapNode* node = root_; node;) {
+    if (comp_(node->key, key)) {
+      before += subtreeSize(node->left) + 1;
+      node = node->right;
+    } else {
+      node = node->left;
+    }
+  }
+  return before;
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+typename S21Map<Key, T, Allocator, Compare, Ranked>::iterator
+S21Map<Key, T, Allocator, Compare, Ranked>::select(size_type k)
+  requires Ranked
+{
+  MapNode* node = root_;
+  while (node) {
+    size_type left = subtreeSize(node->left);
+    if (k < left) {
+      node = node->left;
+    } else if (k == left) {
+      break;
+    } else {
+      k -= left + 1;
+      node = node->right;
+    }
+  }
+  return MapIterator(node);
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+typename S21Map<Key, T, Allocator, Compare, Ranked>::const_iterator
+S21Map<Key, T, Allocator, Compare, Ranked>::select(size_type k) const
+  requires Ranked
+{
+  return const_cast<S21Map*>(this)->select(k);
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+typename S21Map<Key, T, Allocator, Compare, Ranked>::size_type
+S21Map<Key, T, Allocator, Compare, Ranked>::index_of(const_iterator pos) const
+  requires Ranked
+{
+  const MapNode* node = pos.iter_;
+  if (!node) return size_;
+  // узлы левее: левое поддерево и каждый предок, от которого шли вправо
+  size_type index = subtreeSize(node->left);
+  for (; node->parent; node = node->parent) {
+    if (node == node->parent->right) {
+      index += subtreeSize(node->parent->left) + 1;
+    }
+  }
+  return index;
+}
+
+template <typename Key, typename T, typename Allocator, typename Compare,
+          bool Ranked>
+typename S21Map<Key, T, Allocator, Compare, Ranked>::difference_type
+S21Map<Key, T, Allocator, Compare, Ranked>::distance(
+    const_iterator first, const_iterator last) const
+  requires Ranked
+{
+  return static_cast<difference_type>(index_of(last)) -
+         static_cast<difference_type>(index_of(first));
+}
+
 }  // namespace s21
-#endif
\ No newline at end of file
+
+#endif
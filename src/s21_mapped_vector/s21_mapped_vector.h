@@ -0,0 +1,102 @@
+#ifndef S21_MAPPED_VECTOR_H
+#define S21_MAPPED_VECTOR_H
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+#include "../s21_vector/s21_vector.h"
+
+namespace s21 {
+
+// Vector of fixed-size records stored in a file and accessed through mmap.
+// Opening is O(1): the elements are the file contents, paged in on first
+// touch and shared with every other process mapping the same file. The
+// file is kept at capacity() records while the vector grows and cut back to
+// size() records by sync() and close(), so other readers, and a reopen after
+// a crash, see the elements up to the last sync() and no spare records.
+//
+// read_write maps the file shared, so appends and writes through
+// references reach the file. read_only maps it privately: the elements can
+// still be modified in memory (copy-on-write), but nothing is written back
+// and the vector cannot grow.
+template <typename T>
+class mapped_vector {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "mapped_vector stores raw bytes of T in a file");
+
+ public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using iterator = typename s21::vector<T>::iterator;
+  using const_iterator = typename s21::vector<T>::const_iterator;
+  using size_type = std::size_t;
+
+  enum class open_mode { read_only, read_write };
+
+  mapped_vector();
+  explicit mapped_vector(const std::string& path,
+                         open_mode mode = open_mode::read_write);
+  mapped_vector(const mapped_vector&) = delete;
+  mapped_vector(mapped_vector&& v) noexcept;
+  ~mapped_vector();
+  mapped_vector& operator=(const mapped_vector&) = delete;
+  mapped_vector& operator=(mapped_vector&& v) noexcept;
+
+  // Opens (read_write also creates) the file at path; the current file is
+  // closed first. Throws std::system_error when a system call fails and
+  // std::invalid_argument when the file size is not a whole number of
+  // records.
+  void open(const std::string& path, open_mode mode = open_mode::read_write);
+  void close();
+  bool is_open() const;
+  bool writable() const;
+
+  reference at(size_type pos);
+  const_reference at(size_type pos) const;
+  reference operator[](size_type pos);
+  const_reference operator[](size_type pos) const;
+  const_reference front() const;
+  const_reference back() const;
+  value_type* data();
+  const value_type* data() const;
+
+  iterator begin();
+  const_iterator begin() const;
+  iterator end();
+  const_iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+  void reserve(size_type new_capacity);
+  size_type capacity() const;
+
+  void clear();
+  void push_back(const_reference value);
+  void append(const value_type* items, size_type count);
+  void pop_back();
+  void swap(mapped_vector& other) noexcept;
+
+  // flushes the elements to the file (msync with MS_SYNC) and truncates it
+  // to size() records; capacity() drops to size()
+  void sync();
+
+ private:
+  int _fd;
+  bool _writable;
+  value_type* _data;
+  size_type _size;
+  size_type _capacity;
+
+  void require_writable() const;
+  void map(size_type new_capacity);
+  void unmap();
+};
+
+}  // namespace s21
+
+#include "s21_mapped_vector.tpp"
+
+#endif
@@ -0,0 +1,332 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include "s21_mapped_vector.h"
+
+namespace s21 {
+
+template <typename T>
+mapped_vector<T>::mapped_vector()
+    : _fd(-1), _writable(false), _data(nullptr), _size(0), _capacity(0) {}
+
+template <typename T>
+mapped_vector<T>::mapped_vector(const std::string& path, open_mode mode)
+    : mapped_vector() {
+  open(path, mode);
+}
+
+template <typename T>
+mapped_vector<T>::mapped_vector(mapped_vector&& v) noexcept
+    : mapped_vector() {
+  swap(v);
+}
+
+template <typename T>
+mapped_vector<T>::~mapped_vector() {
+  try {
+    close();
+  } catch (...) {
+    // a failed truncate only leaves unused records at the end of the file
+  }
+}
+
+template <typename T>
+mapped_vector<T>& mapped_vector<T>::operator=(mapped_vector&& v) noexcept {
+  if (this != &v) {
+    mapped_vector tmp(std::move(v));
+    swap(tmp);
+  }
+  return *this;
+}
+
+template <typename T>
+void mapped_vector<T>::open(const std::string& path, open_mode mode) {
+  close();
+
+  bool writable = mode == open_mode::read_write;
+  int fd = writable ? ::open(path.c_str(), O_RDWR | O_CREAT, 0644)
+                    : ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(),
+                            "mapped_vector: cannot open " + path);
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    int err = errno;
+    ::close(fd);
+    throw std::system_error(err, std::generic_category(),
+                            "mapped_vector: cannot stat " + path);
+  }
+  size_type bytes = static_cast<size_type>(st.st_size);
+  if (bytes % sizeof(value_type) != 0) {
+    ::close(fd);
+    throw std::invalid_argument("mapped_vector: size of " + path +
+                                " is not a multiple of the record size");
+  }
+
+  _fd = fd;
+  _writable = writable;
+  try {
+    map(bytes / sizeof(value_type));
+  } catch (...) {
+    ::close(_fd);
+    _fd = -1;
+    _writable = false;
+    throw;
+  }
+  _size = _capacity;
+}
+
+template <typename T>
+void mapped_vector<T>::close() {
+  if (_fd < 0) {
+    return;
+  }
+  unmap();
+  int rc = _writable ? ::ftruncate(_fd, _size * sizeof(value_type)) : 0;
+  int err = errno;
+  ::close(_fd);
+  _fd = -1;
+  _writable = false;
+  _size = 0;
+  if (rc != 0) {
+    throw std::system_error(err, std::generic_category(),
+                            "mapped_vector: cannot truncate file");
+  }
+}
+
+template <typename T>
+bool mapped_vector<T>::is_open() const {
+  return _fd >= 0;
+}
+
+template <typename T>
+bool mapped_vector<T>::writable() const {
+  return _writable;
+}
+
+template <typename T>
+typename mapped_vector<T>::reference mapped_vector<T>::at(size_type pos) {
+  if (pos >= _size) {
+    throw std::out_of_range("Index out of range");
+  }
+  return _data[pos];
+}
+
+template <typename T>
+typename mapped_vector<T>::const_reference mapped_vector<T>::at(
+    size_type pos) const {
+  if (pos >= _size) {
+    throw std::out_of_range("Index out of range");
+  }
+  return _data[pos];
+}
+
+template <typename T>
+typename mapped_vector<T>::reference mapped_vector<T>::operator[](
+    size_type pos) {
+  return _data[pos];
+}
+
+template <typename T>
+typename mapped_vector<T>::const_reference mapped_vector<T>::operator[](
+    size_type pos) const {
+  return _data[pos];
+}
+
+template <typename T>
+typename mapped_vector<T>::const_reference mapped_vector<T>::front() const {
+  if (_size == 0) throw std::out_of_range("Vector is empty");
+  return _data[0];
+}
+
+template <typename T>
+typename mapped_vector<T>::const_reference mapped_vector<T>::back() const {
+  if (_size == 0) throw std::out_of_range("Vector is empty");
+  return _data[_size - 1];
+}
+
+template <typename T>
+typename mapped_vector<T>::value_type* mapped_vector<T>::data() {
+  return _data;
+}
+
+template <typename T>
+const typename mapped_vector<T>::value_type* mapped_vector<T>::data() const {
+  return _data;
+}
+
+template <typename T>
+typename mapped_vector<T>::iterator mapped_vector<T>::begin() {
+  return iterator(_data);
+}
+
+template <typename T>
+typename mapped_vector<T>::const_iterator mapped_vector<T>::begin() const {
+  return const_iterator(_data);
+}
+
+template <typename T>
+typename mapped_vector<T>::iterator mapped_vector<T>::end() {
+  return iterator(_data + _size);
+}
+
+template <typename T>
+typename mapped_vector<T>::const_iterator mapped_vector<T>::end() const {
+  return const_iterator(_data + _size);
+}
+
+template <typename T>
+bool mapped_vector<T>::empty() const {
+  return _size == 0;
+}
+
+template <typename T>
+typename mapped_vector<T>::size_type mapped_vector<T>::size() const {
+  return _size;
+}
+
+template <typename T>
+typename mapped_vector<T>::size_type mapped_vector<T>::max_size() const {
+  return std::numeric_limits<size_type>::max() / sizeof(value_type);
+}
+
+// Extends the file to new_capacity records and maps the larger file.
+template <typename T>
+void mapped_vector<T>::reserve(size_type new_capacity) {
+  if (new_capacity <= _capacity) {
+    return;
+  }
+  require_writable();
+  if (::ftruncate(_fd, new_capacity * sizeof(value_type)) != 0) {
+    throw std::system_error(errno, std::generic_category(),
+                            "mapped_vector: cannot grow file");
+  }
+  map(new_capacity);
+}
+
+template <typename T>
+typename mapped_vector<T>::size_type mapped_vector<T>::capacity() const {
+  return _capacity;
+}
+
+template <typename T>
+void mapped_vector<T>::clear() {
+  _size = 0;
+}
+
+template <typename T>
+void mapped_vector<T>::push_back(const_reference value) {
+  require_writable();
+  if (_size == _capacity) {
+    // value may live in the mapping that is about to be replaced
+    value_type copy = value;
+    reserve(growth::doubling::grow(_capacity, _size + 1, sizeof(value_type)));
+    _data[_size++] = copy;
+  } else {
+    _data[_size++] = value;
+  }
+}
+
+template <typename T>
+void mapped_vector<T>::append(const value_type* items, size_type count) {
+  require_writable();
+  if (_size + count > _capacity) {
+    bool aliased = items >= _data && items < _data + _capacity;
+    size_type offset = aliased ? items - _data : 0;
+    reserve(growth::doubling::grow(_capacity, _size + count,
+                                   sizeof(value_type)));
+    if (aliased) {
+      items = _data + offset;
+    }
+  }
+  if (count > 0) {
+    std::memmove(static_cast<void*>(_data + _size), items,
+                 count * sizeof(value_type));
+  }
+  _size += count;
+}
+
+template <typename T>
+void mapped_vector<T>::pop_back() {
+  if (_size > 0) {
+    --_size;
+  }
+}
+
+template <typename T>
+void mapped_vector<T>::swap(mapped_vector& other) noexcept {
+  std::swap(_fd, other._fd);
+  std::swap(_writable, other._writable);
+  std::swap(_data, other._data);
+  std::swap(_size, other._size);
+  std::swap(_capacity, other._capacity);
+}
+
+// The spare records are unmapped before the file is cut back, so no page of
+// the mapping ever lies past the end of the file.
+template <typename T>
+void mapped_vector<T>::sync() {
+  if (!_data || !_writable) {
+    return;
+  }
+  if (::msync(_data, _size * sizeof(value_type), MS_SYNC) != 0) {
+    throw std::system_error(errno, std::generic_category(),
+                            "mapped_vector: msync failed");
+  }
+  if (_size < _capacity) {
+    map(_size);
+    if (::ftruncate(_fd, _size * sizeof(value_type)) != 0) {
+      throw std::system_error(errno, std::generic_category(),
+                              "mapped_vector: cannot truncate file");
+    }
+  }
+}
+
+template <typename T>
+void mapped_vector<T>::require_writable() const {
+  if (!_writable) {
+    throw std::logic_error("mapped_vector: not opened for writing");
+  }
+}
+
+// Maps the first new_capacity records of the file. The new mapping is made
+// before the old one is dropped, so a failure leaves the vector unchanged.
+template <typename T>
+void mapped_vector<T>::map(size_type new_capacity) {
+  value_type* new_data = nullptr;
+  if (new_capacity > 0) {
+    void* p = ::mmap(nullptr, new_capacity * sizeof(value_type),
+                     PROT_READ | PROT_WRITE,
+                     _writable ? MAP_SHARED : MAP_PRIVATE, _fd, 0);
+    if (p == MAP_FAILED) {
+      throw std::system_error(errno, std::generic_category(),
+                              "mapped_vector: mmap failed");
+    }
+    new_data = static_cast<value_type*>(p);
+  }
+  unmap();
+  _data = new_data;
+  _capacity = new_capacity;
+}
+
+template <typename T>
+void mapped_vector<T>::unmap() {
+  if (_data) {
+    ::munmap(_data, _capacity * sizeof(value_type));
+  }
+  _data = nullptr;
+  _capacity = 0;
+}
+
+}  // namespace s21
@@ -2,24 +2,39 @@
 #define S21_MULTISET_H_
 
 #include <cstddef>
+#include <functional>
 #include <initializer_list>
 #include <limits>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "../s21_node_pool/s21_node_pool.h"
+
 namespace s21 {
 
-template <typename Key>
+template <typename Key, typename Allocator = std::allocator<Key>,
+          typename Compare = std::less<Key>>
 class multiset {
  public:
   // Типы-члены
   using key_type = Key;
   using value_type = Key;  // В multiset ключ и значение совпадают
+  using allocator_type = Allocator;
+  using key_compare = Compare;
+  using value_compare = Compare;
   using reference = value_type&;
   using const_reference = const value_type&;
   using size_type = std::size_t;
   using difference_type = std::ptrdiff_t;
 
+  // Поиск принимает любой тип K, сравнимый с Key, если Compare объявляет
+  // is_transparent (например, std::less<>)
+  static constexpr bool is_transparent =
+      requires { typename Compare::is_transparent; };
+
   // Внутренний класс Node для дерева
   struct Node {
     value_type value;
@@ -30,7 +45,7 @@ class multiset {
     size_type count;  // количество одинаковых элементов
 
     Node(value_type val, Node* p = nullptr, bool col = true)
-        : value(val),
+        : value(std::move(val)),
           parent(p),
           left(nullptr),
           right(nullptr),
@@ -38,6 +53,17 @@ class multiset {
           count(1) {}
   };
 
+ private:
+  using node_allocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<Node>;
+  using node_traits = std::allocator_traits<node_allocator>;
+
+  static constexpr bool nothrow_move_assign =
+      node_traits::propagate_on_container_move_assignment::value ||
+      node_traits::is_always_equal::value;
+
+ public:
+
   // Класс итератора
   class iterator {
    public:
@@ -111,16 +137,39 @@ class multiset {
     friend class multiset;
   };
 
+  // Владеющий дескриптор узла, вынутого extract(); value() можно менять до
+  // повторной вставки
+  class node_type : public node_handle<Node, node_allocator, Allocator> {
+   public:
+    using value_type = Key;
+
+    constexpr node_type() noexcept = default;
+
+    value_type& value() const { return this->node_->value; }
+
+   private:
+    friend class multiset;
+
+    node_type(Node* node, const node_allocator& alloc)
+        : node_handle<Node, node_allocator, Allocator>(node, alloc) {}
+  };
+
   // Конструкторы
   multiset();
+  explicit multiset(const Allocator& alloc);
+  explicit multiset(const Compare& comp, const Allocator& alloc = Allocator());
   multiset(std::initializer_list<value_type> const& items);
   multiset(const multiset& other);
   multiset(multiset&& other) noexcept;
   ~multiset();
 
+  allocator_type get_allocator() const;
+  key_compare key_comp() const;
+  value_compare value_comp() const;
+
   // Операторы присваивания
   multiset& operator=(const multiset& other);
-  multiset& operator=(multiset&& other) noexcept;
+  multiset& operator=(multiset&& other) noexcept(nothrow_move_assign);
 
   // Итераторы
   iterator begin();
@@ -136,11 +185,28 @@ class multiset {
   size_type max_size() const noexcept;
 
   // Модификаторы
+  // clear() возвращает слабы узлов аллокатору целиком
   void clear();
   iterator insert(const value_type& value);
   void erase(iterator pos);
+  // Вынимает элемент из дерева и переносит его в узел дескриптора, который
+  // не зависит от этого multiset (копирует, если перенос может бросить); для
+  // end() и отсутствующего ключа дескриптор пуст
+  node_type extract(const_iterator pos);
+  node_type extract(const Key& key);
+  // Вставляет узел дескриптора после равных ему без выделения памяти; nh
+  // должен прийти из multiset с равным аллокатором. Для пустого - end()
+  iterator insert(node_type&& nh);
   void swap(multiset& other);
+  // При равных аллокаторах узлы other перевешиваются сюда без копирования
+  // вместе со слабами; они остаются здесь до clear(), compact() или
+  // разрушения, а other при новых вставках берет свои слабы
   void merge(multiset& other);
+  // Переносит элементы в один новый слаб в порядке ключей, чтобы обход шел
+  // по памяти подряд; старые слабы освобождаются. Инвалидирует итераторы,
+  // на время переноса аллокатор держит обе копии
+  void compact()
+    requires std::is_nothrow_move_constructible_v<Key>;
 
   // Поиск
   iterator find(const Key& key);
@@ -154,6 +220,58 @@ class multiset {
   std::pair<iterator, iterator> equal_range(const Key& key);
   std::pair<const_iterator, const_iterator> equal_range(const Key& key) const;
 
+  // Гетерогенный поиск для прозрачных компараторов
+  template <typename K>
+    requires is_transparent
+  iterator find(const K& key) {
+    return iterator(find_node(key), this);
+  }
+  template <typename K>
+    requires is_transparent
+  const_iterator find(const K& key) const {
+    return const_iterator(find_node(key), this);
+  }
+  template <typename K>
+    requires is_transparent
+  bool contains(const K& key) const {
+    return find_node(key) != nil_;
+  }
+  template <typename K>
+    requires is_transparent
+  size_type count(const K& key) const {
+    return count_nodes(key);
+  }
+  template <typename K>
+    requires is_transparent
+  iterator lower_bound(const K& key) {
+    return iterator(lower_bound_node(key), this);
+  }
+  template <typename K>
+    requires is_transparent
+  const_iterator lower_bound(const K& key) const {
+    return const_iterator(lower_bound_node(key), this);
+  }
+  template <typename K>
+    requires is_transparent
+  iterator upper_bound(const K& key) {
+    return iterator(upper_bound_node(key), this);
+  }
+  template <typename K>
+    requires is_transparent
+  const_iterator upper_bound(const K& key) const {
+    return const_iterator(upper_bound_node(key), this);
+  }
+  template <typename K>
+    requires is_transparent
+  std::pair<iterator, iterator> equal_range(const K& key) {
+    return {lower_bound(key), upper_bound(key)};
+  }
+  template <typename K>
+    requires is_transparent
+  std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
   // Вставка нескольких элементов (требование из задания)
   template <typename... Args>
   std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
@@ -163,9 +281,23 @@ class multiset {
   Node* root_;
   Node* nil_;  // Специальный листовой узел
   size_type size_;
+  [[no_unique_address]] node_allocator node_alloc_;
+  // ключи упорядочены только через comp_: равны те, что не меньше друг друга
+  [[no_unique_address]] Compare comp_;
+  // слабы, из которых берутся узлы дерева; nil_ выделяется отдельно
+  node_pool<Node, node_allocator> pool_;
 
   // Вспомогательные методы
+  Node* create_node(const value_type& value, Node* parent, bool color);
+  void destroy_node(Node* node);
+  // вставка готового узла после равных ему и вынимание без уничтожения
+  void link_node(Node* z);
+  Node* unlink_node(Node* z);
+  void relink_subtree(Node* node, Node* other_nil);
   void initialize_nil();
+  void destroy_nil();
+  Node* compact_subtree(Node* node, Node* parent,
+                        node_pool<Node, node_allocator>& fresh);
   void copy_tree(const multiset& other);
   void destroy_tree(Node* node);
   void rotate_left(Node* x);
@@ -175,11 +307,24 @@ class multiset {
   void transplant(Node* u, Node* v);
   Node* minimum(Node* node) const;
   Node* maximum(Node* node) const;
-  Node* find_node(const Key& key) const;
-  Node* lower_bound_node(const Key& key) const;
-  Node* upper_bound_node(const Key& key) const;
+  template <typename K>
+  Node* find_node(const K& key) const;
+  template <typename K>
+  Node* lower_bound_node(const K& key) const;
+  template <typename K>
+  Node* upper_bound_node(const K& key) const;
+  template <typename K>
+  size_type count_nodes(const K& key) const;
 };
 
+namespace pmr {
+
+template <typename Key, typename Compare = std::less<Key>>
+using multiset =
+    s21::multiset<Key, std::pmr::polymorphic_allocator<Key>, Compare>;
+
+}  // namespace pmr
+
 }  // namespace s21
 
 #include "s21_multiset.tpp"
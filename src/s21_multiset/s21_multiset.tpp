@@ -10,59 +10,129 @@ namespace s21 {
 
 // ==================== КОНСТРУКТОРЫ И ДЕСТРУКТОР ====================
 
-template <typename Key>
-multiset<Key>::multiset() : root_(nullptr), size_(0) {
+template <typename Key, typename Allocator, typename Compare>
+multiset<Key, Allocator, Compare>::multiset() : root_(nullptr), size_(0) {
   initialize_nil();
   root_ = nil_;
 }
 
-template <typename Key>
-multiset<Key>::multiset(std::initializer_list<value_type> const& items)
+template <typename Key, typename Allocator, typename Compare>
+multiset<Key, Allocator, Compare>::multiset(const Allocator& alloc)
+    : root_(nullptr), size_(0), node_alloc_(alloc) {
+  initialize_nil();
+  root_ = nil_;
+}
+
+template <typename Key, typename Allocator, typename Compare>
+multiset<Key, Allocator, Compare>::multiset(const Compare& comp,
+                                            const Allocator& alloc)
+    : root_(nullptr), size_(0), node_alloc_(alloc), comp_(comp) {
+  initialize_nil();
+  root_ = nil_;
+}
+
+template <typename Key, typename Allocator, typename Compare>
+multiset<Key, Allocator, Compare>::multiset(
+    std::initializer_list<value_type> const& items)
     : multiset() {
   for (const auto& item : items) {
     insert(item);
   }
 }
 
-template <typename Key>
-multiset<Key>::multiset(const multiset& other) : multiset() {
+template <typename Key, typename Allocator, typename Compare>
+multiset<Key, Allocator, Compare>::multiset(const multiset& other)
+    : multiset(other.comp_,
+               Allocator(node_traits::select_on_container_copy_construction(
+                   other.node_alloc_))) {
   copy_tree(other);
 }
 
-template <typename Key>
-multiset<Key>::multiset(multiset&& other) noexcept
-    : root_(other.root_), nil_(other.nil_), size_(other.size_) {
+template <typename Key, typename Allocator, typename Compare>
+multiset<Key, Allocator, Compare>::multiset(multiset&& other) noexcept
+    : root_(other.root_),
+      nil_(other.nil_),
+      size_(other.size_),
+      node_alloc_(std::move(other.node_alloc_)),
+      comp_(other.comp_),
+      pool_(std::move(other.pool_)) {
   other.root_ = nullptr;
   other.nil_ = nullptr;
   other.size_ = 0;
 }
 
-template <typename Key>
-multiset<Key>::~multiset() {
+template <typename Key, typename Allocator, typename Compare>
+multiset<Key, Allocator, Compare>::~multiset() {
   clear();
-  delete nil_;
+  if (nil_) destroy_nil();
+}
+
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::allocator_type
+multiset<Key, Allocator, Compare>::get_allocator() const {
+  return allocator_type(node_alloc_);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::key_compare
+multiset<Key, Allocator, Compare>::key_comp() const {
+  return comp_;
+}
+
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::value_compare
+multiset<Key, Allocator, Compare>::value_comp() const {
+  return comp_;
 }
 
 // ==================== ОПЕРАТОРЫ ПРИСВАИВАНИЯ ====================
 
-template <typename Key>
-multiset<Key>& multiset<Key>::operator=(const multiset& other) {
+template <typename Key, typename Allocator, typename Compare>
+multiset<Key, Allocator, Compare>& multiset<Key, Allocator, Compare>::operator=(
+    const multiset& other) {
   if (this != &other) {
     clear();
+    comp_ = other.comp_;
+    if constexpr (node_traits::propagate_on_container_copy_assignment::value) {
+      if (node_alloc_ != other.node_alloc_) {
+        destroy_nil();
+        node_alloc_ = other.node_alloc_;
+        initialize_nil();
+        root_ = nil_;
+      } else {
+        node_alloc_ = other.node_alloc_;
+      }
+    }
     copy_tree(other);
   }
   return *this;
 }
 
-template <typename Key>
-multiset<Key>& multiset<Key>::operator=(multiset&& other) noexcept {
+template <typename Key, typename Allocator, typename Compare>
+multiset<Key, Allocator, Compare>& multiset<Key, Allocator, Compare>::operator=(
+    multiset&& other) noexcept(nothrow_move_assign) {
   if (this != &other) {
     clear();
-    delete nil_;
+    comp_ = other.comp_;
+
+    if constexpr (!node_traits::propagate_on_container_move_assignment::value) {
+      if (node_alloc_ != other.node_alloc_) {
+        // nodes of other belong to another allocator and cannot be adopted
+        copy_tree(other);
+        other.clear();
+        return *this;
+      }
+    }
+
+    if (nil_) destroy_nil();
+    if constexpr (node_traits::propagate_on_container_move_assignment::value) {
+      node_alloc_ = std::move(other.node_alloc_);
+    }
 
     root_ = other.root_;
     nil_ = other.nil_;
     size_ = other.size_;
+    pool_.swap(other.pool_);
 
     other.root_ = nullptr;
     other.nil_ = nullptr;
@@ -73,23 +143,38 @@ multiset<Key>& multiset<Key>::operator=(multiset&& other) noexcept {
 
 // ==================== ВСПОМОГАТЕЛЬНЫЕ МЕТОДЫ ====================
 
-template <typename Key>
-void multiset<Key>::initialize_nil() {
-  nil_ = new Node(value_type{}, nullptr, false);  // черный узел
+template <typename Key, typename Allocator, typename Compare>
+void multiset<Key, Allocator, Compare>::initialize_nil() {
+  // nil_ живет вне пула, чтобы clear() мог отдать все слабы
+  nil_ = node_traits::allocate(node_alloc_, 1);
+  try {
+    node_traits::construct(node_alloc_, nil_, value_type{}, nullptr,
+                           false);  // черный узел
+  } catch (...) {
+    node_traits::deallocate(node_alloc_, nil_, 1);
+    throw;
+  }
   nil_->left = nil_;
   nil_->right = nil_;
   nil_->parent = nil_;
 }
 
-template <typename Key>
-void multiset<Key>::copy_tree(const multiset& other) {
+template <typename Key, typename Allocator, typename Compare>
+void multiset<Key, Allocator, Compare>::destroy_nil() {
+  node_traits::destroy(node_alloc_, nil_);
+  node_traits::deallocate(node_alloc_, nil_, 1);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+void multiset<Key, Allocator, Compare>::copy_tree(const multiset& other) {
   if (other.root_ != other.nil_) {
     // Рекурсивное копирование дерева
     auto copy_recursive = [&](auto& self, Node* other_node,
                               Node* parent) -> Node* {
       if (other_node == other.nil_) return nil_;
 
-      Node* new_node = new Node(other_node->value, parent, other_node->color);
+      Node* new_node =
+          create_node(other_node->value, parent, other_node->color);
       new_node->count = other_node->count;
       new_node->left = self(self, other_node->left, new_node);
       new_node->right = self(self, other_node->right, new_node);
@@ -101,98 +186,179 @@ void multiset<Key>::copy_tree(const multiset& other) {
   }
 }
 
-template <typename Key>
-void multiset<Key>::destroy_tree(Node* node) {
+template <typename Key, typename Allocator, typename Compare>
+void multiset<Key, Allocator, Compare>::destroy_tree(Node* node) {
   if (node && node != nil_) {
     destroy_tree(node->left);
     destroy_tree(node->right);
-    delete node;
+    // память узлов возвращает pool_.release()
+    node_traits::destroy(node_alloc_, node);
   }
 }
 
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::Node*
+multiset<Key, Allocator, Compare>::create_node(
+    const value_type& value, Node* parent, bool color) {
+  Node* node = pool_.allocate(node_alloc_);
+  try {
+    node_traits::construct(node_alloc_, node, value, parent, color);
+  } catch (...) {
+    pool_.deallocate(node);
+    throw;
+  }
+  return node;
+}
+
+template <typename Key, typename Allocator, typename Compare>
+void multiset<Key, Allocator, Compare>::destroy_node(Node* node) {
+  node_traits::destroy(node_alloc_, node);
+  pool_.deallocate(node);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::Node*
+multiset<Key, Allocator, Compare>::compact_subtree(
+    Node* node, Node* parent, node_pool<Node, node_allocator>& fresh) {
+  if (node == nil_) return nil_;
+
+  // левое поддерево раньше узла, чтобы узлы шли в памяти по порядку ключей
+  Node* left = compact_subtree(node->left, nil_, fresh);
+  Node* moved = fresh.allocate(node_alloc_);
+  node_traits::construct(node_alloc_, moved, std::move(node->value), parent,
+                         node->color);
+  moved->count = node->count;
+  moved->left = left;
+  if (left != nil_) left->parent = moved;
+  moved->right = compact_subtree(node->right, moved, fresh);
+
+  node_traits::destroy(node_alloc_, node);
+  return moved;
+}
+
 // ==================== ИТЕРАТОРЫ ====================
 
-template <typename Key>
-typename multiset<Key>::iterator multiset<Key>::begin() {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::iterator
+multiset<Key, Allocator, Compare>::begin() {
   return iterator(minimum(root_), this);
 }
 
-template <typename Key>
-typename multiset<Key>::iterator multiset<Key>::end() {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::iterator
+multiset<Key, Allocator, Compare>::end() {
   return iterator(nil_, this);
 }
 
-template <typename Key>
-typename multiset<Key>::const_iterator multiset<Key>::begin() const {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::const_iterator
+multiset<Key, Allocator, Compare>::begin() const {
   return const_iterator(minimum(root_), this);
 }
 
-template <typename Key>
-typename multiset<Key>::const_iterator multiset<Key>::end() const {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::const_iterator
+multiset<Key, Allocator, Compare>::end() const {
   return const_iterator(nil_, this);
 }
 
-template <typename Key>
-typename multiset<Key>::const_iterator multiset<Key>::cbegin() const {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::const_iterator
+multiset<Key, Allocator, Compare>::cbegin() const {
   return const_iterator(minimum(root_), this);
 }
 
-template <typename Key>
-typename multiset<Key>::const_iterator multiset<Key>::cend() const {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::const_iterator
+multiset<Key, Allocator, Compare>::cend() const {
   return const_iterator(nil_, this);
 }
 
 // ==================== ЕМКОСТЬ ====================
 
-template <typename Key>
-bool multiset<Key>::empty() const noexcept {
+template <typename Key, typename Allocator, typename Compare>
+bool multiset<Key, Allocator, Compare>::empty() const noexcept {
   return size_ == 0;
 }
 
-template <typename Key>
-typename multiset<Key>::size_type multiset<Key>::size() const noexcept {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::size_type
+multiset<Key, Allocator, Compare>::size() const noexcept {
   return size_;
 }
 
-template <typename Key>
-typename multiset<Key>::size_type multiset<Key>::max_size() const noexcept {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::size_type
+multiset<Key, Allocator, Compare>::max_size() const noexcept {
   return std::numeric_limits<size_type>::max() / sizeof(Node) / 2;
 }
 
 // ==================== МОДИФИКАТОРЫ ====================
 
-template <typename Key>
-void multiset<Key>::clear() {
-  destroy_tree(root_);
+template <typename Key, typename Allocator, typename Compare>
+void multiset<Key, Allocator, Compare>::clear() {
+  if constexpr (!std::is_trivially_destructible_v<Node>) {
+    destroy_tree(root_);
+  }
+  pool_.release(node_alloc_);
   root_ = nil_;
   size_ = 0;
 }
 
-template <typename Key>
-typename multiset<Key>::iterator multiset<Key>::insert(
-    const value_type& value) {
+template <typename Key, typename Allocator, typename Compare>
+void multiset<Key, Allocator, Compare>::compact()
+  requires std::is_nothrow_move_constructible_v<Key>
+{
+  if (size_ == 0) return;
+  node_pool<Node, node_allocator> fresh;
+  // после reserve перенос уже ничего не выделяет и не бросает
+  fresh.reserve(node_alloc_, size_);
+  root_ = compact_subtree(root_, nil_, fresh);
+  pool_.release(node_alloc_);
+  pool_.swap(fresh);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::iterator
+multiset<Key, Allocator, Compare>::insert(const value_type& value) {
+  Node* z = create_node(value, nil_, true);
+  link_node(z);
+  return iterator(z, this);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::iterator
+multiset<Key, Allocator, Compare>::insert(node_type&& nh) {
+  if (nh.empty()) return end();
+  // узел переходит в пул: в свободный узел или со своим слабом
+  Node* z = pool_.adopt_single(node_alloc_, nh.release());
+  link_node(z);
+  return iterator(z, this);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+void multiset<Key, Allocator, Compare>::link_node(Node* z) {
   Node* y = nil_;
   Node* x = root_;
 
   // Находим место для вставки
   while (x != nil_) {
     y = x;
-    if (value < x->value) {
+    if (comp_(z->value, x->value)) {
       x = x->left;
     } else {
       x = x->right;
     }
   }
 
-  // Создаем новый узел
-  Node* z = new Node(value, y);
+  // Вставляем узел
+  z->parent = y;
   z->left = nil_;
   z->right = nil_;
-
-  // Вставляем узел
+  z->color = true;
   if (y == nil_) {
     root_ = z;
-  } else if (value < y->value) {
+  } else if (comp_(z->value, y->value)) {
     y->left = z;
   } else {
     y->right = z;
@@ -201,14 +367,49 @@ typename multiset<Key>::iterator multiset<Key>::insert(
   // Балансировка
   insert_fixup(z);
   size_++;
-  return iterator(z, this);
 }
 
-template <typename Key>
-void multiset<Key>::erase(iterator pos) {
+template <typename Key, typename Allocator, typename Compare>
+void multiset<Key, Allocator, Compare>::erase(iterator pos) {
   if (pos.node_ == nil_ || pos.node_ == nullptr) return;
+  destroy_node(unlink_node(pos.node_));
+}
 
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::node_type
+multiset<Key, Allocator, Compare>::extract(const_iterator pos) {
+  if (pos.node_ == nil_ || pos.node_ == nullptr) return node_type();
+  // элемент переезжает в отдельный узел дескриптора, слабы остаются пулу
+  using pool_type = node_pool<Node, node_allocator>;
+  Node* detached = pool_type::allocate_single(node_alloc_);
   Node* z = pos.node_;
+  if constexpr (std::is_nothrow_move_constructible_v<Key>) {
+    unlink_node(z);
+    node_traits::construct(node_alloc_, detached, std::move(z->value), nil_,
+                           true);
+  } else {
+    try {
+      node_traits::construct(node_alloc_, detached, z->value, nil_, true);
+    } catch (...) {
+      pool_type::deallocate_single(node_alloc_, detached);
+      throw;
+    }
+    unlink_node(z);
+  }
+  detached->count = z->count;
+  destroy_node(z);
+  return node_type(detached, node_alloc_);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::node_type
+multiset<Key, Allocator, Compare>::extract(const Key& key) {
+  return extract(const_iterator(find_node(key), this));
+}
+
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::Node*
+multiset<Key, Allocator, Compare>::unlink_node(Node* z) {
   Node* y = z;
   Node* x = nullptr;
   bool y_original_color = y->color;
@@ -238,67 +439,93 @@ void multiset<Key>::erase(iterator pos) {
     y->color = z->color;
   }
 
-  delete z;
   size_--;
 
   if (y_original_color == false) {
     erase_fixup(x);
   }
+  return z;
 }
 
-template <typename Key>
-void multiset<Key>::swap(multiset& other) {
+template <typename Key, typename Allocator, typename Compare>
+void multiset<Key, Allocator, Compare>::swap(multiset& other) {
+  if constexpr (node_traits::propagate_on_container_swap::value) {
+    std::swap(node_alloc_, other.node_alloc_);
+  }
   std::swap(root_, other.root_);
   std::swap(nil_, other.nil_);
   std::swap(size_, other.size_);
+  std::swap(comp_, other.comp_);
+  pool_.swap(other.pool_);
 }
 
-template <typename Key>
-void multiset<Key>::merge(multiset& other) {
-  if (this == &other) return;
+template <typename Key, typename Allocator, typename Compare>
+void multiset<Key, Allocator, Compare>::merge(multiset& other) {
+  if (this == &other || other.size_ == 0) return;
 
-  // Собираем все элементы из other
-  std::vector<value_type> elements;
-  for (auto it = other.begin(); it != other.end(); ++it) {
-    elements.push_back(*it);
+  if (node_alloc_ == other.node_alloc_) {
+    // слабы other со всеми узлами переходят сюда, узлы перевешиваются
+    pool_.adopt(other.pool_);
+    Node* other_root = other.root_;
+    other.root_ = other.nil_;
+    other.size_ = 0;
+    relink_subtree(other_root, other.nil_);
+    return;
   }
 
-  // Очищаем other
+  for (auto it = other.begin(); it != other.end(); ++it) {
+    insert(*it);
+  }
   other.clear();
+}
 
-  // Вставляем элементы в текущий multiset
-  for (const auto& elem : elements) {
-    insert(elem);
-  }
+template <typename Key, typename Allocator, typename Compare>
+void multiset<Key, Allocator, Compare>::relink_subtree(Node* node,
+                                                       Node* other_nil) {
+  if (node == other_nil) return;
+  // по порядку ключей, чтобы равные сохранили взаимный порядок
+  Node* right = node->right;
+  relink_subtree(node->left, other_nil);
+  link_node(node);
+  relink_subtree(right, other_nil);
 }
 
 // ==================== ПОИСК ====================
 
-template <typename Key>
-typename multiset<Key>::iterator multiset<Key>::find(const Key& key) {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::iterator
+multiset<Key, Allocator, Compare>::find(const Key& key) {
   Node* node = find_node(key);
   return iterator(node == nil_ ? nil_ : node, this);
 }
 
-template <typename Key>
-typename multiset<Key>::const_iterator multiset<Key>::find(
-    const Key& key) const {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::const_iterator
+multiset<Key, Allocator, Compare>::find(const Key& key) const {
   Node* node = find_node(key);
   return const_iterator(node == nil_ ? nil_ : node, this);
 }
 
-template <typename Key>
-bool multiset<Key>::contains(const Key& key) const {
+template <typename Key, typename Allocator, typename Compare>
+bool multiset<Key, Allocator, Compare>::contains(const Key& key) const {
   return find_node(key) != nil_;
 }
 
-template <typename Key>
-typename multiset<Key>::size_type multiset<Key>::count(const Key& key) const {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::size_type
+multiset<Key, Allocator, Compare>::count(const Key& key) const {
+  return count_nodes(key);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+template <typename K>
+typename multiset<Key, Allocator, Compare>::size_type
+multiset<Key, Allocator, Compare>::count_nodes(const K& key) const {
   size_type cnt = 0;
   Node* current = lower_bound_node(key);
 
-  while (current != nil_ && !(key < current->value) &&
-         !(current->value < key)) {
+  // после lower_bound current->value >= key, равенство - это !(key < value)
+  while (current != nil_ && !comp_(key, current->value)) {
     cnt += current->count;
     // Переходим к следующему узлу с тем же ключом
     if (current->right != nil_) {
@@ -316,47 +543,51 @@ typename multiset<Key>::size_type multiset<Key>::count(const Key& key) const {
   return cnt;
 }
 
-template <typename Key>
-typename multiset<Key>::iterator multiset<Key>::lower_bound(const Key& key) {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::iterator
+multiset<Key, Allocator, Compare>::lower_bound(const Key& key) {
   return iterator(lower_bound_node(key), this);
 }
 
-template <typename Key>
-typename multiset<Key>::const_iterator multiset<Key>::lower_bound(
-    const Key& key) const {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::const_iterator
+multiset<Key, Allocator, Compare>::lower_bound(const Key& key) const {
   return const_iterator(lower_bound_node(key), this);
 }
 
-template <typename Key>
-typename multiset<Key>::iterator multiset<Key>::upper_bound(const Key& key) {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::iterator
+multiset<Key, Allocator, Compare>::upper_bound(const Key& key) {
   return iterator(upper_bound_node(key), this);
 }
 
-template <typename Key>
-typename multiset<Key>::const_iterator multiset<Key>::upper_bound(
-    const Key& key) const {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::const_iterator
+multiset<Key, Allocator, Compare>::upper_bound(const Key& key) const {
   return const_iterator(upper_bound_node(key), this);
 }
 
-template <typename Key>
-std::pair<typename multiset<Key>::iterator, typename multiset<Key>::iterator>
-multiset<Key>::equal_range(const Key& key) {
+template <typename Key, typename Allocator, typename Compare>
+std::pair<typename multiset<Key, Allocator, Compare>::iterator,
+          typename multiset<Key, Allocator, Compare>::iterator>
+multiset<Key, Allocator, Compare>::equal_range(const Key& key) {
   return std::make_pair(lower_bound(key), upper_bound(key));
 }
 
-template <typename Key>
-std::pair<typename multiset<Key>::const_iterator,
-          typename multiset<Key>::const_iterator>
-multiset<Key>::equal_range(const Key& key) const {
+template <typename Key, typename Allocator, typename Compare>
+std::pair<typename multiset<Key, Allocator, Compare>::const_iterator,
+          typename multiset<Key, Allocator, Compare>::const_iterator>
+multiset<Key, Allocator, Compare>::equal_range(const Key& key) const {
   return std::make_pair(lower_bound(key), upper_bound(key));
 }
 
 // ==================== INSERT_MANY (ТРЕБОВАНИЕ ИЗ ЗАДАНИЯ) ====================
 
-template <typename Key>
+template <typename Key, typename Allocator, typename Compare>
 template <typename... Args>
-std::vector<std::pair<typename multiset<Key>::iterator, bool>>
-multiset<Key>::insert_many(Args&&... args) {
+std::vector<
+    std::pair<typename multiset<Key, Allocator, Compare>::iterator, bool>>
+multiset<Key, Allocator, Compare>::insert_many(Args&&... args) {
   std::vector<std::pair<iterator, bool>> results;
   results.reserve(sizeof...(Args));
 
@@ -374,8 +605,9 @@ multiset<Key>::insert_many(Args&&... args) {
 
 // ==================== ПРИВАТНЫЕ ВСПОМОГАТЕЛЬНЫЕ МЕТОДЫ ====================
 
-template <typename Key>
-typename multiset<Key>::Node* multiset<Key>::minimum(Node* node) const {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::Node*
+multiset<Key, Allocator, Compare>::minimum(Node* node) const {
   if (node == nil_ || node == nullptr) return nil_;
   while (node->left != nil_) {
     node = node->left;
@@ -383,8 +615,9 @@ typename multiset<Key>::Node* multiset<Key>::minimum(Node* node) const {
   return node;
 }
 
-template <typename Key>
-typename multiset<Key>::Node* multiset<Key>::maximum(Node* node) const {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::Node*
+multiset<Key, Allocator, Compare>::maximum(Node* node) const {
   if (node == nil_ || node == nullptr) return nil_;
   while (node->right != nil_) {
     node = node->right;
@@ -392,13 +625,15 @@ typename multiset<Key>::Node* multiset<Key>::maximum(Node* node) const {
   return node;
 }
 
-template <typename Key>
-typename multiset<Key>::Node* multiset<Key>::find_node(const Key& key) const {
+template <typename Key, typename Allocator, typename Compare>
+template <typename K>
+typename multiset<Key, Allocator, Compare>::Node*
+multiset<Key, Allocator, Compare>::find_node(const K& key) const {
   Node* current = root_;
   while (current != nil_) {
-    if (key < current->value) {
+    if (comp_(key, current->value)) {
       current = current->left;
-    } else if (current->value < key) {
+    } else if (comp_(current->value, key)) {
       current = current->right;
     } else {
       return current;  // Найден
@@ -407,14 +642,15 @@ typename multiset<Key>::Node* multiset<Key>::find_node(const Key& key) const {
   return nil_;  // Не найден
 }
 
-template <typename Key>
-typename multiset<Key>::Node* multiset<Key>::lower_bound_node(
-    const Key& key) const {
+template <typename Key, typename Allocator, typename Compare>
+template <typename K>
+typename multiset<Key, Allocator, Compare>::Node*
+multiset<Key, Allocator, Compare>::lower_bound_node(const K& key) const {
   Node* current = root_;
   Node* result = nil_;
 
   while (current != nil_) {
-    if (!(current->value < key)) {  // current->value >= key
+    if (!comp_(current->value, key)) {  // current->value >= key
       result = current;
       current = current->left;
     } else {
@@ -425,14 +661,15 @@ typename multiset<Key>::Node* multiset<Key>::lower_bound_node(
   return result;
 }
 
-template <typename Key>
-typename multiset<Key>::Node* multiset<Key>::upper_bound_node(
-    const Key& key) const {
+template <typename Key, typename Allocator, typename Compare>
+template <typename K>
+typename multiset<Key, Allocator, Compare>::Node*
+multiset<Key, Allocator, Compare>::upper_bound_node(const K& key) const {
   Node* current = root_;
   Node* result = nil_;
 
   while (current != nil_) {
-    if (key < current->value) {  // current->value > key
+    if (comp_(key, current->value)) {  // current->value > key
       result = current;
       current = current->left;
     } else {
@@ -445,8 +682,8 @@ typename multiset<Key>::Node* multiset<Key>::upper_bound_node(
 
 // ==================== МЕТОДЫ КРАСНО-ЧЕРНОГО ДЕРЕВА ====================
 
-template <typename Key>
-void multiset<Key>::rotate_left(Node* x) {
+template <typename Key, typename Allocator, typename Compare>
+void multiset<Key, Allocator, Compare>::rotate_left(Node* x) {
   Node* y = x->right;
   x->right = y->left;
 
@@ -468,8 +705,8 @@ void multiset<Key>::rotate_left(Node* x) {
   x->parent = y;
 }
 
-template <typename Key>
-void multiset<Key>::rotate_right(Node* y) {
+template <typename Key, typename Allocator, typename Compare>
+void multiset<Key, Allocator, Compare>::rotate_right(Node* y) {
   Node* x = y->left;
   y->left = x->right;
 
@@ -491,8 +728,8 @@ void multiset<Key>::rotate_right(Node* y) {
   y->parent = x;
 }
 
-template <typename Key>
-void multiset<Key>::insert_fixup(Node* z) {
+template <typename Key, typename Allocator, typename Compare>
+void multiset<Key, Allocator, Compare>::insert_fixup(Node* z) {
   while (z->parent->color == true) {  // Пока родитель красный
     if (z->parent == z->parent->parent->left) {
       Node* y = z->parent->parent->right;  // Дядя
@@ -534,8 +771,8 @@ void multiset<Key>::insert_fixup(Node* z) {
   root_->color = false;  // Корень всегда черный
 }
 
-template <typename Key>
-void multiset<Key>::transplant(Node* u, Node* v) {
+template <typename Key, typename Allocator, typename Compare>
+void multiset<Key, Allocator, Compare>::transplant(Node* u, Node* v) {
   if (u->parent == nil_) {
     root_ = v;
   } else if (u == u->parent->left) {
@@ -546,8 +783,8 @@ void multiset<Key>::transplant(Node* u, Node* v) {
   v->parent = u->parent;
 }
 
-template <typename Key>
-void multiset<Key>::erase_fixup(Node* x) {
+template <typename Key, typename Allocator, typename Compare>
+void multiset<Key, Allocator, Compare>::erase_fixup(Node* x) {
   while (x != root_ && x->color == false) {
     if (x == x->parent->left) {
       Node* w = x->parent->right;
@@ -609,8 +846,9 @@ void multiset<Key>::erase_fixup(Node* x) {
 
 // ==================== МЕТОДЫ ИТЕРАТОРА ====================
 
-template <typename Key>
-typename multiset<Key>::iterator& multiset<Key>::iterator::operator++() {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::iterator&
+multiset<Key, Allocator, Compare>::iterator::operator++() {
   if (node_ == nullptr || node_ == container_->nil_) return *this;
 
   if (node_->right != container_->nil_) {
@@ -628,15 +866,17 @@ typename multiset<Key>::iterator& multiset<Key>::iterator::operator++() {
   return *this;
 }
 
-template <typename Key>
-typename multiset<Key>::iterator multiset<Key>::iterator::operator++(int) {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::iterator
+multiset<Key, Allocator, Compare>::iterator::operator++(int) {
   iterator temp = *this;
   ++(*this);
   return temp;
 }
 
-template <typename Key>
-typename multiset<Key>::iterator& multiset<Key>::iterator::operator--() {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::iterator&
+multiset<Key, Allocator, Compare>::iterator::operator--() {
   if (node_ == nullptr) return *this;
 
   if (node_ == container_->nil_) {
@@ -657,17 +897,18 @@ typename multiset<Key>::iterator& multiset<Key>::iterator::operator--() {
   return *this;
 }
 
-template <typename Key>
-typename multiset<Key>::iterator multiset<Key>::iterator::operator--(int) {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::iterator
+multiset<Key, Allocator, Compare>::iterator::operator--(int) {
   iterator temp = *this;
   --(*this);
   return temp;
 }
 
 // Аналогичные методы для const_iterator
-template <typename Key>
-typename multiset<Key>::const_iterator&
-multiset<Key>::const_iterator::operator++() {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::const_iterator&
+multiset<Key, Allocator, Compare>::const_iterator::operator++() {
   if (node_ == nullptr || node_ == container_->nil_) return *this;
 
   if (node_->right != container_->nil_) {
@@ -683,17 +924,17 @@ multiset<Key>::const_iterator::operator++() {
   return *this;
 }
 
-template <typename Key>
-typename multiset<Key>::const_iterator
-multiset<Key>::const_iterator::operator++(int) {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::const_iterator
+multiset<Key, Allocator, Compare>::const_iterator::operator++(int) {
   const_iterator temp = *this;
   ++(*this);
   return temp;
 }
 
-template <typename Key>
-typename multiset<Key>::const_iterator&
-multiset<Key>::const_iterator::operator--() {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::const_iterator&
+multiset<Key, Allocator, Compare>::const_iterator::operator--() {
   if (node_ == nullptr) return *this;
 
   if (node_ == container_->nil_) {
@@ -711,9 +952,9 @@ multiset<Key>::const_iterator::operator--() {
   return *this;
 }
 
-template <typename Key>
-typename multiset<Key>::const_iterator
-multiset<Key>::const_iterator::operator--(int) {
+template <typename Key, typename Allocator, typename Compare>
+typename multiset<Key, Allocator, Compare>::const_iterator
+multiset<Key, Allocator, Compare>::const_iterator::operator--(int) {
   const_iterator temp = *this;
   --(*this);
   return temp;
@@ -0,0 +1,272 @@
+#ifndef S21_NODE_POOL_H
+#define S21_NODE_POOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace s21 {
+
+// Storage for the nodes of one node-based container. Nodes are carved from
+// slabs taken from the container's node allocator; a freed node goes on a
+// free list threaded through its own storage and is handed out again
+// before the slab is bumped. Slabs start at 16 nodes and double up to
+// about 64 KiB, so a small container stays small while a large one makes a
+// few dozen allocator calls instead of one per node, and nodes created one
+// after another sit next to each other.
+//
+// A pool owns its slabs alone: adopt() moves the slabs of another pool in
+// whole, and a node handed out by extract() moves to a slab of its own
+// (see node_handle) that the pool linking it takes over. Containers that
+// exchange nodes therefore share no storage and can live on different
+// threads.
+//
+// The pool does not keep the allocator: it is passed to every call and has
+// to be the one that allocated the slabs, i.e. the owning container's.
+// release() returns every slab at once and must be called by the owner
+// before the pool goes away, once the nodes in it are destroyed.
+template <typename Node, typename NodeAllocator>
+class node_pool {
+ public:
+  using size_type = std::size_t;
+
+  node_pool() = default;
+  node_pool(const node_pool&) = delete;
+  node_pool& operator=(const node_pool&) = delete;
+
+  node_pool(node_pool&& other) noexcept { swap(other); }
+
+  // uninitialized storage for one node
+  Node* allocate(NodeAllocator& alloc) {
+    if (free_) {
+      Node* node = free_;
+      free_ = free_slot_at(node)->next;
+      return node;
+    }
+    if (cursor_ == end_) grow(alloc, next_slab_nodes_);
+    return cursor_++;
+  }
+
+  // storage of a destroyed node, kept for the next allocate()
+  void deallocate(Node* node) noexcept {
+    ::new (static_cast<void*>(node)) free_slot{free_};
+    free_ = node;
+  }
+
+  // makes the next n allocate() calls succeed without the allocator; on a
+  // pool with no freed nodes they take consecutive nodes of one slab
+  void reserve(NodeAllocator& alloc, size_type n) {
+    if (static_cast<size_type>(end_ - cursor_) < n) {
+      grow(alloc, std::max(n + 1, next_slab_nodes_));
+    }
+  }
+
+  // returns every slab to alloc; nodes still in them are not destroyed
+  void release(NodeAllocator& alloc) noexcept {
+    while (slabs_) {
+      Node* slab = slabs_;
+      slab_header* header = header_at(slab);
+      slabs_ = header->next;
+      size_type nodes = header->nodes;
+      node_traits::deallocate(alloc, slab, nodes);
+    }
+    free_ = nullptr;
+    cursor_ = end_ = nullptr;
+    next_slab_nodes_ = first_slab_nodes;
+  }
+
+  // takes over the slabs of other, whose nodes now belong to this pool
+  // (both pools must use equal allocators); the slabs stay here until
+  // release() even when their nodes are freed, and other grows new ones
+  void adopt(node_pool& other) noexcept {
+    if (!other.slabs_) return;
+    Node* last = other.slabs_;
+    while (header_at(last)->next) last = header_at(last)->next;
+    header_at(last)->next = slabs_;
+    slabs_ = other.slabs_;
+
+    while (other.free_) {
+      Node* node = other.free_;
+      other.free_ = free_slot_at(node)->next;
+      deallocate(node);
+    }
+    // keep bumping the larger unused tail, the other one goes on the list
+    if (other.end_ - other.cursor_ > end_ - cursor_) {
+      std::swap(cursor_, other.cursor_);
+      std::swap(end_, other.end_);
+    }
+    while (other.cursor_ != other.end_) deallocate(other.cursor_++);
+    next_slab_nodes_ = std::max(next_slab_nodes_, other.next_slab_nodes_);
+    other.slabs_ = other.free_ = other.cursor_ = other.end_ = nullptr;
+    other.next_slab_nodes_ = first_slab_nodes;
+  }
+
+  // storage for one node outside every pool, for a node handle: a slab of
+  // two nodes whose first one holds the header, so that adopt_single() can
+  // link it into any pool
+  static Node* allocate_single(NodeAllocator& alloc) {
+    Node* slab = node_traits::allocate(alloc, 2);
+    ::new (static_cast<void*>(slab)) slab_header{nullptr, 2};
+    return slab + 1;
+  }
+
+  static void deallocate_single(NodeAllocator& alloc, Node* node) noexcept {
+    node_traits::deallocate(alloc, node - 1, 2);
+  }
+
+  // takes over a node from allocate_single() that is to be linked here and
+  // returns where it now is: the node moves into a freed node of the pool
+  // when there is one, so that extract() and insert() in a loop do not
+  // pile up slabs, otherwise the pool keeps the node's own slab
+  Node* adopt_single(NodeAllocator& alloc, Node* node) noexcept {
+    if constexpr (std::is_nothrow_move_constructible_v<Node>) {
+      if (free_) {
+        Node* target = free_;
+        free_ = free_slot_at(target)->next;
+        node_traits::construct(alloc, target, std::move(*node));
+        node_traits::destroy(alloc, node);
+        deallocate_single(alloc, node);
+        return target;
+      }
+    }
+    Node* slab = node - 1;
+    header_at(slab)->next = slabs_;
+    slabs_ = slab;
+    return node;
+  }
+
+  void swap(node_pool& other) noexcept {
+    std::swap(slabs_, other.slabs_);
+    std::swap(free_, other.free_);
+    std::swap(cursor_, other.cursor_);
+    std::swap(end_, other.end_);
+    std::swap(next_slab_nodes_, other.next_slab_nodes_);
+  }
+
+ private:
+  using node_traits = std::allocator_traits<NodeAllocator>;
+
+  // the first node of every slab links the slabs together
+  struct slab_header {
+    Node* next;
+    size_type nodes;
+  };
+  struct free_slot {
+    Node* next;
+  };
+
+  static_assert(sizeof(Node) >= sizeof(slab_header) &&
+                    alignof(Node) >= alignof(slab_header),
+                "node_pool keeps its bookkeeping inside the nodes");
+
+  static constexpr size_type first_slab_nodes = 16;
+  static constexpr size_type max_slab_nodes =
+      std::max<size_type>(first_slab_nodes, (size_type{64} << 10) /
+                                                sizeof(Node));
+
+  Node* slabs_ = nullptr;
+  Node* free_ = nullptr;
+  Node* cursor_ = nullptr;
+  Node* end_ = nullptr;
+  size_type next_slab_nodes_ = first_slab_nodes;
+
+  static slab_header* header_at(Node* slab) {
+    return std::launder(reinterpret_cast<slab_header*>(slab));
+  }
+  static free_slot* free_slot_at(Node* node) {
+    return std::launder(reinterpret_cast<free_slot*>(node));
+  }
+
+  void grow(NodeAllocator& alloc, size_type nodes) {
+    Node* slab = node_traits::allocate(alloc, nodes);
+    ::new (static_cast<void*>(slab)) slab_header{slabs_, nodes};
+    slabs_ = slab;
+    // what reserve() leaves of the current slab is still handed out
+    while (cursor_ != end_) deallocate(cursor_++);
+    cursor_ = slab + 1;
+    end_ = slab + nodes;
+    next_slab_nodes_ = std::min(max_slab_nodes, nodes * 2);
+  }
+};
+
+// Owner of a node taken out of its container by extract(), as the node
+// handles of the standard containers. extract() moves the element into a
+// node of its own from node_pool::allocate_single(), so the handle does not
+// depend on the container it came from, and insert() links it without
+// allocating, in a freed node of the receiving pool or in its own slab,
+// which then belongs to that pool. A node
+// never linked again is destroyed and freed with the handle. Containers
+// derive from it to add key(), mapped() or value().
+template <typename Node, typename NodeAllocator, typename Allocator>
+class node_handle {
+ public:
+  using allocator_type = Allocator;
+
+  constexpr node_handle() noexcept = default;
+  node_handle(const node_handle&) = delete;
+  node_handle& operator=(const node_handle&) = delete;
+
+  node_handle(node_handle&& other) noexcept { swap(other); }
+
+  node_handle& operator=(node_handle&& other) noexcept {
+    if (this != &other) {
+      reset();
+      swap(other);
+    }
+    return *this;
+  }
+
+  ~node_handle() { reset(); }
+
+  [[nodiscard]] bool empty() const noexcept { return node_ == nullptr; }
+  explicit operator bool() const noexcept { return node_ != nullptr; }
+
+  allocator_type get_allocator() const { return allocator_type(*alloc_); }
+
+  void swap(node_handle& other) noexcept {
+    std::swap(node_, other.node_);
+    // allocators such as polymorphic_allocator cannot be assigned
+    std::optional<NodeAllocator> alloc;
+    if (alloc_) alloc.emplace(std::move(*alloc_));
+    alloc_.reset();
+    if (other.alloc_) alloc_.emplace(std::move(*other.alloc_));
+    other.alloc_.reset();
+    if (alloc) other.alloc_.emplace(std::move(*alloc));
+  }
+
+ protected:
+  using pool_type = node_pool<Node, NodeAllocator>;
+  using node_traits = std::allocator_traits<NodeAllocator>;
+
+  // node comes from pool_type::allocate_single(alloc)
+  node_handle(Node* node, const NodeAllocator& alloc)
+      : node_(node), alloc_(alloc) {}
+
+  // gives up the node to the container linking it, which adopts its slab
+  Node* release() noexcept {
+    Node* node = node_;
+    node_ = nullptr;
+    alloc_.reset();
+    return node;
+  }
+
+  Node* node_ = nullptr;
+  std::optional<NodeAllocator> alloc_;
+
+ private:
+  void reset() noexcept {
+    if (!node_) return;
+    node_traits::destroy(*alloc_, node_);
+    pool_type::deallocate_single(*alloc_, node_);
+    node_ = nullptr;
+    alloc_.reset();
+  }
+};
+
+}  // namespace s21
+
+#endif
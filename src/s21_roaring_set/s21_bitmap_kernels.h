@@ -0,0 +1,94 @@
+#ifndef S21_BITMAP_KERNELS_H
+#define S21_BITMAP_KERNELS_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "../s21_set/s21_lower_bound.h"
+
+namespace s21 {
+
+// Word-wise boolean operations on bitmaps that also count the bits set in
+// the result, so a combined roaring chunk knows its cardinality without a
+// second pass. Blocks of four words go through AVX2 when the CPU has it
+// (detected at run time, as for branchless_lower_bound), one word at a
+// time with a scalar popcount everywhere else.
+namespace bitmap_kernels {
+
+enum class word_op { and_op, or_op, xor_op, and_not_op };
+
+template <word_op Op>
+std::uint64_t apply(std::uint64_t a, std::uint64_t b) {
+  if constexpr (Op == word_op::and_op) {
+    return a & b;
+  } else if constexpr (Op == word_op::or_op) {
+    return a | b;
+  } else if constexpr (Op == word_op::xor_op) {
+    return a ^ b;
+  } else {
+    return a & ~b;
+  }
+}
+
+template <word_op Op>
+std::size_t combine_words_scalar(const std::uint64_t* a,
+                                 const std::uint64_t* b, std::uint64_t* out,
+                                 std::size_t n) {
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    out[i] = apply<Op>(a[i], b[i]);
+    count += static_cast<std::size_t>(std::popcount(out[i]));
+  }
+  return count;
+}
+
+#if defined(S21_LOWER_BOUND_X86) && defined(__GNUC__)
+
+// n must be a multiple of 4
+template <word_op Op>
+__attribute__((target("avx2,popcnt"))) std::size_t combine_words_avx2(
+    const std::uint64_t* a, const std::uint64_t* b, std::uint64_t* out,
+    std::size_t n) {
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < n; i += 4) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    __m256i r;
+    if constexpr (Op == word_op::and_op) {
+      r = _mm256_and_si256(x, y);
+    } else if constexpr (Op == word_op::or_op) {
+      r = _mm256_or_si256(x, y);
+    } else if constexpr (Op == word_op::xor_op) {
+      r = _mm256_xor_si256(x, y);
+    } else {
+      r = _mm256_andnot_si256(y, x);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), r);
+    count += static_cast<std::size_t>(
+        _mm_popcnt_u64(out[i]) + _mm_popcnt_u64(out[i + 1]) +
+        _mm_popcnt_u64(out[i + 2]) + _mm_popcnt_u64(out[i + 3]));
+  }
+  return count;
+}
+
+#endif
+
+// out may alias a or b
+template <word_op Op>
+std::size_t combine_words(const std::uint64_t* a, const std::uint64_t* b,
+                          std::uint64_t* out, std::size_t n) {
+#if defined(S21_LOWER_BOUND_X86) && defined(__GNUC__)
+  if (n % 4 == 0 && lower_bound_kernels::detected_simd_level() ==
+                        lower_bound_kernels::simd_level::avx2) {
+    return combine_words_avx2<Op>(a, b, out, n);
+  }
+#endif
+  return combine_words_scalar<Op>(a, b, out, n);
+}
+
+}  // namespace bitmap_kernels
+
+}  // namespace s21
+
+#endif
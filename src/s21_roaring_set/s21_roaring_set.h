@@ -0,0 +1,269 @@
+#ifndef S21_ROARING_SET_H
+#define S21_ROARING_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+#include "../s21_vector/s21_vector.h"
+#include "s21_bitmap_kernels.h"
+
+namespace s21 {
+
+// Set of 32-bit unsigned integers stored as a roaring bitmap, with the
+// interface of s21::set. A key is split into its high and low 16 bits;
+// every high half present owns a chunk holding the low halves as
+//  - an array of sorted values, while the chunk has at most 4096 keys;
+//  - a bitmap of 65536 bits (8 KB) once it has more;
+//  - sorted [first, last] runs, made by run_optimize() for chunks where
+//    they take less space than either of the above.
+// Dense ids cost about one bit each instead of four bytes. Set algebra
+// works a chunk at a time: bitmaps word by word with popcount (AVX2 when
+// the CPU has it), arrays by merging and arrays against bitmaps by bit
+// tests. Iterators are invalidated by every modification.
+template <typename Allocator = std::allocator<std::uint32_t>>
+class roaring_set {
+ public:
+  class RoaringIterator;
+
+  using key_type = std::uint32_t;
+  using value_type = std::uint32_t;
+  using allocator_type = Allocator;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
+  using iterator = RoaringIterator;
+  using const_iterator = RoaringIterator;
+  using size_type = std::size_t;
+
+  roaring_set();
+  explicit roaring_set(const Allocator& alloc);
+  roaring_set(std::initializer_list<value_type> const& items);
+  // Bulk construction: the keys are sorted once and every chunk is built
+  // in its final form, O(n log n) overall.
+  template <std::input_iterator InputIt>
+  roaring_set(InputIt first, InputIt last,
+              const Allocator& alloc = Allocator());
+  roaring_set(const roaring_set& s);
+  roaring_set(const roaring_set& s, const Allocator& alloc);
+  roaring_set(roaring_set&& s) noexcept;
+  ~roaring_set();
+  roaring_set& operator=(const roaring_set& s);
+  // With allocators that neither propagate nor always compare equal, a
+  // set on another resource is copied chunk by chunk instead of stolen.
+  roaring_set& operator=(roaring_set&& s) noexcept(nothrow_move_assign);
+
+  allocator_type get_allocator() const;
+
+  iterator begin() const;
+  iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+
+  void clear();
+  std::pair<iterator, bool> insert(value_type value);
+  void erase(iterator pos);
+  size_type erase(value_type key);
+  void swap(roaring_set& other);
+  void merge(roaring_set& other);
+
+  iterator find(value_type key) const;
+  bool contains(value_type key) const;
+  size_type count(value_type key) const;
+  iterator lower_bound(value_type key) const;
+  iterator upper_bound(value_type key) const;
+
+  template <typename... Args>
+  s21::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
+
+  // Converts every chunk that is smaller as runs of consecutive keys, e.g.
+  // after loading ranges of ids. Chunks left as runs turn back into arrays
+  // or bitmaps once edits make runs the larger form.
+  void run_optimize();
+  // Bytes held by the set, its buffers included.
+  size_type memory_usage() const;
+
+  template <typename A>
+  friend roaring_set<A> set_union(const roaring_set<A>& a,
+                                  const roaring_set<A>& b);
+  template <typename A>
+  friend roaring_set<A> set_intersection(const roaring_set<A>& a,
+                                         const roaring_set<A>& b);
+  template <typename A>
+  friend roaring_set<A> set_difference(const roaring_set<A>& a,
+                                       const roaring_set<A>& b);
+  template <typename A>
+  friend roaring_set<A> set_symmetric_difference(const roaring_set<A>& a,
+                                                 const roaring_set<A>& b);
+
+ private:
+  using alloc_traits = std::allocator_traits<Allocator>;
+
+  static constexpr bool nothrow_move_assign =
+      alloc_traits::propagate_on_container_move_assignment::value ||
+      alloc_traits::is_always_equal::value;
+  template <typename T>
+  using storage_of =
+      s21::vector<T, typename alloc_traits::template rebind_alloc<T>>;
+  using low_storage = storage_of<std::uint16_t>;
+  using word_storage = storage_of<std::uint64_t>;
+  using word_op = bitmap_kernels::word_op;
+
+  enum class chunk_kind : std::uint8_t { array, bitmap, runs };
+
+  static constexpr size_type array_max = 4096;
+  static constexpr size_type bitmap_words = 1024;
+  static constexpr size_type bitmap_bytes = bitmap_words * 8;
+
+  // The keys whose high half is key. An array keeps its sorted low halves
+  // in values, runs keep first/last pairs there; a bitmap uses words. The
+  // allocator is passed explicitly so copies stay on the set's resource.
+  struct chunk {
+    std::uint16_t key;
+    chunk_kind kind;
+    std::uint32_t cardinality;
+    low_storage values;
+    word_storage words;
+
+    chunk(std::uint16_t k, const Allocator& alloc)
+        : key(k),
+          kind(chunk_kind::array),
+          cardinality(0),
+          values(alloc),
+          words(alloc) {}
+    chunk(const chunk& other, const Allocator& alloc)
+        : key(other.key),
+          kind(other.kind),
+          cardinality(other.cardinality),
+          values(other.values, alloc),
+          words(other.words, alloc) {}
+    chunk(const chunk&) = delete;
+    chunk(chunk&&) noexcept = default;
+    chunk& operator=(const chunk&) = delete;
+    chunk& operator=(chunk&&) noexcept = default;
+  };
+
+  using chunk_storage = storage_of<chunk>;
+
+  chunk_storage chunks_;
+  size_type size_ = 0;
+
+  static value_type compose(std::uint16_t high, std::uint16_t low) {
+    return (value_type(high) << 16) | low;
+  }
+  size_type chunk_rank(std::uint16_t high) const;
+  void copy_chunks(const roaring_set& other);
+
+  // Positions inside a chunk: the array index, the run index, unused for
+  // bitmaps; low is the low half of the key there.
+  static void chunk_first(const chunk& c, size_type& pos, std::uint16_t& low);
+  static void chunk_last(const chunk& c, size_type& pos, std::uint16_t& low);
+  static bool chunk_next(const chunk& c, size_type& pos, std::uint16_t& low);
+  static bool chunk_prev(const chunk& c, size_type& pos, std::uint16_t& low);
+  static bool chunk_lower_bound(const chunk& c, std::uint16_t key,
+                                size_type& pos, std::uint16_t& low);
+  static bool chunk_contains(const chunk& c, std::uint16_t low);
+  static size_type run_index(const chunk& c, std::uint16_t low);
+
+  static bool chunk_insert(chunk& c, std::uint16_t low);
+  static bool chunk_erase(chunk& c, std::uint16_t low);
+  static void to_bitmap(chunk& c);
+  static void to_array(chunk& c);
+  static void to_runs(chunk& c, size_type runs);
+  static void settle(chunk& c);
+  static size_type count_runs(const chunk& c);
+  static size_type plain_bytes(size_type cardinality);
+  static void set_bits(word_storage& words, std::uint16_t first,
+                       std::uint16_t last);
+
+  template <word_op Op>
+  static roaring_set combine(const roaring_set& a, const roaring_set& b);
+  template <word_op Op>
+  static void combine_chunks(const chunk& a, const chunk& b, chunk& out);
+  template <word_op Op>
+  static void merge_arrays(const low_storage& a, const low_storage& b,
+                           chunk& out);
+  template <word_op Op>
+  static void filter_array(const low_storage& values, const chunk& bitmap,
+                           bool in_first, chunk& out);
+};
+
+template <typename Allocator>
+class roaring_set<Allocator>::RoaringIterator {
+ private:
+  const roaring_set* set_;
+  size_type chunk_;
+  size_type pos_;
+  std::uint32_t value_;
+  friend class roaring_set<Allocator>;
+
+  RoaringIterator(const roaring_set* set, size_type chunk, size_type pos,
+                  std::uint32_t value)
+      : set_(set), chunk_(chunk), pos_(pos), value_(value) {}
+
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = std::uint32_t;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const value_type*;
+  using reference = const value_type&;
+
+  RoaringIterator() : set_(nullptr), chunk_(0), pos_(0), value_(0) {}
+
+  const value_type& operator*() const { return value_; }
+
+  RoaringIterator& operator++();
+  RoaringIterator& operator--();
+
+  RoaringIterator operator++(int) {
+    RoaringIterator temp = *this;
+    ++*this;
+    return temp;
+  }
+
+  RoaringIterator operator--(int) {
+    RoaringIterator temp = *this;
+    --*this;
+    return temp;
+  }
+
+  bool operator==(const RoaringIterator& other) const {
+    return chunk_ == other.chunk_ && value_ == other.value_;
+  }
+
+  bool operator!=(const RoaringIterator& other) const {
+    return !(*this == other);
+  }
+};
+
+// Set algebra a chunk at a time; the result uses the allocator of a.
+template <typename Allocator>
+roaring_set<Allocator> set_union(const roaring_set<Allocator>& a,
+                                 const roaring_set<Allocator>& b);
+template <typename Allocator>
+roaring_set<Allocator> set_intersection(const roaring_set<Allocator>& a,
+                                        const roaring_set<Allocator>& b);
+template <typename Allocator>
+roaring_set<Allocator> set_difference(const roaring_set<Allocator>& a,
+                                      const roaring_set<Allocator>& b);
+template <typename Allocator>
+roaring_set<Allocator> set_symmetric_difference(
+    const roaring_set<Allocator>& a, const roaring_set<Allocator>& b);
+
+namespace pmr {
+
+using roaring_set =
+    s21::roaring_set<std::pmr::polymorphic_allocator<std::uint32_t>>;
+
+}  // namespace pmr
+
+}  // namespace s21
+
+#include "s21_roaring_set.tpp"
+
+#endif
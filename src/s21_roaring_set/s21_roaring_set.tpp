@@ -0,0 +1,962 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+
+#include "s21_roaring_set.h"
+
+namespace s21 {
+
+template <typename Allocator>
+roaring_set<Allocator>::roaring_set() : chunks_() {}
+
+template <typename Allocator>
+roaring_set<Allocator>::roaring_set(const Allocator& alloc) : chunks_(alloc) {}
+
+template <typename Allocator>
+roaring_set<Allocator>::roaring_set(
+    std::initializer_list<value_type> const& items)
+    : roaring_set(items.begin(), items.end()) {}
+
+template <typename Allocator>
+template <std::input_iterator InputIt>
+roaring_set<Allocator>::roaring_set(InputIt first, InputIt last,
+                                    const Allocator& alloc)
+    : chunks_(alloc) {
+  s21::vector<value_type, Allocator> keys(alloc);
+  keys.assign(first, last);
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+  size_type i = 0;
+  while (i < keys.size()) {
+    std::uint16_t high = static_cast<std::uint16_t>(keys[i] >> 16);
+    size_type stop = i;
+    while (stop < keys.size() && (keys[stop] >> 16) == high) {
+      ++stop;
+    }
+    chunk c(high, alloc);
+    c.cardinality = static_cast<std::uint32_t>(stop - i);
+    if (c.cardinality > array_max) {
+      c.kind = chunk_kind::bitmap;
+      c.words.assign(bitmap_words, 0);
+      for (; i < stop; ++i) {
+        std::uint16_t low = static_cast<std::uint16_t>(keys[i]);
+        c.words[low >> 6] |= std::uint64_t(1) << (low & 63);
+      }
+    } else {
+      c.values.reserve(c.cardinality);
+      for (; i < stop; ++i) {
+        c.values.push_back(static_cast<std::uint16_t>(keys[i]));
+      }
+    }
+    chunks_.push_back(std::move(c));
+  }
+  size_ = keys.size();
+}
+
+template <typename Allocator>
+roaring_set<Allocator>::roaring_set(const roaring_set& s)
+    : chunks_(alloc_traits::select_on_container_copy_construction(
+          s.get_allocator())) {
+  copy_chunks(s);
+}
+
+template <typename Allocator>
+roaring_set<Allocator>::roaring_set(const roaring_set& s,
+                                    const Allocator& alloc)
+    : chunks_(alloc) {
+  copy_chunks(s);
+}
+
+template <typename Allocator>
+roaring_set<Allocator>::roaring_set(roaring_set&& s) noexcept
+    : chunks_(std::move(s.chunks_)), size_(s.size_) {
+  s.size_ = 0;
+}
+
+template <typename Allocator>
+roaring_set<Allocator>::~roaring_set() {}
+
+template <typename Allocator>
+roaring_set<Allocator>& roaring_set<Allocator>::operator=(
+    const roaring_set& s) {
+  if (this != &s) {
+    clear();
+    copy_chunks(s);
+  }
+  return *this;
+}
+
+template <typename Allocator>
+roaring_set<Allocator>& roaring_set<Allocator>::operator=(
+    roaring_set&& s) noexcept(nothrow_move_assign) {
+  if (this == &s) return *this;
+  if constexpr (!nothrow_move_assign) {
+    // the buffers of s belong to another resource: copy them onto ours
+    if (get_allocator() != s.get_allocator()) {
+      clear();
+      copy_chunks(s);
+      s.clear();
+      return *this;
+    }
+  }
+  chunks_ = std::move(s.chunks_);
+  size_ = s.size_;
+  s.chunks_.clear();
+  s.size_ = 0;
+  return *this;
+}
+
+template <typename Allocator>
+typename roaring_set<Allocator>::allocator_type
+roaring_set<Allocator>::get_allocator() const {
+  return Allocator(chunks_.get_allocator());
+}
+
+template <typename Allocator>
+typename roaring_set<Allocator>::iterator roaring_set<Allocator>::begin()
+    const {
+  if (chunks_.empty()) {
+    return end();
+  }
+  size_type pos;
+  std::uint16_t low;
+  chunk_first(chunks_[0], pos, low);
+  return iterator(this, 0, pos, compose(chunks_[0].key, low));
+}
+
+template <typename Allocator>
+typename roaring_set<Allocator>::iterator roaring_set<Allocator>::end() const {
+  return iterator(this, chunks_.size(), 0, 0);
+}
+
+template <typename Allocator>
+bool roaring_set<Allocator>::empty() const {
+  return size_ == 0;
+}
+
+template <typename Allocator>
+typename roaring_set<Allocator>::size_type roaring_set<Allocator>::size()
+    const {
+  return size_;
+}
+
+template <typename Allocator>
+typename roaring_set<Allocator>::size_type roaring_set<Allocator>::max_size()
+    const {
+  return size_type(std::numeric_limits<value_type>::max()) + 1;
+}
+
+template <typename Allocator>
+void roaring_set<Allocator>::clear() {
+  chunks_.clear();
+  size_ = 0;
+}
+
+template <typename Allocator>
+std::pair<typename roaring_set<Allocator>::iterator, bool>
+roaring_set<Allocator>::insert(value_type value) {
+  std::uint16_t high = static_cast<std::uint16_t>(value >> 16);
+  std::uint16_t low = static_cast<std::uint16_t>(value);
+  size_type rank = chunk_rank(high);
+  if (rank == chunks_.size() || chunks_[rank].key != high) {
+    chunks_.emplace(chunks_.begin() + rank, high, get_allocator());
+  }
+  bool inserted = chunk_insert(chunks_[rank], low);
+  size_ += inserted;
+
+  size_type pos;
+  chunk_lower_bound(chunks_[rank], low, pos, low);
+  return {iterator(this, rank, pos, value), inserted};
+}
+
+template <typename Allocator>
+void roaring_set<Allocator>::erase(iterator pos) {
+  if (pos != end()) {
+    erase(*pos);
+  }
+}
+
+template <typename Allocator>
+typename roaring_set<Allocator>::size_type roaring_set<Allocator>::erase(
+    value_type key) {
+  std::uint16_t high = static_cast<std::uint16_t>(key >> 16);
+  size_type rank = chunk_rank(high);
+  if (rank == chunks_.size() || chunks_[rank].key != high ||
+      !chunk_erase(chunks_[rank], static_cast<std::uint16_t>(key))) {
+    return 0;
+  }
+  --size_;
+  if (chunks_[rank].cardinality == 0) {
+    chunks_.erase(chunks_.begin() + rank);
+  }
+  return 1;
+}
+
+template <typename Allocator>
+void roaring_set<Allocator>::swap(roaring_set& other) {
+  chunks_.swap(other.chunks_);
+  std::swap(size_, other.size_);
+}
+
+template <typename Allocator>
+void roaring_set<Allocator>::merge(roaring_set& other) {
+  if (this == &other) {
+    return;
+  }
+  *this = combine<word_op::or_op>(*this, other);
+  other.clear();
+}
+
+template <typename Allocator>
+typename roaring_set<Allocator>::iterator roaring_set<Allocator>::find(
+    value_type key) const {
+  iterator it = lower_bound(key);
+  return it != end() && *it == key ? it : end();
+}
+
+template <typename Allocator>
+bool roaring_set<Allocator>::contains(value_type key) const {
+  std::uint16_t high = static_cast<std::uint16_t>(key >> 16);
+  size_type rank = chunk_rank(high);
+  return rank < chunks_.size() && chunks_[rank].key == high &&
+         chunk_contains(chunks_[rank], static_cast<std::uint16_t>(key));
+}
+
+template <typename Allocator>
+typename roaring_set<Allocator>::size_type roaring_set<Allocator>::count(
+    value_type key) const {
+  return contains(key);
+}
+
+template <typename Allocator>
+typename roaring_set<Allocator>::iterator roaring_set<Allocator>::lower_bound(
+    value_type key) const {
+  std::uint16_t high = static_cast<std::uint16_t>(key >> 16);
+  size_type rank = chunk_rank(high);
+  size_type pos;
+  std::uint16_t low;
+  if (rank < chunks_.size() && chunks_[rank].key == high) {
+    if (chunk_lower_bound(chunks_[rank], static_cast<std::uint16_t>(key), pos,
+                          low)) {
+      return iterator(this, rank, pos, compose(high, low));
+    }
+    ++rank;
+  }
+  if (rank == chunks_.size()) {
+    return end();
+  }
+  chunk_first(chunks_[rank], pos, low);
+  return iterator(this, rank, pos, compose(chunks_[rank].key, low));
+}
+
+template <typename Allocator>
+typename roaring_set<Allocator>::iterator roaring_set<Allocator>::upper_bound(
+    value_type key) const {
+  if (key == std::numeric_limits<value_type>::max()) {
+    return end();
+  }
+  return lower_bound(key + 1);
+}
+
+template <typename Allocator>
+template <typename... Args>
+s21::vector<std::pair<typename roaring_set<Allocator>::iterator, bool>>
+roaring_set<Allocator>::insert_many(Args&&... args) {
+  constexpr size_type count = sizeof...(Args);
+  s21::vector<std::pair<iterator, bool>> results;
+  if constexpr (count > 0) {
+    std::array<value_type, count> keys{
+        static_cast<value_type>(std::forward<Args>(args))...};
+    std::array<bool, count> inserted{};
+    for (size_type i = 0; i < count; ++i) {
+      inserted[i] = insert(keys[i]).second;
+    }
+    // iterators are only stable once every key is in
+    results.reserve(count);
+    for (size_type i = 0; i < count; ++i) {
+      results.push_back({find(keys[i]), inserted[i]});
+    }
+  }
+  return results;
+}
+
+template <typename Allocator>
+void roaring_set<Allocator>::run_optimize() {
+  for (chunk& c : chunks_) {
+    if (c.kind == chunk_kind::runs) {
+      continue;
+    }
+    size_type runs = count_runs(c);
+    size_type bytes = c.kind == chunk_kind::array
+                          ? c.values.size() * sizeof(std::uint16_t)
+                          : bitmap_bytes;
+    if (runs * 2 * sizeof(std::uint16_t) < bytes) {
+      to_runs(c, runs);
+    }
+  }
+}
+
+template <typename Allocator>
+typename roaring_set<Allocator>::size_type
+roaring_set<Allocator>::memory_usage() const {
+  size_type bytes = sizeof(*this) + chunks_.capacity() * sizeof(chunk);
+  for (const chunk& c : chunks_) {
+    bytes += c.values.capacity() * sizeof(std::uint16_t) +
+             c.words.capacity() * sizeof(std::uint64_t);
+  }
+  return bytes;
+}
+
+template <typename Allocator>
+typename roaring_set<Allocator>::size_type roaring_set<Allocator>::chunk_rank(
+    std::uint16_t high) const {
+  size_type left = 0;
+  size_type right = chunks_.size();
+  while (left < right) {
+    size_type mid = left + (right - left) / 2;
+    if (chunks_[mid].key < high) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left;
+}
+
+template <typename Allocator>
+void roaring_set<Allocator>::copy_chunks(const roaring_set& other) {
+  Allocator alloc = get_allocator();
+  chunks_.reserve(other.chunks_.size());
+  for (const chunk& c : other.chunks_) {
+    chunks_.emplace_back(c, alloc);
+  }
+  size_ = other.size_;
+}
+
+template <typename Allocator>
+void roaring_set<Allocator>::chunk_first(const chunk& c, size_type& pos,
+                                         std::uint16_t& low) {
+  pos = 0;
+  if (c.kind != chunk_kind::bitmap) {
+    low = c.values[0];
+    return;
+  }
+  size_type word = 0;
+  while (c.words[word] == 0) {
+    ++word;
+  }
+  low = static_cast<std::uint16_t>(word * 64 + std::countr_zero(c.words[word]));
+}
+
+template <typename Allocator>
+void roaring_set<Allocator>::chunk_last(const chunk& c, size_type& pos,
+                                        std::uint16_t& low) {
+  if (c.kind == chunk_kind::array) {
+    pos = c.values.size() - 1;
+    low = c.values[pos];
+  } else if (c.kind == chunk_kind::runs) {
+    pos = c.values.size() / 2 - 1;
+    low = c.values[2 * pos + 1];
+  } else {
+    pos = 0;
+    size_type word = bitmap_words - 1;
+    while (c.words[word] == 0) {
+      --word;
+    }
+    low = static_cast<std::uint16_t>(word * 64 + 63 -
+                                     std::countl_zero(c.words[word]));
+  }
+}
+
+template <typename Allocator>
+bool roaring_set<Allocator>::chunk_next(const chunk& c, size_type& pos,
+                                        std::uint16_t& low) {
+  if (c.kind == chunk_kind::array) {
+    if (pos + 1 >= c.values.size()) {
+      return false;
+    }
+    low = c.values[++pos];
+    return true;
+  }
+  if (c.kind == chunk_kind::runs) {
+    if (low < c.values[2 * pos + 1]) {
+      ++low;
+    } else if (2 * (pos + 1) < c.values.size()) {
+      low = c.values[2 * ++pos];
+    } else {
+      return false;
+    }
+    return true;
+  }
+  if (low == std::numeric_limits<std::uint16_t>::max()) {
+    return false;
+  }
+  size_type bit = size_type(low) + 1;
+  size_type word = bit >> 6;
+  std::uint64_t bits = c.words[word] & (~std::uint64_t(0) << (bit & 63));
+  while (bits == 0) {
+    if (++word == bitmap_words) {
+      return false;
+    }
+    bits = c.words[word];
+  }
+  low = static_cast<std::uint16_t>(word * 64 + std::countr_zero(bits));
+  return true;
+}
+
+template <typename Allocator>
+bool roaring_set<Allocator>::chunk_prev(const chunk& c, size_type& pos,
+                                        std::uint16_t& low) {
+  if (c.kind == chunk_kind::array) {
+    if (pos == 0) {
+      return false;
+    }
+    low = c.values[--pos];
+    return true;
+  }
+  if (c.kind == chunk_kind::runs) {
+    if (low > c.values[2 * pos]) {
+      --low;
+    } else if (pos > 0) {
+      low = c.values[2 * --pos + 1];
+    } else {
+      return false;
+    }
+    return true;
+  }
+  if (low == 0) {
+    return false;
+  }
+  size_type bit = size_type(low) - 1;
+  size_type word = bit >> 6;
+  std::uint64_t bits = c.words[word] & (~std::uint64_t(0) >> (63 - (bit & 63)));
+  while (bits == 0) {
+    if (word == 0) {
+      return false;
+    }
+    bits = c.words[--word];
+  }
+  low = static_cast<std::uint16_t>(word * 64 + 63 - std::countl_zero(bits));
+  return true;
+}
+
+// First key of the chunk not less than key; false when there is none.
+template <typename Allocator>
+bool roaring_set<Allocator>::chunk_lower_bound(const chunk& c,
+                                               std::uint16_t key,
+                                               size_type& pos,
+                                               std::uint16_t& low) {
+  if (c.kind == chunk_kind::array) {
+    const std::uint16_t* values = c.values.data();
+    pos = static_cast<size_type>(
+        branchless_lower_bound(values, c.values.size(), key) - values);
+    if (pos == c.values.size()) {
+      return false;
+    }
+    low = values[pos];
+    return true;
+  }
+  if (c.kind == chunk_kind::runs) {
+    size_type run = run_index(c, key);
+    if (run > 0 && key <= c.values[2 * run - 1]) {
+      pos = run - 1;
+      low = key;
+    } else if (2 * run < c.values.size()) {
+      pos = run;
+      low = c.values[2 * run];
+    } else {
+      return false;
+    }
+    return true;
+  }
+  pos = 0;
+  low = key;
+  return chunk_contains(c, key) || chunk_next(c, pos, low);
+}
+
+template <typename Allocator>
+bool roaring_set<Allocator>::chunk_contains(const chunk& c,
+                                            std::uint16_t low) {
+  if (c.kind == chunk_kind::array) {
+    const std::uint16_t* values = c.values.data();
+    const std::uint16_t* found =
+        branchless_lower_bound(values, c.values.size(), low);
+    return found != values + c.values.size() && *found == low;
+  }
+  if (c.kind == chunk_kind::runs) {
+    size_type run = run_index(c, low);
+    return run > 0 && low <= c.values[2 * run - 1];
+  }
+  return (c.words[low >> 6] >> (low & 63)) & 1;
+}
+
+// Number of runs starting at or before low.
+template <typename Allocator>
+typename roaring_set<Allocator>::size_type roaring_set<Allocator>::run_index(
+    const chunk& c, std::uint16_t low) {
+  size_type left = 0;
+  size_type right = c.values.size() / 2;
+  while (left < right) {
+    size_type mid = left + (right - left) / 2;
+    if (c.values[2 * mid] <= low) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left;
+}
+
+template <typename Allocator>
+bool roaring_set<Allocator>::chunk_insert(chunk& c, std::uint16_t low) {
+  if (c.kind == chunk_kind::array) {
+    const std::uint16_t* values = c.values.data();
+    size_type pos = static_cast<size_type>(
+        branchless_lower_bound(values, c.values.size(), low) - values);
+    if (pos < c.values.size() && values[pos] == low) {
+      return false;
+    }
+    if (c.values.size() < array_max) {
+      c.values.insert(c.values.begin() + pos, low);
+      ++c.cardinality;
+      return true;
+    }
+    to_bitmap(c);
+  }
+  if (c.kind == chunk_kind::bitmap) {
+    std::uint64_t& word = c.words[low >> 6];
+    std::uint64_t bit = std::uint64_t(1) << (low & 63);
+    if (word & bit) {
+      return false;
+    }
+    word |= bit;
+    ++c.cardinality;
+    return true;
+  }
+
+  // a key next to a run extends it and may join it to the following one
+  size_type run = run_index(c, low);
+  size_type runs = c.values.size() / 2;
+  if (run > 0 && low <= c.values[2 * run - 1]) {
+    return false;
+  }
+  bool joins_prev = run > 0 && c.values[2 * run - 1] + 1 == low;
+  bool joins_next = run < runs && low + 1 == c.values[2 * run];
+  if (joins_prev && joins_next) {
+    c.values[2 * run - 1] = c.values[2 * run + 1];
+    c.values.erase(c.values.begin() + 2 * run, c.values.begin() + 2 * run + 2);
+  } else if (joins_prev) {
+    c.values[2 * run - 1] = low;
+  } else if (joins_next) {
+    c.values[2 * run] = low;
+  } else {
+    c.values.insert(c.values.begin() + 2 * run, {low, low});
+  }
+  ++c.cardinality;
+  settle(c);
+  return true;
+}
+
+template <typename Allocator>
+bool roaring_set<Allocator>::chunk_erase(chunk& c, std::uint16_t low) {
+  if (c.kind == chunk_kind::array) {
+    const std::uint16_t* values = c.values.data();
+    size_type pos = static_cast<size_type>(
+        branchless_lower_bound(values, c.values.size(), low) - values);
+    if (pos == c.values.size() || values[pos] != low) {
+      return false;
+    }
+    c.values.erase(c.values.begin() + pos);
+    --c.cardinality;
+    return true;
+  }
+  if (c.kind == chunk_kind::bitmap) {
+    std::uint64_t& word = c.words[low >> 6];
+    std::uint64_t bit = std::uint64_t(1) << (low & 63);
+    if (!(word & bit)) {
+      return false;
+    }
+    word &= ~bit;
+    --c.cardinality;
+    settle(c);
+    return true;
+  }
+
+  size_type run = run_index(c, low);
+  if (run == 0 || low > c.values[2 * run - 1]) {
+    return false;
+  }
+  size_type first = 2 * (run - 1);
+  if (c.values[first] == c.values[first + 1]) {
+    c.values.erase(c.values.begin() + first, c.values.begin() + first + 2);
+  } else if (low == c.values[first]) {
+    ++c.values[first];
+  } else if (low == c.values[first + 1]) {
+    --c.values[first + 1];
+  } else {
+    // a key inside a run splits it in two
+    std::uint16_t last = c.values[first + 1];
+    c.values[first + 1] = static_cast<std::uint16_t>(low - 1);
+    c.values.insert(c.values.begin() + first + 2,
+                    {static_cast<std::uint16_t>(low + 1), last});
+  }
+  --c.cardinality;
+  settle(c);
+  return true;
+}
+
+template <typename Allocator>
+void roaring_set<Allocator>::to_bitmap(chunk& c) {
+  c.words.assign(bitmap_words, 0);
+  if (c.kind == chunk_kind::array) {
+    for (std::uint16_t low : c.values) {
+      c.words[low >> 6] |= std::uint64_t(1) << (low & 63);
+    }
+  } else if (c.kind == chunk_kind::runs) {
+    for (size_type i = 0; i < c.values.size(); i += 2) {
+      set_bits(c.words, c.values[i], c.values[i + 1]);
+    }
+  }
+  c.values.clear();
+  c.values.shrink_to_fit();
+  c.kind = chunk_kind::bitmap;
+}
+
+template <typename Allocator>
+void roaring_set<Allocator>::to_array(chunk& c) {
+  low_storage values(c.values.get_allocator());
+  values.reserve(c.cardinality);
+  if (c.kind == chunk_kind::bitmap) {
+    for (size_type word = 0; word < bitmap_words; ++word) {
+      for (std::uint64_t bits = c.words[word]; bits != 0; bits &= bits - 1) {
+        values.push_back(
+            static_cast<std::uint16_t>(word * 64 + std::countr_zero(bits)));
+      }
+    }
+  } else if (c.kind == chunk_kind::runs) {
+    for (size_type i = 0; i < c.values.size(); i += 2) {
+      for (size_type low = c.values[i]; low <= c.values[i + 1]; ++low) {
+        values.push_back(static_cast<std::uint16_t>(low));
+      }
+    }
+  } else {
+    return;
+  }
+  c.values = std::move(values);
+  c.words.clear();
+  c.words.shrink_to_fit();
+  c.kind = chunk_kind::array;
+}
+
+template <typename Allocator>
+void roaring_set<Allocator>::to_runs(chunk& c, size_type runs) {
+  low_storage values(c.values.get_allocator());
+  values.reserve(2 * runs);
+  size_type pos;
+  std::uint16_t low;
+  chunk_first(c, pos, low);
+  std::uint16_t first = low;
+  std::uint16_t last = low;
+  while (chunk_next(c, pos, low)) {
+    if (low != last + 1) {
+      values.insert(values.end(), {first, last});
+      first = low;
+    }
+    last = low;
+  }
+  values.insert(values.end(), {first, last});
+  c.values = std::move(values);
+  c.words.clear();
+  c.words.shrink_to_fit();
+  c.kind = chunk_kind::runs;
+}
+
+// Keeps a chunk in its smallest form after an edit: arrays past array_max
+// become bitmaps and sparse bitmaps arrays again; runs that grew larger
+// than the array or bitmap they describe are expanded.
+template <typename Allocator>
+void roaring_set<Allocator>::settle(chunk& c) {
+  if (c.kind == chunk_kind::array) {
+    if (c.cardinality > array_max) {
+      to_bitmap(c);
+    }
+  } else if (c.kind == chunk_kind::bitmap) {
+    if (c.cardinality <= array_max) {
+      to_array(c);
+    }
+  } else if (c.values.size() * sizeof(std::uint16_t) >
+             plain_bytes(c.cardinality)) {
+    if (c.cardinality <= array_max) {
+      to_array(c);
+    } else {
+      to_bitmap(c);
+    }
+  }
+}
+
+template <typename Allocator>
+typename roaring_set<Allocator>::size_type roaring_set<Allocator>::count_runs(
+    const chunk& c) {
+  if (c.kind == chunk_kind::runs) {
+    return c.values.size() / 2;
+  }
+  size_type runs = 0;
+  if (c.kind == chunk_kind::array) {
+    for (size_type i = 0; i < c.values.size(); ++i) {
+      runs += i == 0 || c.values[i] != c.values[i - 1] + 1;
+    }
+    return runs;
+  }
+  // a run starts at every set bit whose lower neighbour is clear
+  std::uint64_t carry = 0;
+  for (std::uint64_t word : c.words) {
+    std::uint64_t starts = word & ~((word << 1) | carry);
+    runs += static_cast<size_type>(std::popcount(starts));
+    carry = word >> 63;
+  }
+  return runs;
+}
+
+template <typename Allocator>
+typename roaring_set<Allocator>::size_type roaring_set<Allocator>::plain_bytes(
+    size_type cardinality) {
+  return cardinality <= array_max ? cardinality * sizeof(std::uint16_t)
+                                  : bitmap_bytes;
+}
+
+template <typename Allocator>
+void roaring_set<Allocator>::set_bits(word_storage& words, std::uint16_t first,
+                                      std::uint16_t last) {
+  size_type first_word = first >> 6;
+  size_type last_word = last >> 6;
+  std::uint64_t head = ~std::uint64_t(0) << (first & 63);
+  std::uint64_t tail = ~std::uint64_t(0) >> (63 - (last & 63));
+  if (first_word == last_word) {
+    words[first_word] |= head & tail;
+    return;
+  }
+  words[first_word] |= head;
+  for (size_type word = first_word + 1; word < last_word; ++word) {
+    words[word] = ~std::uint64_t(0);
+  }
+  words[last_word] |= tail;
+}
+
+// Walks the chunks of both sets in key order. A chunk found on one side
+// only is copied when the operation keeps that side; two chunks with the
+// same key are combined.
+template <typename Allocator>
+template <bitmap_kernels::word_op Op>
+roaring_set<Allocator> roaring_set<Allocator>::combine(const roaring_set& a,
+                                                       const roaring_set& b) {
+  constexpr bool keep_a = Op != word_op::and_op;
+  constexpr bool keep_b = Op == word_op::or_op || Op == word_op::xor_op;
+  roaring_set result(a.get_allocator());
+  Allocator alloc = result.get_allocator();
+  result.chunks_.reserve((keep_a ? a.chunks_.size() : 0) +
+                         (keep_b ? b.chunks_.size() : 0));
+  size_type i = 0;
+  size_type j = 0;
+  while (i < a.chunks_.size() || j < b.chunks_.size()) {
+    if (j == b.chunks_.size() ||
+        (i < a.chunks_.size() && a.chunks_[i].key < b.chunks_[j].key)) {
+      if (keep_a) result.chunks_.emplace_back(a.chunks_[i], alloc);
+      ++i;
+    } else if (i == a.chunks_.size() || b.chunks_[j].key < a.chunks_[i].key) {
+      if (keep_b) result.chunks_.emplace_back(b.chunks_[j], alloc);
+      ++j;
+    } else {
+      chunk out(a.chunks_[i].key, alloc);
+      combine_chunks<Op>(a.chunks_[i], b.chunks_[j], out);
+      if (out.cardinality > 0) {
+        result.chunks_.push_back(std::move(out));
+      }
+      ++i;
+      ++j;
+    }
+  }
+  for (const chunk& c : result.chunks_) {
+    result.size_ += c.cardinality;
+  }
+  return result;
+}
+
+// Runs take part through their array or bitmap form. Two arrays are
+// merged; an array against a bitmap whose keys cannot be kept on their own
+// is filtered with bit tests; everything else goes word by word.
+template <typename Allocator>
+template <bitmap_kernels::word_op Op>
+void roaring_set<Allocator>::combine_chunks(const chunk& a, const chunk& b,
+                                            chunk& out) {
+  constexpr bool keep_a = Op != word_op::and_op;
+  constexpr bool keep_b = Op == word_op::or_op || Op == word_op::xor_op;
+  Allocator alloc(out.values.get_allocator());
+  if (a.kind == chunk_kind::runs || b.kind == chunk_kind::runs) {
+    chunk plain_a(a, alloc);
+    chunk plain_b(b, alloc);
+    for (chunk* c : {&plain_a, &plain_b}) {
+      if (c->kind == chunk_kind::runs) {
+        if (c->cardinality <= array_max) {
+          to_array(*c);
+        } else {
+          to_bitmap(*c);
+        }
+      }
+    }
+    combine_chunks<Op>(plain_a, plain_b, out);
+    return;
+  }
+
+  if (a.kind == chunk_kind::array && b.kind == chunk_kind::array) {
+    merge_arrays<Op>(a.values, b.values, out);
+    return;
+  }
+  if (a.kind == chunk_kind::array && !keep_b) {
+    filter_array<Op>(a.values, b, true, out);
+    return;
+  }
+  if (b.kind == chunk_kind::array && !keep_a) {
+    filter_array<Op>(b.values, a, false, out);
+    return;
+  }
+
+  word_storage scratch(alloc);
+  auto words_of = [&scratch](const chunk& c) {
+    if (c.kind == chunk_kind::bitmap) {
+      return c.words.data();
+    }
+    scratch.assign(bitmap_words, 0);
+    for (std::uint16_t low : c.values) {
+      scratch[low >> 6] |= std::uint64_t(1) << (low & 63);
+    }
+    return static_cast<const std::uint64_t*>(scratch.data());
+  };
+  // at most one side is an array here, so one scratch bitmap is enough
+  const std::uint64_t* words_a = words_of(a);
+  const std::uint64_t* words_b = words_of(b);
+  out.kind = chunk_kind::bitmap;
+  out.words.assign(bitmap_words, 0);
+  size_type count = bitmap_kernels::combine_words<Op>(
+      words_a, words_b, out.words.data(), bitmap_words);
+  out.cardinality = static_cast<std::uint32_t>(count);
+  settle(out);
+}
+
+template <typename Allocator>
+template <bitmap_kernels::word_op Op>
+void roaring_set<Allocator>::merge_arrays(const low_storage& a,
+                                          const low_storage& b, chunk& out) {
+  constexpr bool keep_a = Op != word_op::and_op;
+  constexpr bool keep_b = Op == word_op::or_op || Op == word_op::xor_op;
+  constexpr bool keep_both = Op == word_op::or_op || Op == word_op::and_op;
+  low_storage& values = out.values;
+  values.reserve(keep_a || keep_b ? a.size() + b.size()
+                                  : std::min(a.size(), b.size()));
+  size_type i = 0;
+  size_type j = 0;
+  while (i < a.size() && j < b.size()) {
+    if (a[i] < b[j]) {
+      if (keep_a) values.push_back(a[i]);
+      ++i;
+    } else if (b[j] < a[i]) {
+      if (keep_b) values.push_back(b[j]);
+      ++j;
+    } else {
+      if (keep_both) values.push_back(a[i]);
+      ++i;
+      ++j;
+    }
+  }
+  if (keep_a) values.insert(values.end(), a.begin() + i, a.end());
+  if (keep_b) values.insert(values.end(), b.begin() + j, b.end());
+  out.kind = chunk_kind::array;
+  out.cardinality = static_cast<std::uint32_t>(values.size());
+  settle(out);
+}
+
+// Keeps the keys of values that the operation selects, testing each
+// against the bitmap chunk; in_first tells whether values is the left
+// operand.
+template <typename Allocator>
+template <bitmap_kernels::word_op Op>
+void roaring_set<Allocator>::filter_array(const low_storage& values,
+                                          const chunk& bitmap, bool in_first,
+                                          chunk& out) {
+  constexpr bool keep_a = Op != word_op::and_op;
+  constexpr bool keep_b = Op == word_op::or_op || Op == word_op::xor_op;
+  constexpr bool keep_both = Op == word_op::or_op || Op == word_op::and_op;
+  bool keep_alone = in_first ? keep_a : keep_b;
+  out.kind = chunk_kind::array;
+  out.values.reserve(values.size());
+  for (std::uint16_t low : values) {
+    bool shared = (bitmap.words[low >> 6] >> (low & 63)) & 1;
+    if (shared ? keep_both : keep_alone) {
+      out.values.push_back(low);
+    }
+  }
+  out.cardinality = static_cast<std::uint32_t>(out.values.size());
+}
+
+template <typename Allocator>
+typename roaring_set<Allocator>::RoaringIterator&
+roaring_set<Allocator>::RoaringIterator::operator++() {
+  const chunk_storage& chunks = set_->chunks_;
+  std::uint16_t low = static_cast<std::uint16_t>(value_);
+  if (chunk_next(chunks[chunk_], pos_, low)) {
+    value_ = compose(chunks[chunk_].key, low);
+  } else if (++chunk_ < chunks.size()) {
+    chunk_first(chunks[chunk_], pos_, low);
+    value_ = compose(chunks[chunk_].key, low);
+  } else {
+    pos_ = 0;
+    value_ = 0;
+  }
+  return *this;
+}
+
+template <typename Allocator>
+typename roaring_set<Allocator>::RoaringIterator&
+roaring_set<Allocator>::RoaringIterator::operator--() {
+  const chunk_storage& chunks = set_->chunks_;
+  std::uint16_t low = static_cast<std::uint16_t>(value_);
+  if (chunk_ < chunks.size() && chunk_prev(chunks[chunk_], pos_, low)) {
+    value_ = compose(chunks[chunk_].key, low);
+  } else {
+    --chunk_;
+    chunk_last(chunks[chunk_], pos_, low);
+    value_ = compose(chunks[chunk_].key, low);
+  }
+  return *this;
+}
+
+template <typename Allocator>
+roaring_set<Allocator> set_union(const roaring_set<Allocator>& a,
+                                 const roaring_set<Allocator>& b) {
+  return roaring_set<Allocator>::template combine<
+      bitmap_kernels::word_op::or_op>(a, b);
+}
+
+template <typename Allocator>
+roaring_set<Allocator> set_intersection(const roaring_set<Allocator>& a,
+                                        const roaring_set<Allocator>& b) {
+  return roaring_set<Allocator>::template combine<
+      bitmap_kernels::word_op::and_op>(a, b);
+}
+
+template <typename Allocator>
+roaring_set<Allocator> set_difference(const roaring_set<Allocator>& a,
+                                      const roaring_set<Allocator>& b) {
+  return roaring_set<Allocator>::template combine<
+      bitmap_kernels::word_op::and_not_op>(a, b);
+}
+
+template <typename Allocator>
+roaring_set<Allocator> set_symmetric_difference(
+    const roaring_set<Allocator>& a, const roaring_set<Allocator>& b) {
+  return roaring_set<Allocator>::template combine<
+      bitmap_kernels::word_op::xor_op>(a, b);
+}
+
+}  // namespace s21
@@ -0,0 +1,205 @@
+#ifndef S21_LOWER_BOUND_H
+#define S21_LOWER_BOUND_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define S21_LOWER_BOUND_X86 1
+#endif
+
+namespace s21 {
+
+// lower_bound over a sorted array of arithmetic keys without data-dependent
+// branches. The search halves the range with conditional moves until at
+// most lower_bound_block keys are left, then counts the keys below the
+// target in one fixed-width block: with AVX2 or SSE4.2 (picked at run time
+// from CPUID) for 32- and 64-bit integers, float and double, with a scalar
+// loop everywhere else.
+inline constexpr std::size_t lower_bound_block = 16;
+
+namespace lower_bound_kernels {
+
+enum class simd_level { scalar, sse42, avx2 };
+
+inline simd_level detected_simd_level() {
+#if defined(S21_LOWER_BOUND_X86) && defined(__GNUC__)
+  static const simd_level level = [] {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return simd_level::avx2;
+    if (__builtin_cpu_supports("sse4.2")) return simd_level::sse42;
+    return simd_level::scalar;
+  }();
+  return level;
+#else
+  return simd_level::scalar;
+#endif
+}
+
+template <typename T>
+std::size_t count_less_scalar(const T* first, std::size_t n, T key) {
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    count += first[i] < key;
+  }
+  return count;
+}
+
+// the vector kernels handle these key types, all on exactly one block
+template <typename T>
+inline constexpr bool has_simd_kernel =
+    (std::is_integral_v<T> && (sizeof(T) == 4 || sizeof(T) == 8)) ||
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+#if defined(S21_LOWER_BOUND_X86) && defined(__GNUC__)
+
+// unsigned keys are compared as signed after flipping the sign bit
+template <typename T>
+T to_signed_order(T value) {
+  if constexpr (std::is_unsigned_v<T>) {
+    return value ^ (T(1) << (sizeof(T) * 8 - 1));
+  } else {
+    return value;
+  }
+}
+
+template <typename T>
+__attribute__((target("avx2"))) std::size_t count_less_avx2(const T* first,
+                                                            T key) {
+  unsigned count = 0;
+  if constexpr (std::is_same_v<T, float>) {
+    __m256 k = _mm256_set1_ps(key);
+    for (std::size_t i = 0; i < lower_bound_block; i += 8) {
+      __m256 lt = _mm256_cmp_ps(_mm256_loadu_ps(first + i), k, _CMP_LT_OQ);
+      count += std::popcount(unsigned(_mm256_movemask_ps(lt)));
+    }
+  } else if constexpr (std::is_same_v<T, double>) {
+    __m256d k = _mm256_set1_pd(key);
+    for (std::size_t i = 0; i < lower_bound_block; i += 4) {
+      __m256d lt = _mm256_cmp_pd(_mm256_loadu_pd(first + i), k, _CMP_LT_OQ);
+      count += std::popcount(unsigned(_mm256_movemask_pd(lt)));
+    }
+  } else if constexpr (sizeof(T) == 4) {
+    const int32_t flip = std::is_unsigned_v<T> ? INT32_MIN : 0;
+    __m256i bias = _mm256_set1_epi32(flip);
+    __m256i k = _mm256_set1_epi32(int32_t(to_signed_order(key)));
+    for (std::size_t i = 0; i < lower_bound_block; i += 8) {
+      __m256i v = _mm256_xor_si256(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i)),
+          bias);
+      __m256i lt = _mm256_cmpgt_epi32(k, v);
+      count += std::popcount(
+          unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(lt))));
+    }
+  } else {
+    const int64_t flip = std::is_unsigned_v<T> ? INT64_MIN : 0;
+    __m256i bias = _mm256_set1_epi64x(flip);
+    __m256i k = _mm256_set1_epi64x(int64_t(to_signed_order(key)));
+    for (std::size_t i = 0; i < lower_bound_block; i += 4) {
+      __m256i v = _mm256_xor_si256(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i)),
+          bias);
+      __m256i lt = _mm256_cmpgt_epi64(k, v);
+      count += std::popcount(
+          unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(lt))));
+    }
+  }
+  return count;
+}
+
+template <typename T>
+__attribute__((target("sse4.2"))) std::size_t count_less_sse42(
+    const T* first, T key) {
+  unsigned count = 0;
+  if constexpr (std::is_same_v<T, float>) {
+    __m128 k = _mm_set1_ps(key);
+    for (std::size_t i = 0; i < lower_bound_block; i += 4) {
+      __m128 lt = _mm_cmplt_ps(_mm_loadu_ps(first + i), k);
+      count += std::popcount(unsigned(_mm_movemask_ps(lt)));
+    }
+  } else if constexpr (std::is_same_v<T, double>) {
+    __m128d k = _mm_set1_pd(key);
+    for (std::size_t i = 0; i < lower_bound_block; i += 2) {
+      __m128d lt = _mm_cmplt_pd(_mm_loadu_pd(first + i), k);
+      count += std::popcount(unsigned(_mm_movemask_pd(lt)));
+    }
+  } else if constexpr (sizeof(T) == 4) {
+    const int32_t flip = std::is_unsigned_v<T> ? INT32_MIN : 0;
+    __m128i bias = _mm_set1_epi32(flip);
+    __m128i k = _mm_set1_epi32(int32_t(to_signed_order(key)));
+    for (std::size_t i = 0; i < lower_bound_block; i += 4) {
+      __m128i v = _mm_xor_si128(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i)), bias);
+      __m128i lt = _mm_cmpgt_epi32(k, v);
+      count += std::popcount(unsigned(_mm_movemask_ps(_mm_castsi128_ps(lt))));
+    }
+  } else {
+    const int64_t flip = std::is_unsigned_v<T> ? INT64_MIN : 0;
+    __m128i bias = _mm_set1_epi64x(flip);
+    __m128i k = _mm_set1_epi64x(int64_t(to_signed_order(key)));
+    for (std::size_t i = 0; i < lower_bound_block; i += 2) {
+      __m128i v = _mm_xor_si128(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i)), bias);
+      __m128i lt = _mm_cmpgt_epi64(k, v);
+      count += std::popcount(unsigned(_mm_movemask_pd(_mm_castsi128_pd(lt))));
+    }
+  }
+  return count;
+}
+
+#endif
+
+// Number of keys in [first, first + lower_bound_block) below key.
+template <typename T>
+std::size_t count_less_block(const T* first, T key) {
+#if defined(S21_LOWER_BOUND_X86) && defined(__GNUC__)
+  if constexpr (has_simd_kernel<T>) {
+    switch (detected_simd_level()) {
+      case simd_level::avx2:
+        return count_less_avx2(first, key);
+      case simd_level::sse42:
+        return count_less_sse42(first, key);
+      case simd_level::scalar:
+        break;
+    }
+  }
+#endif
+  return count_less_scalar(first, lower_bound_block, key);
+}
+
+}  // namespace lower_bound_kernels
+
+template <typename T>
+const T* branchless_lower_bound(const T* first, std::size_t n, T key) {
+  static_assert(std::is_arithmetic_v<T>,
+                "branchless_lower_bound needs arithmetic keys");
+  if (n < lower_bound_block) {
+    return first + lower_bound_kernels::count_less_scalar(first, n, key);
+  }
+
+  // invariant: the answer lies in [base, base + len]
+  const T* base = first;
+  std::size_t len = n;
+  while (len > lower_bound_block) {
+    std::size_t half = len / 2;
+    base = base[half - 1] < key ? base + half : base;
+    len -= half;
+  }
+
+  // Every key before base is below key and every key from base + len on is
+  // not, so any full block that covers [base, base + len) yields the answer;
+  // the block is moved back from the end of the array instead of reading
+  // past it.
+  const T* block = base;
+  if (block > first + (n - lower_bound_block)) {
+    block = first + (n - lower_bound_block);
+  }
+  return block + lower_bound_kernels::count_less_block(block, key);
+}
+
+}  // namespace s21
+
+#endif
@@ -1,15 +1,25 @@
 #ifndef S21_SET_H
 #define S21_SET_H
 
+#include <array>
+#include <bit>
 #include <cstddef>
+#include <functional>
 #include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <type_traits>
 #include <utility>
 
 #include "../s21_vector/s21_vector.h"
+#include "s21_lower_bound.h"
 
 namespace s21 {
 
-template <typename Key>
+template <typename Key, typename Allocator = std::allocator<Key>,
+          typename Compare = std::less<Key>>
 class set {
  public:
   class SetIterator;
@@ -17,19 +27,39 @@ class set {
 
   using key_type = Key;
   using value_type = Key;
+  using allocator_type = Allocator;
+  using key_compare = Compare;
+  using value_compare = Compare;
   using reference = value_type&;
   using const_reference = const value_type&;
   using iterator = SetIterator;
   using const_iterator = SetConstIterator;
   using size_type = std::size_t;
 
+  // Lookups also accept any type K the comparator orders against Key when
+  // Compare declares is_transparent, e.g. std::string_view keys in a
+  // set<std::string, std::allocator<std::string>, std::less<>>.
+  static constexpr bool is_transparent =
+      requires { typename Compare::is_transparent; };
+
   set();
+  explicit set(const Allocator& alloc);
+  explicit set(const Compare& comp, const Allocator& alloc = Allocator());
   set(std::initializer_list<value_type> const& items);
+  // Bulk construction: the keys are sorted once and deduplicated in one
+  // pass, O(n log n) overall (linear passes for integral keys).
+  template <std::input_iterator InputIt>
+  set(InputIt first, InputIt last, const Allocator& alloc = Allocator());
+  explicit set(s21::vector<value_type, Allocator>&& items);
   set(const set& s);
   set(set&& s);
   ~set();
   set& operator=(set&& s);
 
+  allocator_type get_allocator() const;
+  key_compare key_comp() const;
+  value_compare value_comp() const;
+
   iterator begin();
   const_iterator begin() const;
   iterator end();
@@ -41,37 +71,235 @@ class set {
 
   void clear();
   std::pair<iterator, bool> insert(const value_type& value);
+  // Inserts right before hint when that keeps the order, which makes
+  // ascending input with hint end() amortized O(1); otherwise falls back to
+  // the binary search of insert(value).
+  iterator insert(const_iterator hint, const value_type& value);
   void erase(iterator pos);
   void swap(set& other);
   void merge(set& other);
 
   iterator find(const Key& key);
+  const_iterator find(const Key& key) const;
   bool contains(const Key& key) const;
+  size_type count(const Key& key) const;
+
+  // Ordered queries, O(log n) each; they use the search index when it is
+  // fresh. range(lo, hi) views the keys in [lo, hi) without copying them,
+  // so a scan costs O(log n + k) for k keys; it is empty when hi <= lo.
+  iterator lower_bound(const Key& key);
+  const_iterator lower_bound(const Key& key) const;
+  iterator upper_bound(const Key& key);
+  const_iterator upper_bound(const Key& key) const;
+  std::pair<iterator, iterator> equal_range(const Key& key);
+  std::pair<const_iterator, const_iterator> equal_range(const Key& key) const;
+  std::ranges::subrange<const_iterator> range(const Key& lo,
+                                              const Key& hi) const;
+
+  template <typename K>
+    requires is_transparent
+  iterator find(const K& key) {
+    apply_writes();
+    size_type rank = stored_rank(key);
+    return iterator(data_.begin() + rank);
+  }
+  template <typename K>
+    requires is_transparent
+  const_iterator find(const K& key) const {
+    return view_find(key);
+  }
+  template <typename K>
+    requires is_transparent
+  bool contains(const K& key) const {
+    return contains_key(key);
+  }
+  template <typename K>
+    requires is_transparent
+  size_type count(const K& key) const {
+    return contains_key(key);
+  }
+  template <typename K>
+    requires is_transparent
+  iterator lower_bound(const K& key) {
+    apply_writes();
+    size_type rank = lower_bound_rank(key);
+    return iterator(data_.begin() + rank);
+  }
+  template <typename K>
+    requires is_transparent
+  const_iterator lower_bound(const K& key) const {
+    return view_lower_bound(key);
+  }
+  template <typename K>
+    requires is_transparent
+  iterator upper_bound(const K& key) {
+    apply_writes();
+    size_type rank = upper_bound_rank(key);
+    return iterator(data_.begin() + rank);
+  }
+  template <typename K>
+    requires is_transparent
+  const_iterator upper_bound(const K& key) const {
+    return view_upper_bound(key);
+  }
+  template <typename K>
+    requires is_transparent
+  std::pair<iterator, iterator> equal_range(const K& key) {
+    return {lower_bound(key), upper_bound(key)};
+  }
+  template <typename K>
+    requires is_transparent
+  std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
 
+  // Sets of at least search_index_min_size keys keep a copy of the keys in
+  // Eytzinger (BFS) order, so a lookup walks one cache line per few levels
+  // with the next ones prefetched instead of missing on every probe. Bulk
+  // construction, copy, merge and insert_many build it; single insert and
+  // erase only mark it stale and lookups fall back to binary search until
+  // rebuild_index() or the next bulk operation. Lookups never modify it.
+  static constexpr size_type search_index_min_size = 4096;
+  void rebuild_index();
+  bool has_search_index() const;
+
+  // Write-buffered updates for write-heavy phases. buffered_insert and
+  // buffered_erase record the change in a small sorted buffer of pending
+  // inserts and tombstones instead of shifting the keys, which costs
+  // O(log n) comparisons and O(sqrt n) moves amortized instead of O(n)
+  // moves. Const operations see pending writes where they are: lookups
+  // search the keys and the buffer side by side and const iterators walk
+  // both, so const access never modifies the set and concurrent readers
+  // are safe. Non-const operations other than these two first merge the
+  // buffer into the keys in one pass, as does a buffer grown past about
+  // 2 sqrt(n) entries. Those merges leave the search index stale; flush()
+  // merges and rebuilds it, so call it when a write phase ends. Merges and
+  // buffered writes invalidate iterators.
+  bool buffered_insert(const value_type& value);
+  size_type buffered_erase(const Key& key);
+  void flush();
+  size_type pending_writes() const;
+
+  // Inserts all arguments with one sort of the batch and one linear merge.
+  // The results follow argument order; a key repeated in the batch is
+  // reported as inserted only for its first occurrence.
   template <typename... Args>
   s21::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
 
- private:
-  s21::vector<value_type> data_;
+  template <typename K, typename A, typename C>
+  friend set<K, A, C> set_union(const set<K, A, C>& a, const set<K, A, C>& b);
+  template <typename K, typename A, typename C>
+  friend set<K, A, C> set_intersection(const set<K, A, C>& a,
+                                       const set<K, A, C>& b);
+  template <typename K, typename A, typename C>
+  friend set<K, A, C> set_difference(const set<K, A, C>& a,
+                                     const set<K, A, C>& b);
+  template <typename K, typename A, typename C>
+  friend set<K, A, C> set_symmetric_difference(const set<K, A, C>& a,
+                                               const set<K, A, C>& b);
 
-  iterator manual_find(const Key& key);
-  const_iterator manual_find(const Key& key) const;
-  iterator manual_find_position(const value_type& value);
-  const_iterator manual_find_position(const value_type& value) const;
-  void manual_sort_and_unique();
+ private:
+  using storage_type = s21::vector<value_type, Allocator>;
+
+  // A buffered write: a key missing from data_ to insert, or a tombstone
+  // for a key of data_ to erase. The buffer is sorted by key.
+  struct pending_write {
+    value_type key;
+    bool erased;
+  };
+  using write_buffer = s21::vector<
+      pending_write, typename std::allocator_traits<
+                         Allocator>::template rebind_alloc<pending_write>>;
+
+  storage_type data_;
+  storage_type index_;
+  bool index_fresh_ = true;
+  write_buffer writes_;
+  size_type tombstones_ = 0;
+  [[no_unique_address]] Compare comp_;
+
+  // Keys are ordered by comp_ alone: a and b are equivalent when neither
+  // orders before the other, so no lookup needs operator==.
+  // The branchless kernel and the radix sort assume the natural order of
+  // arithmetic keys, so any other comparator takes the generic paths.
+  static constexpr bool natural_order =
+      std::is_same_v<Compare, std::less<Key>> ||
+      std::is_same_v<Compare, std::less<>>;
+  // integral keys are sorted with a byte-wise radix sort above this size
+  static constexpr bool radix_sortable = natural_order &&
+                                         std::is_integral_v<value_type> &&
+                                         !std::is_same_v<value_type, bool>;
+  static constexpr size_type radix_threshold = 256;
+
+  void sort_and_unique();
+  void radix_sort();
+  void merge_sorted(storage_type& incoming);
+  void build_index();
+
+  static constexpr size_type write_buffer_min = 64;
+  size_type write_buffer_limit() const;
+  void apply_writes();
+  // position of the first pending write not less than key
+  template <typename K>
+  size_type pending_rank(const K& key) const;
+  template <typename K>
+  bool contains_key(const K& key) const;
+
+  // Const lookups: the position is searched in data_ and in the write
+  // buffer separately and the iterator walks both from there.
+  template <typename K>
+  const_iterator view_lower_bound(const K& key) const;
+  template <typename K>
+  const_iterator view_upper_bound(const K& key) const;
+  template <typename K>
+  const_iterator view_find(const K& key) const;
+
+  // Lookup ranks (positions in data_), which leave pending writes out;
+  // stored_rank returns data_.size() for a missing key. Arithmetic keys in
+  // natural order take branchless_lower_bound, other keys a binary search
+  // on comp_.
+  template <typename K>
+  size_type manual_lower_bound(const K& key) const;
+  template <typename K>
+  size_type lower_bound_rank(const K& key) const;
+  template <typename K>
+  size_type upper_bound_rank(const K& key) const;
+  template <typename K>
+  size_type stored_rank(const K& key) const;
+
+  static size_type eytzinger_rank(size_type k, size_type n);
+  template <typename K>
+  size_type eytzinger_lower_bound(const K& key) const;
+
+  // One side this many times larger than the other is galloped over
+  // instead of merged key by key.
+  static constexpr size_type gallop_ratio = 8;
+  static set combine(const set& a, const set& b, bool keep_a, bool keep_b,
+                     bool keep_both);
+  void linear_combine(const storage_type& a, const storage_type& b,
+                      bool keep_a, bool keep_b, bool keep_both,
+                      storage_type& out) const;
+  void gallop_combine(const storage_type& small, const storage_type& big,
+                      bool keep_small, bool keep_big, bool keep_both,
+                      storage_type& out) const;
 };
 
-template <typename Key>
-class set<Key>::SetIterator {
+template <typename Key, typename Allocator, typename Compare>
+class set<Key, Allocator, Compare>::SetIterator {
  private:
-  typename s21::vector<value_type>::iterator ptr_;
-  friend class set<Key>;
+  typename storage_type::iterator ptr_;
+  friend class set<Key, Allocator, Compare>;
   friend class SetConstIterator;
 
  public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = Key;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const Key*;
+  using reference = const Key&;
+
   SetIterator() : ptr_() {}
-  explicit SetIterator(typename s21::vector<value_type>::iterator ptr)
-      : ptr_(ptr) {}
+  explicit SetIterator(typename storage_type::iterator ptr) : ptr_(ptr) {}
 
   const value_type& operator*() const { return *ptr_; }
 
@@ -109,62 +337,129 @@ class set<Key>::SetIterator {
     return ptr_ != other.ptr_;
   }
 
-  SetIterator operator+(int n) const {
-    auto temp = ptr_;
-    for (int i = 0; i < n; ++i) ++temp;
-    return SetIterator(temp);
-  }
+  SetIterator operator+(int n) const { return SetIterator(ptr_ + n); }
 
-  SetIterator operator-(int n) const {
-    auto temp = ptr_;
-    for (int i = 0; i < n; ++i) --temp;
-    return SetIterator(temp);
-  }
+  SetIterator operator-(int n) const { return SetIterator(ptr_ - n); }
 };
 
-template <typename Key>
-class set<Key>::SetConstIterator {
+// Walks data_ alone, or, when it comes from a const lookup while writes
+// are pending, data_ and the write buffer together in key order: a pending
+// insert shows up between the keys around it and a key with a tombstone is
+// stepped over.
+template <typename Key, typename Allocator, typename Compare>
+class set<Key, Allocator, Compare>::SetConstIterator {
  private:
-  typename s21::vector<value_type>::const_iterator ptr_;
-  friend class set<Key>;
+  typename storage_type::const_iterator ptr_;
+  // set whose write buffer is walked too, null when there is none;
+  // write_ is the position in the buffer
+  const set* owner_ = nullptr;
+  size_type write_ = 0;
+  friend class set<Key, Allocator, Compare>;
+
+  SetConstIterator(typename storage_type::const_iterator ptr,
+                   size_type write, const set* owner)
+      : ptr_(ptr), owner_(owner), write_(write) {
+    skip_erased();
+  }
+
+  // the pending insert at write_ orders before the key at ptr_
+  bool at_write() const {
+    const write_buffer& writes = owner_->writes_;
+    return write_ != writes.size() && !writes[write_].erased &&
+           (ptr_ == owner_->data_.end() ||
+            owner_->comp_(writes[write_].key, *ptr_));
+  }
+
+  // a tombstone at write_ names the key at ptr_ or one after it
+  void skip_erased() {
+    const write_buffer& writes = owner_->writes_;
+    while (write_ != writes.size() && writes[write_].erased &&
+           ptr_ != owner_->data_.end() &&
+           !owner_->comp_(*ptr_, writes[write_].key)) {
+      ++ptr_;
+      ++write_;
+    }
+  }
+
+  void step_back() {
+    const write_buffer& writes = owner_->writes_;
+    while (true) {
+      if (write_ != 0 && writes[write_ - 1].erased) {
+        // its key is among the keys before ptr_, the last one at most
+        bool erased = !owner_->comp_(writes[write_ - 1].key, *(ptr_ - 1));
+        --ptr_;
+        if (!erased) return;
+        --write_;
+      } else if (write_ != 0 && (ptr_ == owner_->data_.begin() ||
+                                 owner_->comp_(*(ptr_ - 1),
+                                               writes[write_ - 1].key))) {
+        --write_;
+        return;
+      } else {
+        --ptr_;
+        return;
+      }
+    }
+  }
 
  public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = Key;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const Key*;
+  using reference = const Key&;
+
   SetConstIterator() : ptr_() {}
-  explicit SetConstIterator(
-      typename s21::vector<value_type>::const_iterator ptr)
+  explicit SetConstIterator(typename storage_type::const_iterator ptr)
       : ptr_(ptr) {}
   SetConstIterator(const SetIterator& other) : ptr_(other.ptr_) {}
 
-  const value_type& operator*() const { return *ptr_; }
+  const value_type& operator*() const {
+    if (owner_ && at_write()) return owner_->writes_[write_].key;
+    return *ptr_;
+  }
 
   SetConstIterator& operator++() {
-    ++ptr_;
+    if (!owner_) {
+      ++ptr_;
+    } else {
+      if (at_write()) {
+        ++write_;
+      } else {
+        ++ptr_;
+      }
+      skip_erased();
+    }
     return *this;
   }
 
   SetConstIterator operator++(int) {
     SetConstIterator temp = *this;
-    ++ptr_;
+    ++*this;
     return temp;
   }
 
   SetConstIterator& operator--() {
-    --ptr_;
+    if (!owner_) {
+      --ptr_;
+    } else {
+      step_back();
+    }
     return *this;
   }
 
   SetConstIterator operator--(int) {
     SetConstIterator temp = *this;
-    --ptr_;
+    --*this;
     return temp;
   }
 
   bool operator==(const SetConstIterator& other) const {
-    return ptr_ == other.ptr_;
+    return ptr_ == other.ptr_ && write_ == other.write_;
   }
 
   bool operator!=(const SetConstIterator& other) const {
-    return ptr_ != other.ptr_;
+    return !(*this == other);
   }
 
   bool operator==(const SetIterator& other) const { return ptr_ == other.ptr_; }
@@ -172,6 +467,34 @@ class set<Key>::SetConstIterator {
   bool operator!=(const SetIterator& other) const { return ptr_ != other.ptr_; }
 };
 
+// Set algebra in O(n + m) for sets of similar size and O(m log(n / m)) for
+// m keys against n >= gallop_ratio * m, where the keys of the smaller set
+// are located in the larger one by galloping (exponential) search and the
+// stretches between them are copied in bulk. The result is written
+// straight into its storage and uses the allocator of a.
+template <typename Key, typename Allocator, typename Compare>
+set<Key, Allocator, Compare> set_union(const set<Key, Allocator, Compare>& a,
+                                       const set<Key, Allocator, Compare>& b);
+template <typename Key, typename Allocator, typename Compare>
+set<Key, Allocator, Compare> set_intersection(
+    const set<Key, Allocator, Compare>& a,
+    const set<Key, Allocator, Compare>& b);
+template <typename Key, typename Allocator, typename Compare>
+set<Key, Allocator, Compare> set_difference(
+    const set<Key, Allocator, Compare>& a,
+    const set<Key, Allocator, Compare>& b);
+template <typename Key, typename Allocator, typename Compare>
+set<Key, Allocator, Compare> set_symmetric_difference(
+    const set<Key, Allocator, Compare>& a,
+    const set<Key, Allocator, Compare>& b);
+
+namespace pmr {
+
+template <typename Key, typename Compare = std::less<Key>>
+using set = s21::set<Key, std::pmr::polymorphic_allocator<Key>, Compare>;
+
+}  // namespace pmr
+
 }  // namespace s21
 
 #include "s21_set.tpp"
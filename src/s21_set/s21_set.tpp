@@ -7,252 +7,870 @@
 
 namespace s21 {
 
-template <typename Key>
-set<Key>::set() : data_() {}
+template <typename Key, typename Allocator, typename Compare>
+set<Key, Allocator, Compare>::set() : data_() {}
+
+template <typename Key, typename Allocator, typename Compare>
+set<Key, Allocator, Compare>::set(const Allocator& alloc)
+    : data_(alloc), index_(alloc), writes_(alloc) {}
+
+template <typename Key, typename Allocator, typename Compare>
+set<Key, Allocator, Compare>::set(const Compare& comp, const Allocator& alloc)
+    : data_(alloc), index_(alloc), writes_(alloc), comp_(comp) {}
+
+template <typename Key, typename Allocator, typename Compare>
+set<Key, Allocator, Compare>::set(
+    std::initializer_list<value_type> const& items)
+    : data_(items) {
+  sort_and_unique();
+}
 
-template <typename Key>
-set<Key>::set(std::initializer_list<value_type> const& items) {
-  for (const auto& item : items) {
-    insert(item);
-  }
+template <typename Key, typename Allocator, typename Compare>
+template <std::input_iterator InputIt>
+set<Key, Allocator, Compare>::set(InputIt first, InputIt last,
+                                  const Allocator& alloc)
+    : data_(alloc), index_(alloc), writes_(alloc) {
+  data_.assign(first, last);
+  sort_and_unique();
 }
 
-template <typename Key>
-set<Key>::set(const set& s) : data_(s.data_) {
-  manual_sort_and_unique();
+template <typename Key, typename Allocator, typename Compare>
+set<Key, Allocator, Compare>::set(s21::vector<value_type, Allocator>&& items)
+    : data_(std::move(items)),
+      index_(data_.get_allocator()),
+      writes_(data_.get_allocator()) {
+  sort_and_unique();
 }
 
-template <typename Key>
-set<Key>::set(set&& s) : data_(std::move(s.data_)) {}
+template <typename Key, typename Allocator, typename Compare>
+set<Key, Allocator, Compare>::set(const set& s)
+    : data_(s.data_),
+      index_(s.index_),
+      index_fresh_(s.index_fresh_),
+      writes_(s.writes_),
+      tombstones_(s.tombstones_),
+      comp_(s.comp_) {}
+
+template <typename Key, typename Allocator, typename Compare>
+set<Key, Allocator, Compare>::set(set&& s)
+    : data_(std::move(s.data_)),
+      index_(std::move(s.index_)),
+      index_fresh_(s.index_fresh_),
+      writes_(std::move(s.writes_)),
+      tombstones_(s.tombstones_),
+      comp_(s.comp_) {
+  s.index_fresh_ = true;
+  s.tombstones_ = 0;
+}
 
-template <typename Key>
-set<Key>::~set() {}
+template <typename Key, typename Allocator, typename Compare>
+set<Key, Allocator, Compare>::~set() {}
 
-template <typename Key>
-set<Key>& set<Key>::operator=(set&& s) {
+template <typename Key, typename Allocator, typename Compare>
+set<Key, Allocator, Compare>& set<Key, Allocator, Compare>::operator=(
+    set&& s) {
   if (this != &s) {
     data_ = std::move(s.data_);
+    index_ = std::move(s.index_);
+    index_fresh_ = s.index_fresh_;
+    writes_ = std::move(s.writes_);
+    tombstones_ = s.tombstones_;
+    comp_ = s.comp_;
+    s.index_.clear();
+    s.index_fresh_ = true;
+    s.writes_.clear();
+    s.tombstones_ = 0;
   }
   return *this;
 }
 
-template <typename Key>
-typename set<Key>::iterator set<Key>::begin() {
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::allocator_type
+set<Key, Allocator, Compare>::get_allocator() const {
+  return data_.get_allocator();
+}
+
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::key_compare
+set<Key, Allocator, Compare>::key_comp() const {
+  return comp_;
+}
+
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::value_compare
+set<Key, Allocator, Compare>::value_comp() const {
+  return comp_;
+}
+
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::iterator
+set<Key, Allocator, Compare>::begin() {
+  apply_writes();
   return iterator(data_.begin());
 }
 
-template <typename Key>
-typename set<Key>::const_iterator set<Key>::begin() const {
-  return const_iterator(data_.begin());
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::const_iterator
+set<Key, Allocator, Compare>::begin() const {
+  if (writes_.empty()) {
+    return const_iterator(data_.begin());
+  }
+  return const_iterator(data_.begin(), 0, this);
 }
 
-template <typename Key>
-typename set<Key>::iterator set<Key>::end() {
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::iterator
+set<Key, Allocator, Compare>::end() {
+  apply_writes();
   return iterator(data_.end());
 }
 
-template <typename Key>
-typename set<Key>::const_iterator set<Key>::end() const {
-  return const_iterator(data_.end());
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::const_iterator
+set<Key, Allocator, Compare>::end() const {
+  if (writes_.empty()) {
+    return const_iterator(data_.end());
+  }
+  return const_iterator(data_.end(), writes_.size(), this);
 }
 
-template <typename Key>
-bool set<Key>::empty() const {
-  return data_.empty();
+template <typename Key, typename Allocator, typename Compare>
+bool set<Key, Allocator, Compare>::empty() const {
+  return size() == 0;
 }
 
-template <typename Key>
-typename set<Key>::size_type set<Key>::size() const {
-  return data_.size();
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::size_type
+set<Key, Allocator, Compare>::size() const {
+  // every pending insert adds a key, every tombstone removes one
+  return data_.size() + writes_.size() - 2 * tombstones_;
 }
 
-template <typename Key>
-typename set<Key>::size_type set<Key>::max_size() const {
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::size_type
+set<Key, Allocator, Compare>::max_size() const {
   return data_.max_size();
 }
 
-template <typename Key>
-void set<Key>::clear() {
+template <typename Key, typename Allocator, typename Compare>
+void set<Key, Allocator, Compare>::clear() {
   data_.clear();
+  index_.clear();
+  index_fresh_ = true;
+  writes_.clear();
+  tombstones_ = 0;
 }
 
-template <typename Key>
-std::pair<typename set<Key>::iterator, bool> set<Key>::insert(
-    const value_type& value) {
-  auto it = manual_find(value);
-  if (it != end()) {
-    return std::pair<iterator, bool>(it, false);
+template <typename Key, typename Allocator, typename Compare>
+std::pair<typename set<Key, Allocator, Compare>::iterator, bool>
+set<Key, Allocator, Compare>::insert(const value_type& value) {
+  apply_writes();
+  auto pos = data_.begin() + manual_lower_bound(value);
+  if (pos != data_.end() && !comp_(value, *pos)) {
+    return std::pair<iterator, bool>(iterator(pos), false);
   }
+  index_fresh_ = false;
+  return std::pair<iterator, bool>(iterator(data_.insert(pos, value)), true);
+}
 
-  auto pos = manual_find_position(value);
-
-  size_type index = 0;
-  for (auto temp_it = begin(); temp_it != pos && temp_it != end(); ++temp_it) {
-    ++index;
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::iterator
+set<Key, Allocator, Compare>::insert(const_iterator hint,
+                                     const value_type& value) {
+  if (!writes_.empty()) {
+    return insert(value).first;
   }
+  auto pos = hint.ptr_;
+  bool fits_before = pos == data_.end() || comp_(value, *pos);
+  bool fits_after = pos == data_.begin() || comp_(*(pos - 1), value);
+  if (fits_before && fits_after) {
+    index_fresh_ = false;
+    return iterator(data_.insert(pos, value));
+  }
+  return insert(value).first;
+}
 
-  data_.insert(data_.begin() + index, value);
+template <typename Key, typename Allocator, typename Compare>
+void set<Key, Allocator, Compare>::erase(iterator pos) {
+  if (pos != end()) {
+    index_fresh_ = false;
+    data_.erase(pos.ptr_);
+  }
+}
 
-  it = manual_find(value);
-  return std::pair<iterator, bool>(it, true);
+template <typename Key, typename Allocator, typename Compare>
+void set<Key, Allocator, Compare>::swap(set& other) {
+  data_.swap(other.data_);
+  index_.swap(other.index_);
+  std::swap(index_fresh_, other.index_fresh_);
+  writes_.swap(other.writes_);
+  std::swap(tombstones_, other.tombstones_);
+  std::swap(comp_, other.comp_);
 }
 
-template <typename Key>
-void set<Key>::erase(iterator pos) {
-  if (pos == end()) {
+template <typename Key, typename Allocator, typename Compare>
+void set<Key, Allocator, Compare>::merge(set& other) {
+  if (this == &other) {
     return;
   }
 
-  size_type index = 0;
-  for (auto it = begin(); it != pos && it != end(); ++it) {
-    ++index;
-  }
+  apply_writes();
+  other.apply_writes();
+  merge_sorted(other.data_);
+  other.clear();
+}
+
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::iterator
+set<Key, Allocator, Compare>::find(const Key& key) {
+  apply_writes();
+  size_type rank = stored_rank(key);
+  return iterator(data_.begin() + rank);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::const_iterator
+set<Key, Allocator, Compare>::find(const Key& key) const {
+  return view_find(key);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+bool set<Key, Allocator, Compare>::contains(const Key& key) const {
+  return contains_key(key);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::size_type
+set<Key, Allocator, Compare>::count(const Key& key) const {
+  return contains_key(key);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::iterator
+set<Key, Allocator, Compare>::lower_bound(const Key& key) {
+  apply_writes();
+  size_type rank = lower_bound_rank(key);
+  return iterator(data_.begin() + rank);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::const_iterator
+set<Key, Allocator, Compare>::lower_bound(const Key& key) const {
+  return view_lower_bound(key);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::iterator
+set<Key, Allocator, Compare>::upper_bound(const Key& key) {
+  apply_writes();
+  size_type rank = upper_bound_rank(key);
+  return iterator(data_.begin() + rank);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::const_iterator
+set<Key, Allocator, Compare>::upper_bound(const Key& key) const {
+  return view_upper_bound(key);
+}
 
-  if (index < data_.size()) {
-    data_.erase(data_.begin() + index);
+template <typename Key, typename Allocator, typename Compare>
+std::pair<typename set<Key, Allocator, Compare>::iterator,
+          typename set<Key, Allocator, Compare>::iterator>
+set<Key, Allocator, Compare>::equal_range(const Key& key) {
+  apply_writes();
+  size_type first = lower_bound_rank(key);
+  size_type last =
+      first < data_.size() && !comp_(key, data_[first]) ? first + 1 : first;
+  return {iterator(data_.begin() + first), iterator(data_.begin() + last)};
+}
+
+template <typename Key, typename Allocator, typename Compare>
+std::pair<typename set<Key, Allocator, Compare>::const_iterator,
+          typename set<Key, Allocator, Compare>::const_iterator>
+set<Key, Allocator, Compare>::equal_range(const Key& key) const {
+  const_iterator first = view_lower_bound(key);
+  const_iterator last = first;
+  if (last != end() && !comp_(key, *last)) {
+    ++last;
   }
+  return {first, last};
 }
 
-template <typename Key>
-void set<Key>::swap(set& other) {
-  data_.swap(other.data_);
+template <typename Key, typename Allocator, typename Compare>
+std::ranges::subrange<typename set<Key, Allocator, Compare>::const_iterator>
+set<Key, Allocator, Compare>::range(const Key& lo, const Key& hi) const {
+  const_iterator first = view_lower_bound(lo);
+  return {first, comp_(lo, hi) ? view_lower_bound(hi) : first};
 }
 
-template <typename Key>
-void set<Key>::merge(set& other) {
-  if (this == &other) {
+template <typename Key, typename Allocator, typename Compare>
+void set<Key, Allocator, Compare>::rebuild_index() {
+  apply_writes();
+  build_index();
+}
+
+template <typename Key, typename Allocator, typename Compare>
+void set<Key, Allocator, Compare>::build_index() {
+  size_type n = data_.size();
+  index_.clear();
+  index_fresh_ = true;
+  if (n < search_index_min_size) {
     return;
   }
+  index_.reserve(n);
+  for (size_type k = 1; k <= n; ++k) {
+    index_.push_back(data_[eytzinger_rank(k, n)]);
+  }
+}
+
+template <typename Key, typename Allocator, typename Compare>
+bool set<Key, Allocator, Compare>::has_search_index() const {
+  return index_fresh_ && !index_.empty();
+}
 
-  for (auto it = other.begin(); it != other.end(); ++it) {
-    insert(*it);
+template <typename Key, typename Allocator, typename Compare>
+bool set<Key, Allocator, Compare>::buffered_insert(const value_type& value) {
+  auto write = writes_.begin() + pending_rank(value);
+  if (write != writes_.end() && !comp_(value, write->key)) {
+    if (!write->erased) {
+      return false;
+    }
+    // the key is still in data_, dropping its tombstone restores it
+    writes_.erase(write);
+    --tombstones_;
+    return true;
+  }
+  if (stored_rank(value) != data_.size()) {
+    return false;
+  }
+  writes_.insert(write, pending_write{value, false});
+  if (writes_.size() >= write_buffer_limit()) {
+    apply_writes();
   }
+  return true;
+}
 
-  other.clear();
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::size_type
+set<Key, Allocator, Compare>::buffered_erase(const Key& key) {
+  auto write = writes_.begin() + pending_rank(key);
+  if (write != writes_.end() && !comp_(key, write->key)) {
+    if (write->erased) {
+      return 0;
+    }
+    // a pending insert never reached data_, so it just goes away
+    writes_.erase(write);
+    return 1;
+  }
+  if (stored_rank(key) == data_.size()) {
+    return 0;
+  }
+  writes_.insert(write, pending_write{key, true});
+  ++tombstones_;
+  if (writes_.size() >= write_buffer_limit()) {
+    apply_writes();
+  }
+  return 1;
 }
 
-template <typename Key>
-typename set<Key>::iterator set<Key>::find(const Key& key) {
-  return manual_find(key);
+template <typename Key, typename Allocator, typename Compare>
+void set<Key, Allocator, Compare>::flush() {
+  if (!writes_.empty() || !index_fresh_) {
+    rebuild_index();
+  }
 }
 
-template <typename Key>
-bool set<Key>::contains(const Key& key) const {
-  return manual_find(key) != end();
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::size_type
+set<Key, Allocator, Compare>::pending_writes() const {
+  return writes_.size();
 }
 
-template <typename Key>
-typename set<Key>::iterator set<Key>::manual_find(const Key& key) {
-  size_type left = 0;
-  size_type right = data_.size();
+// Keeping the buffer sorted moves O(limit) entries per write and merging
+// it moves O(n) keys per limit writes, so about sqrt(n) entries balance
+// the two.
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::size_type
+set<Key, Allocator, Compare>::write_buffer_limit() const {
+  return std::max(write_buffer_min,
+                  size_type(2) << (std::bit_width(data_.size()) / 2));
+}
 
-  while (left < right) {
-    size_type mid = left + (right - left) / 2;
-    if (data_[mid] == key) {
-      return iterator(data_.begin() + mid);
-    } else if (data_[mid] < key) {
-      left = mid + 1;
+// Merges the pending writes into data_: the stretch of keys in front of
+// each write is moved over as one block, then the write adds its key or
+// skips the key its tombstone names. Like a single insert it only marks
+// the search index stale, so a write phase does not rebuild it on every
+// merge; flush() and rebuild_index() do.
+template <typename Key, typename Allocator, typename Compare>
+void set<Key, Allocator, Compare>::apply_writes() {
+  if (writes_.empty()) {
+    return;
+  }
+  storage_type merged(data_.get_allocator());
+  merged.reserve(data_.size() + writes_.size() - 2 * tombstones_);
+  auto kept = data_.begin();
+  for (pending_write& write : writes_) {
+    auto next = std::lower_bound(kept, data_.end(), write.key, comp_);
+    merged.insert(merged.end(), std::make_move_iterator(kept),
+                  std::make_move_iterator(next));
+    if (write.erased) {
+      kept = next + 1;
     } else {
-      right = mid;
+      merged.push_back(std::move(write.key));
+      kept = next;
     }
   }
-
-  return end();
+  merged.insert(merged.end(), std::make_move_iterator(kept),
+                std::make_move_iterator(data_.end()));
+  data_ = std::move(merged);
+  writes_.clear();
+  tombstones_ = 0;
+  index_fresh_ = false;
 }
 
-template <typename Key>
-typename set<Key>::const_iterator set<Key>::manual_find(const Key& key) const {
-  size_type left = 0;
-  size_type right = data_.size();
+template <typename Key, typename Allocator, typename Compare>
+template <typename K>
+typename set<Key, Allocator, Compare>::size_type
+set<Key, Allocator, Compare>::pending_rank(const K& key) const {
+  return std::lower_bound(writes_.begin(), writes_.end(), key,
+                          [this](const pending_write& write, const K& k) {
+                            return comp_(write.key, k);
+                          }) -
+         writes_.begin();
+}
 
-  while (left < right) {
-    size_type mid = left + (right - left) / 2;
-    if (data_[mid] == key) {
-      return const_iterator(data_.begin() + mid);
-    } else if (data_[mid] < key) {
-      left = mid + 1;
-    } else {
-      right = mid;
+// A pending write decides membership on its own; otherwise the key is
+// looked up in data_, through the index when it is fresh.
+template <typename Key, typename Allocator, typename Compare>
+template <typename K>
+bool set<Key, Allocator, Compare>::contains_key(const K& key) const {
+  if (!writes_.empty()) {
+    size_type write = pending_rank(key);
+    if (write != writes_.size() && !comp_(key, writes_[write].key)) {
+      return !writes_[write].erased;
     }
   }
+  return stored_rank(key) != data_.size();
+}
+
+// Without pending writes the plain data_ iterator is all there is; with
+// them the key's place in the write buffer is searched as well.
+template <typename Key, typename Allocator, typename Compare>
+template <typename K>
+typename set<Key, Allocator, Compare>::const_iterator
+set<Key, Allocator, Compare>::view_lower_bound(const K& key) const {
+  auto keys = data_.begin() + lower_bound_rank(key);
+  if (writes_.empty()) {
+    return const_iterator(keys);
+  }
+  return const_iterator(keys, pending_rank(key), this);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+template <typename K>
+typename set<Key, Allocator, Compare>::const_iterator
+set<Key, Allocator, Compare>::view_upper_bound(const K& key) const {
+  if (writes_.empty()) {
+    return const_iterator(data_.begin() + upper_bound_rank(key));
+  }
+  const_iterator it = view_lower_bound(key);
+  if (it != end() && !comp_(key, *it)) {
+    ++it;
+  }
+  return it;
+}
 
-  return end();
+template <typename Key, typename Allocator, typename Compare>
+template <typename K>
+typename set<Key, Allocator, Compare>::const_iterator
+set<Key, Allocator, Compare>::view_find(const K& key) const {
+  if (writes_.empty()) {
+    return const_iterator(data_.begin() + stored_rank(key));
+  }
+  const_iterator it = view_lower_bound(key);
+  return it != end() && !comp_(key, *it) ? it : end();
 }
 
-template <typename Key>
-typename set<Key>::iterator set<Key>::manual_find_position(
-    const value_type& value) {
+template <typename Key, typename Allocator, typename Compare>
+template <typename K>
+typename set<Key, Allocator, Compare>::size_type
+set<Key, Allocator, Compare>::manual_lower_bound(const K& key) const {
+  if constexpr (natural_order && std::is_arithmetic_v<value_type> &&
+                std::is_same_v<K, value_type>) {
+    return static_cast<size_type>(
+        branchless_lower_bound(data_.data(), data_.size(), key) -
+        data_.data());
+  }
   size_type left = 0;
   size_type right = data_.size();
 
   while (left < right) {
     size_type mid = left + (right - left) / 2;
-    if (data_[mid] < value) {
+    if (comp_(data_[mid], key)) {
       left = mid + 1;
     } else {
       right = mid;
     }
   }
 
-  return iterator(data_.begin() + left);
+  return left;
 }
 
-template <typename Key>
-typename set<Key>::const_iterator set<Key>::manual_find_position(
-    const value_type& value) const {
-  size_type left = 0;
-  size_type right = data_.size();
+// Sorts the storage and drops duplicates. Input that is already strictly
+// increasing (copies, serialized sets) is detected in one linear pass.
+template <typename Key, typename Allocator, typename Compare>
+void set<Key, Allocator, Compare>::sort_and_unique() {
+  auto out_of_order = [this](const value_type& a, const value_type& b) {
+    return !comp_(a, b);
+  };
+  if (std::adjacent_find(data_.begin(), data_.end(), out_of_order) ==
+      data_.end()) {
+    build_index();
+    return;
+  }
 
-  while (left < right) {
-    size_type mid = left + (right - left) / 2;
-    if (data_[mid] < value) {
-      left = mid + 1;
+  if constexpr (radix_sortable) {
+    if (data_.size() >= radix_threshold) {
+      radix_sort();
     } else {
-      right = mid;
+      std::sort(data_.begin(), data_.end(), comp_);
     }
+  } else {
+    std::sort(data_.begin(), data_.end(), comp_);
   }
 
-  return const_iterator(data_.begin() + left);
+  // sorted neighbours are equivalent when the first is not less
+  data_.erase(std::unique(data_.begin(), data_.end(), out_of_order),
+              data_.end());
+  build_index();
 }
 
-template <typename Key>
-void set<Key>::manual_sort_and_unique() {
-  for (size_type i = 0; i < data_.size(); ++i) {
-    for (size_type j = 0; j < data_.size() - i - 1; ++j) {
-      if (data_[j + 1] < data_[j]) {
-        value_type temp = data_[j];
-        data_[j] = data_[j + 1];
-        data_[j + 1] = temp;
+// LSD radix sort on bytes, ping-ponging between data_ and one scratch
+// buffer. Signed keys get their sign bit flipped so they order as unsigned;
+// passes over a byte that every key shares are skipped.
+template <typename Key, typename Allocator, typename Compare>
+void set<Key, Allocator, Compare>::radix_sort() {
+  if constexpr (radix_sortable) {
+    using bits_type = std::make_unsigned_t<value_type>;
+    constexpr unsigned width = sizeof(value_type) * 8;
+    constexpr bits_type sign =
+        std::is_signed_v<value_type> ? bits_type(bits_type(1) << (width - 1))
+                                     : bits_type(0);
+
+    size_type n = data_.size();
+    storage_type scratch(n, data_.get_allocator());
+    value_type* from = data_.data();
+    value_type* to = scratch.data();
+
+    for (unsigned shift = 0; shift < width; shift += 8) {
+      auto digit = [&](value_type key) {
+        return static_cast<unsigned>(
+            ((static_cast<bits_type>(key) ^ sign) >> shift) & 0xFF);
+      };
+      size_type offsets[256] = {};
+      for (size_type i = 0; i < n; ++i) {
+        ++offsets[digit(from[i])];
+      }
+      if (offsets[digit(from[0])] == n) {
+        continue;
       }
+      size_type total = 0;
+      for (size_type& offset : offsets) {
+        size_type count = offset;
+        offset = total;
+        total += count;
+      }
+      for (size_type i = 0; i < n; ++i) {
+        to[offsets[digit(from[i])]++] = from[i];
+      }
+      std::swap(from, to);
     }
+
+    if (from != data_.data()) {
+      std::copy(from, from + n, data_.data());
+    }
+  }
+}
+
+// Merges sorted, duplicate-free keys into the storage in one linear pass;
+// keys already present are skipped. incoming is left with moved-from keys.
+template <typename Key, typename Allocator, typename Compare>
+void set<Key, Allocator, Compare>::merge_sorted(storage_type& incoming) {
+  if (incoming.empty()) {
+    return;
+  }
+  if (data_.empty() || comp_(data_.back(), incoming.front())) {
+    data_.insert(data_.end(), std::make_move_iterator(incoming.begin()),
+                 std::make_move_iterator(incoming.end()));
+    build_index();
+    return;
   }
 
-  if (data_.size() > 1) {
-    size_type write_index = 1;
-    for (size_type i = 1; i < data_.size(); ++i) {
-      if (data_[i] != data_[i - 1]) {
-        data_[write_index] = data_[i];
-        ++write_index;
+  storage_type merged(data_.get_allocator());
+  merged.reserve(data_.size() + incoming.size());
+  auto ours = data_.begin();
+  auto theirs = incoming.begin();
+  while (ours != data_.end() && theirs != incoming.end()) {
+    if (comp_(*theirs, *ours)) {
+      merged.push_back(std::move(*theirs++));
+    } else {
+      if (!comp_(*ours, *theirs)) {
+        ++theirs;
       }
+      merged.push_back(std::move(*ours++));
     }
+  }
+  merged.insert(merged.end(), std::make_move_iterator(ours),
+                std::make_move_iterator(data_.end()));
+  merged.insert(merged.end(), std::make_move_iterator(theirs),
+                std::make_move_iterator(incoming.end()));
+  data_ = std::move(merged);
+  build_index();
+}
 
-    while (data_.size() > write_index) {
-      data_.pop_back();
-    }
+// In-order (sorted) position of node k of the Eytzinger tree over n keys.
+// In a perfect tree of h levels node k at depth d has rank
+// (2 * (k - 2^d) + 1) * 2^(h - 1 - d) - 1; the leaves missing from the last
+// level would sit at the even ranks after the m present ones, so every one
+// of them in front of the node is subtracted.
+template <typename Key, typename Allocator, typename Compare>
+typename set<Key, Allocator, Compare>::size_type
+set<Key, Allocator, Compare>::eytzinger_rank(size_type k, size_type n) {
+  size_type levels = std::bit_width(n);
+  size_type depth = std::bit_width(k) - 1;
+  size_type rank =
+      ((2 * (k - (size_type(1) << depth)) + 1) << (levels - 1 - depth)) - 1;
+  size_type last_level = size_type(1) << (levels - 1);
+  size_type present = n - (last_level - 1);
+  size_type missing_before = std::min(last_level, (rank + 1) / 2);
+  return missing_before > present ? rank - (missing_before - present) : rank;
+}
+
+// Branch-free descent (Khuong and Morin): each step goes to 2k or 2k + 1,
+// and the nodes a few levels below are prefetched while the current one is
+// compared. The trailing right turns are undone at the end, which leaves
+// the node holding the first key not less than key, or 0 if there is none.
+template <typename Key, typename Allocator, typename Compare>
+template <typename K>
+typename set<Key, Allocator, Compare>::size_type
+set<Key, Allocator, Compare>::eytzinger_lower_bound(const K& key) const {
+  // one cache line of keys holds the subtree this many levels below k
+  constexpr size_type prefetch_span =
+      sizeof(value_type) >= 64 ? 1 : 64 / sizeof(value_type);
+  const value_type* keys = index_.data();
+  size_type n = index_.size();
+  size_type k = 1;
+  while (k <= n) {
+#if defined(__GNUC__)
+    __builtin_prefetch(reinterpret_cast<const char*>(keys) +
+                       (k * prefetch_span - 1) * sizeof(value_type));
+#endif
+    k = 2 * k + comp_(keys[k - 1], key);
   }
+  return k >> (std::countr_one(k) + 1);
 }
 
-template <typename Key>
+template <typename Key, typename Allocator, typename Compare>
 template <typename... Args>
-s21::vector<std::pair<typename set<Key>::iterator, bool>> set<Key>::insert_many(
-    Args&&... args) {
+s21::vector<std::pair<typename set<Key, Allocator, Compare>::iterator, bool>>
+set<Key, Allocator, Compare>::insert_many(Args&&... args) {
+  constexpr size_type count = sizeof...(Args);
   s21::vector<std::pair<iterator, bool>> results;
+  apply_writes();
+  if constexpr (count > 0) {
+    storage_type batch(get_allocator());
+    batch.reserve(count);
+    (batch.emplace_back(std::forward<Args>(args)), ...);
+
+    // a stable order by key puts the first occurrence of each key first
+    std::array<size_type, count> order;
+    for (size_type i = 0; i < count; ++i) {
+      order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [this, &batch](size_type a, size_type b) {
+                       return comp_(batch[a], batch[b]);
+                     });
+
+    std::array<bool, count> inserted{};
+    storage_type fresh(get_allocator());
+    fresh.reserve(count);
+    for (size_type i = 0; i < count; ++i) {
+      const value_type& key = batch[order[i]];
+      bool repeated = i > 0 && !comp_(batch[order[i - 1]], key);
+      if (!repeated && !contains(key)) {
+        inserted[order[i]] = true;
+        fresh.push_back(key);
+      }
+    }
+    merge_sorted(fresh);
 
-  results.reserve(sizeof...(args));
+    results.reserve(count);
+    for (size_type i = 0; i < count; ++i) {
+      results.push_back({find(batch[i]), inserted[i]});
+    }
+  }
+  return results;
+}
+
+// Position of the first key not less than key, from the search index when
+// it is fresh.
+template <typename Key, typename Allocator, typename Compare>
+template <typename K>
+typename set<Key, Allocator, Compare>::size_type
+set<Key, Allocator, Compare>::lower_bound_rank(const K& key) const {
+  if (has_search_index()) {
+    size_type k = eytzinger_lower_bound(key);
+    return k == 0 ? data_.size() : eytzinger_rank(k, index_.size());
+  }
+  return manual_lower_bound(key);
+}
 
-  (results.push_back(insert(std::forward<Args>(args))), ...);
+// Keys are unique, so the upper bound is at most one past the lower bound.
+template <typename Key, typename Allocator, typename Compare>
+template <typename K>
+typename set<Key, Allocator, Compare>::size_type
+set<Key, Allocator, Compare>::upper_bound_rank(const K& key) const {
+  size_type rank = lower_bound_rank(key);
+  return rank < data_.size() && !comp_(key, data_[rank]) ? rank + 1 : rank;
+}
 
-  return results;
+// The lower bound holds key exactly when key does not order before it. With
+// a fresh index the check reads the index node the descent just visited
+// instead of touching data_.
+template <typename Key, typename Allocator, typename Compare>
+template <typename K>
+typename set<Key, Allocator, Compare>::size_type
+set<Key, Allocator, Compare>::stored_rank(const K& key) const {
+  if (has_search_index()) {
+    size_type k = eytzinger_lower_bound(key);
+    if (k == 0 || comp_(key, index_[k - 1])) {
+      return data_.size();
+    }
+    return eytzinger_rank(k, index_.size());
+  }
+  size_type rank = manual_lower_bound(key);
+  if (rank == data_.size() || comp_(key, data_[rank])) {
+    return data_.size();
+  }
+  return rank;
+}
+
+// Builds the keys found only in a, only in b or in both, as selected. A
+// set with pending writes takes part through a merged copy of its keys.
+template <typename Key, typename Allocator, typename Compare>
+set<Key, Allocator, Compare> set<Key, Allocator, Compare>::combine(
+    const set& a, const set& b, bool keep_a, bool keep_b, bool keep_both) {
+  storage_type a_merged(a.get_allocator());
+  storage_type b_merged(b.get_allocator());
+  if (!a.writes_.empty()) {
+    a_merged.assign(a.begin(), a.end());
+  }
+  if (!b.writes_.empty()) {
+    b_merged.assign(b.begin(), b.end());
+  }
+  const storage_type& a_keys = a.writes_.empty() ? a.data_ : a_merged;
+  const storage_type& b_keys = b.writes_.empty() ? b.data_ : b_merged;
+  set result(a.comp_, a.get_allocator());
+  size_type bound = (keep_a ? a.size() : 0) + (keep_b ? b.size() : 0);
+  if (keep_both && !keep_a && !keep_b) {
+    bound = std::min(a.size(), b.size());
+  }
+  storage_type& out = result.data_;
+  out.reserve(bound);
+  if (a.size() * gallop_ratio <= b.size()) {
+    result.gallop_combine(a_keys, b_keys, keep_a, keep_b, keep_both, out);
+  } else if (b.size() * gallop_ratio <= a.size()) {
+    result.gallop_combine(b_keys, a_keys, keep_b, keep_a, keep_both, out);
+  } else {
+    result.linear_combine(a_keys, b_keys, keep_a, keep_b, keep_both, out);
+  }
+  result.build_index();
+  return result;
+}
+
+template <typename Key, typename Allocator, typename Compare>
+void set<Key, Allocator, Compare>::linear_combine(const storage_type& a,
+                                                  const storage_type& b,
+                                                  bool keep_a, bool keep_b,
+                                                  bool keep_both,
+                                                  storage_type& out) const {
+  size_type i = 0;
+  size_type j = 0;
+  while (i < a.size() && j < b.size()) {
+    if (comp_(a[i], b[j])) {
+      if (keep_a) out.push_back(a[i]);
+      ++i;
+    } else if (comp_(b[j], a[i])) {
+      if (keep_b) out.push_back(b[j]);
+      ++j;
+    } else {
+      if (keep_both) out.push_back(a[i]);
+      ++i;
+      ++j;
+    }
+  }
+  if (keep_a) out.insert(out.end(), a.begin() + i, a.end());
+  if (keep_b) out.insert(out.end(), b.begin() + j, b.end());
+}
+
+// Walks the smaller set key by key. Each key is looked up in the rest of
+// the larger set with steps of 1, 2, 4, ... and a binary search inside the
+// last step, so a gap of g keys costs O(log g) and is copied as one block.
+template <typename Key, typename Allocator, typename Compare>
+void set<Key, Allocator, Compare>::gallop_combine(
+    const storage_type& small, const storage_type& big, bool keep_small,
+    bool keep_big, bool keep_both, storage_type& out) const {
+  size_type n = big.size();
+  size_type pos = 0;
+  for (const value_type& key : small) {
+    size_type lo = pos;
+    size_type step = 1;
+    while (lo + step <= n && comp_(big[lo + step - 1], key)) {
+      lo += step;
+      step *= 2;
+    }
+    size_type hi = std::min(lo + step - 1, n);
+    size_type found = static_cast<size_type>(
+        std::lower_bound(big.begin() + lo, big.begin() + hi, key, comp_) -
+        big.begin());
+    if (keep_big) out.insert(out.end(), big.begin() + pos, big.begin() + found);
+    if (found < n && !comp_(key, big[found])) {
+      if (keep_both) out.push_back(key);
+      pos = found + 1;
+    } else {
+      if (keep_small) out.push_back(key);
+      pos = found;
+    }
+  }
+  if (keep_big) out.insert(out.end(), big.begin() + pos, big.end());
+}
+
+template <typename Key, typename Allocator, typename Compare>
+set<Key, Allocator, Compare> set_union(const set<Key, Allocator, Compare>& a,
+                                       const set<Key, Allocator, Compare>& b) {
+  return set<Key, Allocator, Compare>::combine(a, b, true, true, true);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+set<Key, Allocator, Compare> set_intersection(
+    const set<Key, Allocator, Compare>& a,
+    const set<Key, Allocator, Compare>& b) {
+  return set<Key, Allocator, Compare>::combine(a, b, false, false, true);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+set<Key, Allocator, Compare> set_difference(
+    const set<Key, Allocator, Compare>& a,
+    const set<Key, Allocator, Compare>& b) {
+  return set<Key, Allocator, Compare>::combine(a, b, true, false, false);
+}
+
+template <typename Key, typename Allocator, typename Compare>
+set<Key, Allocator, Compare> set_symmetric_difference(
+    const set<Key, Allocator, Compare>& a,
+    const set<Key, Allocator, Compare>& b) {
+  return set<Key, Allocator, Compare>::combine(a, b, true, true, false);
 }
 
-}  // namespace s21
\ No newline at end of file
+}  // namespace s21
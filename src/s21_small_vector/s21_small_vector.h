@@ -0,0 +1,132 @@
+#ifndef S21_SMALL_VECTOR_H
+#define S21_SMALL_VECTOR_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+#include "../s21_vector/s21_vector.h"
+#include "../s21_vector/s21_vector_ops.h"
+
+namespace s21 {
+
+// Vector that keeps up to N elements in storage embedded in the object and
+// moves them to the heap only when it grows past N. The interface matches
+// s21::vector and the iterators are the same types.
+template <typename T, std::size_t N, typename Allocator = std::allocator<T>>
+class small_vector {
+  static_assert(N > 0, "small_vector needs at least one inline slot");
+
+ public:
+  using value_type = T;
+  using allocator_type = Allocator;
+  using reference = T&;
+  using const_reference = const T&;
+  using iterator = typename s21::vector<T, Allocator>::iterator;
+  using const_iterator = typename s21::vector<T, Allocator>::const_iterator;
+  using size_type = std::size_t;
+
+  static constexpr size_type inline_capacity = N;
+
+  small_vector();
+  explicit small_vector(const allocator_type& alloc);
+  explicit small_vector(size_type n,
+                        const allocator_type& alloc = allocator_type());
+  small_vector(std::initializer_list<value_type> const& items,
+               const allocator_type& alloc = allocator_type());
+  small_vector(const small_vector& v);
+  small_vector(small_vector&& v) noexcept(
+      std::is_nothrow_move_constructible_v<value_type>);
+  ~small_vector();
+  small_vector& operator=(const small_vector& v);
+  small_vector& operator=(small_vector&& v);
+
+  allocator_type get_allocator() const;
+
+  reference at(size_type pos);
+  const_reference at(size_type pos) const;
+  reference operator[](size_type pos);
+  const_reference operator[](size_type pos) const;
+  const_reference front() const;
+  const_reference back() const;
+  value_type* data();
+  const value_type* data() const;
+
+  iterator begin();
+  const_iterator begin() const;
+  iterator end();
+  const_iterator end() const;
+
+  bool empty() const;
+  size_type size() const;
+  size_type max_size() const;
+  void reserve(size_type size);
+  size_type capacity() const;
+  void shrink_to_fit();
+
+  // true while the elements live in the embedded buffer
+  bool is_inline() const;
+
+  void clear();
+  iterator insert(const_iterator pos, const_reference value);
+  iterator insert(const_iterator pos, value_type&& value);
+  void erase(iterator pos);
+  void push_back(const_reference value);
+  void push_back(value_type&& value);
+  void pop_back();
+  void swap(small_vector& other);
+
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args);
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args);
+
+  template <typename... Args>
+  iterator insert_many(const_iterator pos, Args&&... args);
+
+  template <typename... Args>
+  void insert_many_back(Args&&... args);
+
+ private:
+  using alloc_traits = std::allocator_traits<Allocator>;
+
+  [[no_unique_address]] allocator_type _alloc;
+  value_type* _data;
+  size_type _size;
+  size_type _capacity;
+  alignas(value_type) unsigned char _inline[N * sizeof(value_type)];
+
+  value_type* inline_data();
+  const value_type* inline_data() const;
+  template <typename... Args>
+  void construct(value_type* p, Args&&... args);
+  void release_heap();
+  void move_from(small_vector& other);
+
+  size_type next_capacity(size_type min_capacity) const;
+  void reallocate(size_type new_capacity);
+
+  template <typename... Args>
+  iterator realloc_insert(size_type index, Args&&... args);
+  // grows and builds one element from each of args at index
+  template <typename... Args>
+  iterator realloc_insert_many(size_type index, Args&&... args);
+};
+
+namespace pmr {
+
+template <typename T, std::size_t N>
+using small_vector =
+    s21::small_vector<T, N, std::pmr::polymorphic_allocator<T>>;
+
+}  // namespace pmr
+
+}  // namespace s21
+
+#include "s21_small_vector.tpp"
+
+#endif
@@ -0,0 +1,492 @@
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+#include "s21_small_vector.h"
+
+namespace s21 {
+
+template <typename T, std::size_t N, typename Allocator>
+small_vector<T, N, Allocator>::small_vector()
+    : _alloc(), _data(inline_data()), _size(0), _capacity(N) {}
+
+template <typename T, std::size_t N, typename Allocator>
+small_vector<T, N, Allocator>::small_vector(const allocator_type& alloc)
+    : _alloc(alloc), _data(inline_data()), _size(0), _capacity(N) {}
+
+template <typename T, std::size_t N, typename Allocator>
+small_vector<T, N, Allocator>::small_vector(size_type n,
+                                            const allocator_type& alloc)
+    : small_vector(alloc) {
+  reserve(n);
+  try {
+    for (; _size < n; ++_size) {
+      construct(_data + _size);
+    }
+  } catch (...) {
+    clear();
+    release_heap();
+    throw;
+  }
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_vector<T, N, Allocator>::small_vector(
+    std::initializer_list<value_type> const& items, const allocator_type& alloc)
+    : small_vector(alloc) {
+  reserve(items.size());
+  try {
+    vector_ops::construct_range(_alloc, items.begin(), items.end(), _data);
+  } catch (...) {
+    release_heap();
+    throw;
+  }
+  _size = items.size();
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_vector<T, N, Allocator>::small_vector(const small_vector& v)
+    : small_vector(
+          alloc_traits::select_on_container_copy_construction(v._alloc)) {
+  reserve(v._size);
+  try {
+    vector_ops::construct_range(_alloc, v._data, v._data + v._size, _data);
+  } catch (...) {
+    release_heap();
+    throw;
+  }
+  _size = v._size;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_vector<T, N, Allocator>::small_vector(small_vector&& v) noexcept(
+    std::is_nothrow_move_constructible_v<value_type>)
+    : small_vector(std::move(v._alloc)) {
+  move_from(v);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_vector<T, N, Allocator>::~small_vector() {
+  vector_ops::destroy_range(_alloc, _data, _data + _size);
+  release_heap();
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_vector<T, N, Allocator>& small_vector<T, N, Allocator>::operator=(
+    const small_vector& v) {
+  if (this != &v) {
+    clear();
+    if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+      if (_alloc != v._alloc) {
+        release_heap();
+      }
+      _alloc = v._alloc;
+    }
+    reserve(v._size);
+    vector_ops::construct_range(_alloc, v._data, v._data + v._size, _data);
+    _size = v._size;
+  }
+  return *this;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_vector<T, N, Allocator>& small_vector<T, N, Allocator>::operator=(
+    small_vector&& v) {
+  if (this != &v) {
+    clear();
+    if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+      release_heap();
+      _alloc = std::move(v._alloc);
+    }
+    move_from(v);
+  }
+  return *this;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::allocator_type
+small_vector<T, N, Allocator>::get_allocator() const {
+  return _alloc;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::reference
+small_vector<T, N, Allocator>::at(size_type pos) {
+  if (pos >= _size) {
+    throw std::out_of_range("Index out of range");
+  }
+  return _data[pos];
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::const_reference
+small_vector<T, N, Allocator>::at(size_type pos) const {
+  if (pos >= _size) {
+    throw std::out_of_range("Index out of range");
+  }
+  return _data[pos];
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::reference
+small_vector<T, N, Allocator>::operator[](size_type pos) {
+  return _data[pos];
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::const_reference
+small_vector<T, N, Allocator>::operator[](size_type pos) const {
+  return _data[pos];
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::const_reference
+small_vector<T, N, Allocator>::front() const {
+  if (_size == 0) throw std::out_of_range("Vector is empty");
+  return _data[0];
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::const_reference
+small_vector<T, N, Allocator>::back() const {
+  if (_size == 0) throw std::out_of_range("Vector is empty");
+  return _data[_size - 1];
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::value_type*
+small_vector<T, N, Allocator>::data() {
+  return _data;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+const typename small_vector<T, N, Allocator>::value_type*
+small_vector<T, N, Allocator>::data() const {
+  return _data;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::iterator
+small_vector<T, N, Allocator>::begin() {
+  return iterator(_data);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::const_iterator
+small_vector<T, N, Allocator>::begin() const {
+  return const_iterator(_data);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::iterator
+small_vector<T, N, Allocator>::end() {
+  return iterator(_data + _size);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::const_iterator
+small_vector<T, N, Allocator>::end() const {
+  return const_iterator(_data + _size);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+bool small_vector<T, N, Allocator>::empty() const {
+  return _size == 0;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::size_type
+small_vector<T, N, Allocator>::size() const {
+  return _size;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::size_type
+small_vector<T, N, Allocator>::max_size() const {
+  return std::numeric_limits<size_type>::max() / sizeof(value_type);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::reserve(size_type new_capacity) {
+  if (new_capacity > _capacity) {
+    reallocate(new_capacity);
+  }
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::size_type
+small_vector<T, N, Allocator>::capacity() const {
+  return _capacity;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::shrink_to_fit() {
+  if (!is_inline() && _capacity > _size) {
+    reallocate(_size);
+  }
+}
+
+template <typename T, std::size_t N, typename Allocator>
+bool small_vector<T, N, Allocator>::is_inline() const {
+  return _data == inline_data();
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::clear() {
+  vector_ops::destroy_range(_alloc, _data, _data + _size);
+  _size = 0;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::iterator
+small_vector<T, N, Allocator>::insert(const_iterator pos,
+                                      const_reference value) {
+  return emplace(pos, value);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::iterator
+small_vector<T, N, Allocator>::insert(const_iterator pos, value_type&& value) {
+  return emplace(pos, std::move(value));
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::erase(iterator pos) {
+  size_type index = static_cast<size_type>(pos - begin());
+  if (index >= _size) {
+    throw std::out_of_range("Iterator out of range");
+  }
+
+  vector_ops::erase_at(_alloc, _data, _size, index);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::push_back(const_reference value) {
+  emplace_back(value);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::push_back(value_type&& value) {
+  emplace_back(std::move(value));
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::pop_back() {
+  if (_size > 0) {
+    --_size;
+    alloc_traits::destroy(_alloc, _data + _size);
+  }
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::swap(small_vector& other) {
+  if (this == &other) {
+    return;
+  }
+  if (!is_inline() && !other.is_inline()) {
+    if constexpr (alloc_traits::propagate_on_container_swap::value) {
+      std::swap(_alloc, other._alloc);
+    }
+    std::swap(_data, other._data);
+    std::swap(_size, other._size);
+    std::swap(_capacity, other._capacity);
+  } else {
+    // inline elements cannot change owner by swapping pointers
+    small_vector tmp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(tmp);
+  }
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename... Args>
+typename small_vector<T, N, Allocator>::iterator
+small_vector<T, N, Allocator>::emplace(const_iterator pos, Args&&... args) {
+  size_type index = static_cast<size_type>(pos - begin());
+  if (index > _size) {
+    throw std::out_of_range("Iterator out of range");
+  }
+
+  if (_size == _capacity) {
+    return realloc_insert(index, std::forward<Args>(args)...);
+  }
+  vector_ops::emplace_in_place(_alloc, _data, _size, index,
+                               std::forward<Args>(args)...);
+  return iterator(_data + index);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename... Args>
+typename small_vector<T, N, Allocator>::reference
+small_vector<T, N, Allocator>::emplace_back(Args&&... args) {
+  if (_size == _capacity) {
+    return *realloc_insert(_size, std::forward<Args>(args)...);
+  }
+  construct(_data + _size, std::forward<Args>(args)...);
+  return _data[_size++];
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename... Args>
+typename small_vector<T, N, Allocator>::iterator
+small_vector<T, N, Allocator>::insert_many(const_iterator pos,
+                                           Args&&... args) {
+  size_type insert_pos = static_cast<size_type>(pos - begin());
+  if (insert_pos > _size) {
+    throw std::out_of_range("Iterator out of range");
+  }
+
+  size_type num_new_elements = sizeof...(Args);
+
+  if (num_new_elements == 0) {
+    return iterator(_data + insert_pos);
+  }
+
+  if (_size + num_new_elements > _capacity) {
+    return realloc_insert_many(insert_pos, std::forward<Args>(args)...);
+  }
+  vector_ops::insert_many_in_place(_alloc, _data, _size, insert_pos,
+                                   std::forward<Args>(args)...);
+  return iterator(_data + insert_pos);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename... Args>
+void small_vector<T, N, Allocator>::insert_many_back(Args&&... args) {
+  insert_many(end(), std::forward<Args>(args)...);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::value_type*
+small_vector<T, N, Allocator>::inline_data() {
+  return reinterpret_cast<value_type*>(_inline);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+const typename small_vector<T, N, Allocator>::value_type*
+small_vector<T, N, Allocator>::inline_data() const {
+  return reinterpret_cast<const value_type*>(_inline);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename... Args>
+void small_vector<T, N, Allocator>::construct(value_type* p, Args&&... args) {
+  alloc_traits::construct(_alloc, p, std::forward<Args>(args)...);
+}
+
+// Frees the heap buffer, if any, and points back at the inline storage.
+// The elements must already be destroyed or moved out.
+template <typename T, std::size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::release_heap() {
+  if (!is_inline()) {
+    alloc_traits::deallocate(_alloc, _data, _capacity);
+    _data = inline_data();
+    _capacity = N;
+  }
+}
+
+// Takes the elements of other, which is left empty. A heap buffer is
+// adopted when the allocators allow it; inline elements are moved one by one.
+// *this must be empty.
+template <typename T, std::size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::move_from(small_vector& other) {
+  if (!other.is_inline() && _alloc == other._alloc) {
+    release_heap();
+    _data = other._data;
+    _size = other._size;
+    _capacity = other._capacity;
+    other._data = other.inline_data();
+    other._size = 0;
+    other._capacity = N;
+    return;
+  }
+  reserve(other._size);
+  vector_ops::construct_range(
+      _alloc, std::make_move_iterator(other._data),
+      std::make_move_iterator(other._data + other._size), _data);
+  _size = other._size;
+  other.clear();
+}
+
+template <typename T, std::size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::size_type
+small_vector<T, N, Allocator>::next_capacity(size_type min_capacity) const {
+  return std::max(_capacity * 2, min_capacity);
+}
+
+// Moves the elements into a buffer of new_capacity slots, or back into the
+// inline storage when they fit there.
+template <typename T, std::size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::reallocate(size_type new_capacity) {
+  bool to_inline = new_capacity <= N;
+  if (to_inline && is_inline()) {
+    return;
+  }
+  value_type* new_data = to_inline
+                             ? inline_data()
+                             : alloc_traits::allocate(_alloc, new_capacity);
+  try {
+    vector_ops::relocate(_alloc, _data, _data + _size, new_data);
+  } catch (...) {
+    if (!to_inline) alloc_traits::deallocate(_alloc, new_data, new_capacity);
+    throw;
+  }
+  vector_ops::destroy_range(_alloc, _data, _data + _size);
+  release_heap();
+  _data = new_data;
+  _capacity = to_inline ? N : new_capacity;
+}
+
+// Grows onto the heap and constructs the new element directly there. The
+// element is built before the old storage is released, so args may refer
+// into it.
+template <typename T, std::size_t N, typename Allocator>
+template <typename... Args>
+typename small_vector<T, N, Allocator>::iterator
+small_vector<T, N, Allocator>::realloc_insert(size_type index,
+                                              Args&&... args) {
+  size_type new_capacity = next_capacity(_size + 1);
+  value_type* new_data = alloc_traits::allocate(_alloc, new_capacity);
+  value_type* slot = new_data + index;
+  try {
+    construct(slot, std::forward<Args>(args)...);
+    vector_ops::relocate_around(_alloc, _data, _size, index, 1, new_data);
+  } catch (...) {
+    alloc_traits::deallocate(_alloc, new_data, new_capacity);
+    throw;
+  }
+  vector_ops::destroy_range(_alloc, _data, _data + _size);
+  release_heap();
+  _data = new_data;
+  _capacity = new_capacity;
+  ++_size;
+  return iterator(slot);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename... Args>
+typename small_vector<T, N, Allocator>::iterator
+small_vector<T, N, Allocator>::realloc_insert_many(size_type index,
+                                                   Args&&... args) {
+  constexpr size_type count = sizeof...(Args);
+  size_type new_capacity = next_capacity(_size + count);
+  value_type* new_data = alloc_traits::allocate(_alloc, new_capacity);
+  value_type* first = new_data + index;
+  try {
+    vector_ops::construct_each(_alloc, first, std::forward<Args>(args)...);
+    vector_ops::relocate_around(_alloc, _data, _size, index, count, new_data);
+  } catch (...) {
+    alloc_traits::deallocate(_alloc, new_data, new_capacity);
+    throw;
+  }
+  vector_ops::destroy_range(_alloc, _data, _data + _size);
+  release_heap();
+  _data = new_data;
+  _capacity = new_capacity;
+  _size += count;
+  return iterator(first);
+}
+
+}  // namespace s21
@@ -0,0 +1,122 @@
+#ifndef S21_MMAP_ALLOCATOR_H
+#define S21_MMAP_ALLOCATOR_H
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include "s21_vector.h"
+
+namespace s21 {
+
+// Allocator for multi-gigabyte buffers. Blocks of at least Threshold bytes
+// are anonymous private mappings advised to use transparent huge pages,
+// smaller blocks come from std::allocator. s21::vector of a trivially
+// copyable T calls reallocate(), which on Linux grows a mapped block with
+// mremap: the pages are remapped instead of copied, so growth costs
+// page-table work and never holds the old and the new buffer at once.
+template <typename T, std::size_t Threshold = std::size_t{64} << 20>
+class mmap_allocator {
+ public:
+  using value_type = T;
+  using is_always_equal = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+
+  template <typename U>
+  struct rebind {
+    using other = mmap_allocator<U, Threshold>;
+  };
+
+  static constexpr std::size_t threshold = Threshold;
+
+  mmap_allocator() = default;
+  template <typename U>
+  mmap_allocator(const mmap_allocator<U, Threshold>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    std::size_t bytes = n * sizeof(T);
+    if (!is_mapped(n)) {
+      return std::allocator<T>().allocate(n);
+    }
+    void* p = mmap(nullptr, map_size(bytes), PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    advise(p, map_size(bytes));
+    return static_cast<T*>(p);
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    if (is_mapped(n)) {
+      munmap(p, map_size(n * sizeof(T)));
+    } else {
+      std::allocator<T>().deallocate(p, n);
+    }
+  }
+
+  // Resizes block p of old_n elements to new_n elements and returns its
+  // address, which may change. The bytes of the first min(old_n, new_n)
+  // elements are kept, so T has to be trivially copyable.
+  T* reallocate(T* p, std::size_t old_n, std::size_t new_n) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "mmap_allocator::reallocate moves raw bytes");
+#if defined(__linux__)
+    if (is_mapped(old_n) && is_mapped(new_n)) {
+      std::size_t old_size = map_size(old_n * sizeof(T));
+      std::size_t new_size = map_size(new_n * sizeof(T));
+      if (old_size == new_size) {
+        return p;
+      }
+      void* q = mremap(p, old_size, new_size, MREMAP_MAYMOVE);
+      if (q == MAP_FAILED) {
+        throw std::bad_alloc();
+      }
+      advise(q, new_size);
+      return static_cast<T*>(q);
+    }
+#endif
+    T* q = allocate(new_n);
+    std::memcpy(static_cast<void*>(q), p,
+                std::min(old_n, new_n) * sizeof(T));
+    deallocate(p, old_n);
+    return q;
+  }
+
+  // true when a block of n elements is served by mmap
+  static bool is_mapped(std::size_t n) { return n * sizeof(T) >= Threshold; }
+
+ private:
+  static std::size_t map_size(std::size_t bytes) {
+    static const std::size_t page = sysconf(_SC_PAGESIZE);
+    return (bytes + page - 1) / page * page;
+  }
+
+  static void advise([[maybe_unused]] void* p,
+                     [[maybe_unused]] std::size_t length) {
+#if defined(MADV_HUGEPAGE)
+    // only a hint: kernels without THP reject it and nothing changes
+    madvise(p, length, MADV_HUGEPAGE);
+#endif
+  }
+};
+
+template <typename T, typename U, std::size_t Threshold>
+bool operator==(const mmap_allocator<T, Threshold>&,
+                const mmap_allocator<U, Threshold>&) noexcept {
+  return true;
+}
+
+// vector whose large buffers live in huge-page mappings and grow in place
+template <typename T, typename Growth = growth::doubling>
+using huge_vector = vector<T, mmap_allocator<T>, Growth>;
+
+}  // namespace s21
+
+#endif
@@ -1,33 +1,135 @@
 #ifndef S21_VECTOR_H
 #define S21_VECTOR_H
 
+#include <concepts>
+#include <compare>
 #include <cstddef>
 #include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <type_traits>
 #include <utility>
 
+#include "s21_vector_ops.h"
+
 namespace s21 {
 
-template <typename T>
+// Growth policies decide how much room a vector asks for once it is full.
+// grow() receives the current capacity, the number of slots that must fit
+// and the element size, and returns a capacity of at least min_capacity.
+// A policy tuned to one allocator says so with a member template
+// supports<Allocator>; vector rejects the others at compile time.
+namespace growth {
+
+template <typename Growth, typename Allocator>
+concept suits = !requires { Growth::template supports<Allocator>; } ||
+                Growth::template supports<Allocator>;
+
+// Classic geometric growth: few reallocations, up to half the buffer idle.
+struct doubling {
+  static std::size_t grow(std::size_t capacity, std::size_t min_capacity,
+                          std::size_t /*element_size*/) {
+    std::size_t grown = capacity == 0 ? 1 : capacity * 2;
+    return grown > min_capacity ? grown : min_capacity;
+  }
+};
+
+// 1.5x growth: at most a third of the buffer idle, and after a couple of
+// steps the blocks freed earlier add up to the next request, so the
+// allocator can reuse them.
+struct one_and_half {
+  static std::size_t grow(std::size_t capacity, std::size_t min_capacity,
+                          std::size_t /*element_size*/) {
+    std::size_t grown = capacity < 2 ? capacity + 1 : capacity + capacity / 2;
+    return grown > min_capacity ? grown : min_capacity;
+  }
+};
+
+// Estimate of the bytes glibc malloc leaves usable for a request of
+// `bytes` under its default tuning on 64-bit targets: small requests are
+// padded to 16-byte chunks with an 8-byte header, requests above the
+// initial 128 KiB mmap threshold get whole pages with a 16-byte header.
+// It is not malloc_usable_size: glibc raises the threshold at run time and
+// may hand out a reused chunk that is larger still.
+constexpr std::size_t glibc_size_class_bytes(std::size_t bytes) {
+  constexpr std::size_t kMmapThreshold = 128 * 1024;
+  constexpr std::size_t kPage = 4096;
+  if (bytes >= kMmapThreshold) {
+    return ((bytes + 16 + kPage - 1) & ~(kPage - 1)) - 16;
+  }
+  std::size_t chunk = (bytes + 8 + 15) & ~std::size_t{15};
+  return (chunk < 32 ? 32 : chunk) - 8;
+}
+
+// 1.5x growth rounded up to the estimated glibc size class, so the padding
+// malloc hands out anyway becomes capacity instead of dead space. Only
+// std::allocator is known to end in malloc, so no other allocator may use
+// it, and off glibc it is plain 1.5x growth. The vector always asks for
+// the whole rounded capacity, so a wrong estimate wastes bytes but never
+// overruns the block.
+struct usable_size {
+  template <typename Allocator>
+  static constexpr bool supports = std::is_same_v<
+      Allocator, std::allocator<typename Allocator::value_type>>;
+
+  static std::size_t grow(std::size_t capacity, std::size_t min_capacity,
+                          std::size_t element_size) {
+    std::size_t wanted =
+        one_and_half::grow(capacity, min_capacity, element_size);
+#if defined(__GLIBC__)
+    if (wanted <= std::numeric_limits<std::size_t>::max() / element_size) {
+      return glibc_size_class_bytes(wanted * element_size) / element_size;
+    }
+#endif
+    return wanted;
+  }
+};
+
+}  // namespace growth
+
+template <typename T, typename Allocator = std::allocator<T>,
+          typename Growth = growth::doubling>
 class vector {
  public:
   class VectorIterator;
   class VectorConstIterator;
 
   using value_type = T;
+  using allocator_type = Allocator;
   using reference = T&;
   using const_reference = const T&;
   using iterator = VectorIterator;
   using const_iterator = VectorConstIterator;
   using size_type = std::size_t;
 
+ private:
+  using alloc_traits = std::allocator_traits<Allocator>;
+
+  static_assert(growth::suits<Growth, Allocator>,
+                "the growth policy does not support this allocator");
+
+  static constexpr bool nothrow_move_assign =
+      alloc_traits::propagate_on_container_move_assignment::value ||
+      alloc_traits::is_always_equal::value;
+
+ public:
   vector();
-  explicit vector(size_type n);
-  vector(std::initializer_list<value_type> const& items);
+  explicit vector(const allocator_type& alloc);
+  explicit vector(size_type n, const allocator_type& alloc = allocator_type());
+  vector(std::initializer_list<value_type> const& items,
+         const allocator_type& alloc = allocator_type());
   vector(const vector& v);
-  vector(vector&& v);
+  vector(const vector& v, const allocator_type& alloc);
+  vector(vector&& v) noexcept;
+  vector(vector&& v, const allocator_type& alloc);
   ~vector();
   vector& operator=(const vector& v);
-  vector& operator=(vector&& v);
+  vector& operator=(vector&& v) noexcept(nothrow_move_assign);
+
+  allocator_type get_allocator() const;
 
   reference at(size_type pos);
   const_reference at(size_type pos) const;
@@ -50,12 +152,31 @@ class vector {
   size_type capacity() const;
   void shrink_to_fit();
 
+  // allocated slots that hold no element, i.e. capacity() - size()
+  size_type wasted_capacity() const;
+
   void clear();
   iterator insert(const_iterator pos, const_reference value);
+  iterator insert(const_iterator pos, value_type&& value);
+  iterator insert(const_iterator pos, std::initializer_list<value_type> items);
+  // Inserts [first, last) before pos with at most one reallocation when
+  // the range can be measured up front and one shift of the tail when it
+  // can also be read twice; a single pass range is appended and rotated
+  // into place. The range must not point into this vector.
+  template <std::input_iterator InputIt>
+  iterator insert(const_iterator pos, InputIt first, InputIt last);
   void erase(iterator pos);
+  iterator erase(const_iterator first, const_iterator last);
   void push_back(const_reference value);
+  void push_back(value_type&& value);
   void pop_back();
-  void swap(vector& other);
+  void swap(vector& other) noexcept;
+
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args);
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args);
 
   template <typename... Args>
   iterator insert_many(const_iterator pos, Args&&... args);
@@ -63,23 +184,95 @@ class vector {
   template <typename... Args>
   void insert_many_back(Args&&... args);
 
+  template <std::ranges::input_range Range>
+  void append_range(Range&& range);
+
+  // replace the contents, reusing the buffer when it is large enough
+  void assign(size_type n, const_reference value);
+  template <std::input_iterator InputIt>
+  void assign(InputIt first, InputIt last);
+  void assign(std::initializer_list<value_type> items);
+
  private:
+  [[no_unique_address]] allocator_type _alloc;
   value_type* _data;
   size_type _size;
   size_type _capacity;
+
+  // _data points to raw storage: only [0, _size) holds live objects,
+  // [_size, _capacity) is uninitialized memory. Elements are built and
+  // destroyed through the allocator, so scoped allocators (std::pmr) pass
+  // their resource down to the elements.
+
+  // trivially copyable elements are shifted and relocated with memmove/memcpy
+  static constexpr bool trivially_copyable =
+      std::is_trivially_copyable_v<value_type>;
+
+  // Ranges that can be measured before they are read: forward iterators,
+  // iterators whose C++17 category is forward or better (std::move_iterator
+  // over a pointer is only an input iterator in C++20 terms) and iterators
+  // with a sized sentinel. Only multipass ranges may be read twice.
+  template <typename It>
+  static constexpr bool multipass =
+      std::forward_iterator<It> || requires {
+        requires std::derived_from<
+            typename std::iterator_traits<It>::iterator_category,
+            std::forward_iterator_tag>;
+      };
+  template <typename It>
+  static constexpr bool measurable =
+      multipass<It> || std::sized_sentinel_for<It, It>;
+
+  // allocators that can resize a block themselves (s21::mmap_allocator) grow
+  // trivially copyable buffers without an allocate + copy round trip
+  static constexpr bool resizes_in_place =
+      trivially_copyable &&
+      requires(Allocator& a, value_type* p, size_type n) {
+        { a.reallocate(p, n, n) } -> std::same_as<value_type*>;
+      };
+
+  value_type* allocate(size_type n);
+  void deallocate(value_type* p, size_type n);
+  template <typename... Args>
+  void construct(value_type* p, Args&&... args);
+  void release();
+  void steal(vector& other) noexcept;
+  template <typename InputIt>
+  static size_type range_length(InputIt first, InputIt last);
+
+  size_type next_capacity(size_type min_capacity) const;
+  void reallocate(size_type new_capacity);
+
+  template <typename... Args>
+  iterator realloc_insert(size_type index, Args&&... args);
+  // grows and builds one element from each of args at index
+  template <typename... Args>
+  iterator realloc_insert_many(size_type index, Args&&... args);
 };
 
-template <typename T>
-class vector<T>::VectorIterator {
+// Both iterators are contiguous iterators in the C++20 sense, so the
+// standard algorithms take their random-access and memmove paths and
+// std::to_address(it) yields the element pointer.
+template <typename T, typename Allocator, typename Growth>
+class vector<T, Allocator, Growth>::VectorIterator {
  private:
   T* ptr_;
   friend class VectorConstIterator;
 
  public:
+  using iterator_category = std::random_access_iterator_tag;
+  using iterator_concept = std::contiguous_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T*;
+  using reference = T&;
+
   VectorIterator() : ptr_(nullptr) {}
   explicit VectorIterator(T* ptr) : ptr_(ptr) {}
 
   T& operator*() const { return *ptr_; }
+  T* operator->() const { return ptr_; }
+  T& operator[](difference_type n) const { return ptr_[n]; }
 
   VectorIterator& operator++() {
     ++ptr_;
@@ -92,7 +285,7 @@ class vector<T>::VectorIterator {
     return temp;
   }
 
-  VectorIterator& operator+=(int n) {
+  VectorIterator& operator+=(difference_type n) {
     ptr_ += n;
     return *this;
   }
@@ -108,39 +301,49 @@ class vector<T>::VectorIterator {
     return temp;
   }
 
-  VectorIterator& operator-=(int n) {
+  VectorIterator& operator-=(difference_type n) {
     ptr_ -= n;
     return *this;
   }
 
-  bool operator==(const VectorIterator& other) const {
-    return ptr_ == other.ptr_;
-  }
-  bool operator!=(const VectorIterator& other) const {
-    return ptr_ != other.ptr_;
-  }
+  bool operator==(const VectorIterator& other) const = default;
+  auto operator<=>(const VectorIterator& other) const = default;
 
-  std::ptrdiff_t operator-(const VectorIterator& other) const {
+  difference_type operator-(const VectorIterator& other) const {
     return ptr_ - other.ptr_;
   }
 
-  operator T*() const { return ptr_; }
-
-  VectorIterator operator+(int n) const { return VectorIterator(ptr_ + n); }
-  VectorIterator operator-(int n) const { return VectorIterator(ptr_ - n); }
+  VectorIterator operator+(difference_type n) const {
+    return VectorIterator(ptr_ + n);
+  }
+  VectorIterator operator-(difference_type n) const {
+    return VectorIterator(ptr_ - n);
+  }
+  friend VectorIterator operator+(difference_type n, const VectorIterator& it) {
+    return it + n;
+  }
 };
 
-template <typename T>
-class vector<T>::VectorConstIterator {
+template <typename T, typename Allocator, typename Growth>
+class vector<T, Allocator, Growth>::VectorConstIterator {
  private:
   const T* ptr_;
 
  public:
+  using iterator_category = std::random_access_iterator_tag;
+  using iterator_concept = std::contiguous_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const T*;
+  using reference = const T&;
+
   VectorConstIterator() : ptr_(nullptr) {}
   explicit VectorConstIterator(const T* ptr) : ptr_(ptr) {}
   VectorConstIterator(const VectorIterator& other) : ptr_(other.ptr_) {}
 
   const T& operator*() const { return *ptr_; }
+  const T* operator->() const { return ptr_; }
+  const T& operator[](difference_type n) const { return ptr_[n]; }
 
   VectorConstIterator& operator++() {
     ++ptr_;
@@ -153,7 +356,7 @@ class vector<T>::VectorConstIterator {
     return temp;
   }
 
-  VectorConstIterator& operator+=(int n) {
+  VectorConstIterator& operator+=(difference_type n) {
     ptr_ += n;
     return *this;
   }
@@ -169,32 +372,43 @@ class vector<T>::VectorConstIterator {
     return temp;
   }
 
-  VectorConstIterator& operator-=(int n) {
+  VectorConstIterator& operator-=(difference_type n) {
     ptr_ -= n;
     return *this;
   }
 
-  bool operator==(const VectorConstIterator& other) const {
-    return ptr_ == other.ptr_;
-  }
-  bool operator!=(const VectorConstIterator& other) const {
-    return ptr_ != other.ptr_;
-  }
+  bool operator==(const VectorConstIterator& other) const = default;
+  auto operator<=>(const VectorConstIterator& other) const = default;
 
-  std::ptrdiff_t operator-(const VectorConstIterator& other) const {
+  difference_type operator-(const VectorConstIterator& other) const {
     return ptr_ - other.ptr_;
   }
 
-  operator const T*() const { return ptr_; }
-
-  VectorConstIterator operator+(int n) const {
+  VectorConstIterator operator+(difference_type n) const {
     return VectorConstIterator(ptr_ + n);
   }
-  VectorConstIterator operator-(int n) const {
+  VectorConstIterator operator-(difference_type n) const {
     return VectorConstIterator(ptr_ - n);
   }
+  friend VectorConstIterator operator+(difference_type n,
+                                       const VectorConstIterator& it) {
+    return it + n;
+  }
 };
 
+// Removes the elements matching pred in one compacting pass and returns how
+// many were removed.
+template <typename T, typename Allocator, typename Growth, typename Pred>
+typename vector<T, Allocator, Growth>::size_type erase_if(
+    vector<T, Allocator, Growth>& v, Pred pred);
+
+namespace pmr {
+
+template <typename T>
+using vector = s21::vector<T, std::pmr::polymorphic_allocator<T>>;
+
+}  // namespace pmr
+
 }  // namespace s21
 
 #include "s21_vector.tpp"
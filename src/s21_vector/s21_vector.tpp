@@ -1,282 +1,475 @@
 #include <algorithm>
 #include <cstring>
 #include <limits>
+#include <iterator>
+#include <memory>
 #include <stdexcept>
 
 #include "s21_vector.h"
 
 namespace s21 {
 
-template <typename T>
-vector<T>::vector() : _data(nullptr), _size(0), _capacity(0) {}
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector()
+    : _alloc(), _data(nullptr), _size(0), _capacity(0) {}
 
-template <typename T>
-vector<T>::vector(size_type n) : _size(n), _capacity(n) {
-  if (n > 0) {
-    _data = new value_type[n]();
-  } else {
-    _data = nullptr;
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector(const allocator_type& alloc)
+    : _alloc(alloc), _data(nullptr), _size(0), _capacity(0) {}
+
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector(size_type n, const allocator_type& alloc)
+    : _alloc(alloc), _data(allocate(n)), _size(0), _capacity(n) {
+  try {
+    for (; _size < n; ++_size) {
+      construct(_data + _size);
+    }
+  } catch (...) {
+    release();
+    throw;
   }
 }
 
-template <typename T>
-vector<T>::vector(std::initializer_list<value_type> const& items)
-    : _size(items.size()), _capacity(items.size()) {
-  if (_size > 0) {
-    _data = new value_type[_capacity];
-    std::copy(items.begin(), items.end(), _data);
-  } else {
-    _data = nullptr;
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector(
+    std::initializer_list<value_type> const& items, const allocator_type& alloc)
+    : _alloc(alloc),
+      _data(allocate(items.size())),
+      _size(0),
+      _capacity(items.size()) {
+  try {
+    vector_ops::construct_range(_alloc, items.begin(), items.end(), _data);
+  } catch (...) {
+    deallocate(_data, _capacity);
+    throw;
   }
+  _size = items.size();
 }
 
-template <typename T>
-vector<T>::vector(const vector& v) : _size(v._size), _capacity(v._capacity) {
-  if (_capacity > 0) {
-    _data = new value_type[_capacity];
-    std::copy(v._data, v._data + _size, _data);
-  } else {
-    _data = nullptr;
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector(const vector& v)
+    : vector(v, alloc_traits::select_on_container_copy_construction(v._alloc)) {
+}
+
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector(const vector& v,
+                                     const allocator_type& alloc)
+    : _alloc(alloc), _data(allocate(v._capacity)), _size(0),
+      _capacity(v._capacity) {
+  try {
+    vector_ops::construct_range(_alloc, v._data, v._data + v._size, _data);
+  } catch (...) {
+    deallocate(_data, _capacity);
+    throw;
   }
+  _size = v._size;
 }
 
-template <typename T>
-vector<T>::vector(vector&& v)
-    : _data(v._data), _size(v._size), _capacity(v._capacity) {
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector(vector&& v) noexcept
+    : _alloc(std::move(v._alloc)),
+      _data(v._data),
+      _size(v._size),
+      _capacity(v._capacity) {
   v._data = nullptr;
   v._size = 0;
   v._capacity = 0;
 }
 
-template <typename T>
-vector<T>::~vector() {
-  delete[] _data;
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector(vector&& v, const allocator_type& alloc)
+    : _alloc(alloc), _data(nullptr), _size(0), _capacity(0) {
+  if (_alloc == v._alloc) {
+    steal(v);
+  } else if (v._size > 0) {
+    _data = allocate(v._size);
+    _capacity = v._size;
+    try {
+      vector_ops::construct_range(_alloc, std::make_move_iterator(v._data),
+                                  std::make_move_iterator(v._data + v._size),
+                                  _data);
+    } catch (...) {
+      deallocate(_data, _capacity);
+      throw;
+    }
+    _size = v._size;
+    v.clear();
+  }
+}
+
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::~vector() {
+  release();
 }
 
-template <typename T>
-vector<T>& vector<T>::operator=(const vector& v) {
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>& vector<T, Allocator, Growth>::operator=(
+    const vector& v) {
   if (this != &v) {
-    delete[] _data;
-    _size = v._size;
-    _capacity = v._capacity;
-    if (_capacity > 0) {
-      _data = new value_type[_capacity];
-      std::copy(v._data, v._data + _size, _data);
-    } else {
-      _data = nullptr;
+    if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+      if (_alloc != v._alloc) {
+        release();
+      }
+      _alloc = v._alloc;
     }
+    vector tmp(v, _alloc);
+    swap(tmp);
   }
   return *this;
 }
 
-template <typename T>
-vector<T>& vector<T>::operator=(vector&& v) {
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>& vector<T, Allocator, Growth>::operator=(
+    vector&& v) noexcept(nothrow_move_assign) {
   if (this != &v) {
-    delete[] _data;
-    _data = v._data;
-    _size = v._size;
-    _capacity = v._capacity;
-    v._data = nullptr;
-    v._size = 0;
-    v._capacity = 0;
+    if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+      release();
+      _alloc = std::move(v._alloc);
+      steal(v);
+    } else if (_alloc == v._alloc) {
+      release();
+      steal(v);
+    } else {
+      // storage of v cannot be adopted: move the elements one by one
+      vector tmp(std::move(v), _alloc);
+      swap(tmp);
+    }
   }
   return *this;
 }
 
-template <typename T>
-typename vector<T>::reference vector<T>::at(size_type pos) {
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::allocator_type
+vector<T, Allocator, Growth>::get_allocator() const {
+  return _alloc;
+}
+
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::reference
+vector<T, Allocator, Growth>::at(size_type pos) {
   if (pos >= _size) {
     throw std::out_of_range("Index out of range");
   }
   return _data[pos];
 }
 
-template <typename T>
-typename vector<T>::const_reference vector<T>::at(size_type pos) const {
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::const_reference
+vector<T, Allocator, Growth>::at(size_type pos) const {
   if (pos >= _size) {
     throw std::out_of_range("Index out of range");
   }
   return _data[pos];
 }
 
-template <typename T>
-typename vector<T>::reference vector<T>::operator[](size_type pos) {
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::reference
+vector<T, Allocator, Growth>::operator[](size_type pos) {
   return _data[pos];
 }
 
-template <typename T>
-typename vector<T>::const_reference vector<T>::operator[](size_type pos) const {
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::const_reference
+vector<T, Allocator, Growth>::operator[](size_type pos) const {
   return _data[pos];
 }
 
-template <typename T>
-typename vector<T>::const_reference vector<T>::front() const {
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::const_reference
+vector<T, Allocator, Growth>::front() const {
   if (_size == 0) throw std::out_of_range("Vector is empty");
   return _data[0];
 }
 
-template <typename T>
-typename vector<T>::const_reference vector<T>::back() const {
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::const_reference
+vector<T, Allocator, Growth>::back() const {
   if (_size == 0) throw std::out_of_range("Vector is empty");
   return _data[_size - 1];
 }
 
-template <typename T>
-typename vector<T>::value_type* vector<T>::data() {
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::value_type*
+vector<T, Allocator, Growth>::data() {
   return _data;
 }
 
-template <typename T>
-const typename vector<T>::value_type* vector<T>::data() const {
+template <typename T, typename Allocator, typename Growth>
+const typename vector<T, Allocator, Growth>::value_type*
+vector<T, Allocator, Growth>::data() const {
   return _data;
 }
 
-template <typename T>
-vector<T>::iterator vector<T>::begin() {
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::begin() {
   return iterator(_data);
 }
 
-template <typename T>
-vector<T>::const_iterator vector<T>::begin() const {
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::const_iterator
+vector<T, Allocator, Growth>::begin() const {
   return const_iterator(_data);
 }
 
-template <typename T>
-vector<T>::iterator vector<T>::end() {
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::end() {
   return iterator(_data + _size);
 }
 
-template <typename T>
-vector<T>::const_iterator vector<T>::end() const {
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::const_iterator vector<T, Allocator, Growth>::end()
+    const {
   return const_iterator(_data + _size);
 }
 
-template <typename T>
-bool vector<T>::empty() const {
+template <typename T, typename Allocator, typename Growth>
+bool vector<T, Allocator, Growth>::empty() const {
   return _size == 0;
 }
 
-template <typename T>
-typename vector<T>::size_type vector<T>::size() const {
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::size_type
+vector<T, Allocator, Growth>::size() const {
   return _size;
 }
 
-template <typename T>
-typename vector<T>::size_type vector<T>::max_size() const {
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::size_type
+vector<T, Allocator, Growth>::max_size() const {
   return std::numeric_limits<size_type>::max() / sizeof(value_type);
 }
 
-template <typename T>
-void vector<T>::reserve(size_type new_capacity) {
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::reserve(size_type new_capacity) {
   if (new_capacity > _capacity) {
-    value_type* new_data = new value_type[new_capacity];
-    if (_data) {
-      std::copy(_data, _data + _size, new_data);
-      delete[] _data;
-    }
-    _data = new_data;
-    _capacity = new_capacity;
+    reallocate(new_capacity);
   }
 }
 
-template <typename T>
-typename vector<T>::size_type vector<T>::capacity() const {
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::size_type
+vector<T, Allocator, Growth>::capacity() const {
   return _capacity;
 }
 
-template <typename T>
-void vector<T>::shrink_to_fit() {
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::shrink_to_fit() {
   if (_capacity > _size) {
-    if (_size == 0) {
-      delete[] _data;
-      _data = nullptr;
-      _capacity = 0;
-    } else {
-      value_type* new_data = new value_type[_size];
-      std::copy(_data, _data + _size, new_data);
-      delete[] _data;
-      _data = new_data;
-      _capacity = _size;
-    }
+    reallocate(_size);
   }
 }
 
-template <typename T>
-void vector<T>::clear() {
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::size_type
+vector<T, Allocator, Growth>::wasted_capacity() const {
+  return _capacity - _size;
+}
+
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::clear() {
+  vector_ops::destroy_range(_alloc, _data, _data + _size);
   _size = 0;
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::insert(const_iterator pos,
-                                               const_reference value) {
-  size_type index = pos - _data;
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator
+vector<T, Allocator, Growth>::insert(const_iterator pos,
+                                     const_reference value) {
+  return emplace(pos, value);
+}
+
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator
+vector<T, Allocator, Growth>::insert(const_iterator pos, value_type&& value) {
+  return emplace(pos, std::move(value));
+}
+
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator
+vector<T, Allocator, Growth>::insert(const_iterator pos,
+                                     std::initializer_list<value_type> items) {
+  return insert(pos, items.begin(), items.end());
+}
+
+template <typename T, typename Allocator, typename Growth>
+template <std::input_iterator InputIt>
+typename vector<T, Allocator, Growth>::iterator
+vector<T, Allocator, Growth>::insert(const_iterator pos, InputIt first,
+                                     InputIt last) {
+  size_type index = static_cast<size_type>(pos - begin());
   if (index > _size) {
     throw std::out_of_range("Iterator out of range");
   }
 
-  if (_size == _capacity) {
-    size_type new_capacity = _capacity == 0 ? 1 : _capacity * 2;
-    reserve(new_capacity);
-  }
+  if constexpr (!multipass<InputIt>) {
+    // a single pass range is read once: appended, then rotated into place;
+    // when its length is known the vector grows at most once
+    if constexpr (measurable<InputIt>) {
+      size_type count = range_length(first, last);
+      if (_size + count > _capacity) {
+        reserve(next_capacity(_size + count));
+      }
+    }
+    size_type old_size = _size;
+    for (; first != last; ++first) {
+      emplace_back(*first);
+    }
+    std::rotate(_data + index, _data + old_size, _data + _size);
+    return iterator(_data + index);
+  } else {
+    size_type count = range_length(first, last);
+    if (count == 0) {
+      return iterator(_data + index);
+    }
 
-  for (size_type i = _size; i > index; --i) {
-    _data[i] = _data[i - 1];
-  }
+    if (_size + count > _capacity) {
+      size_type new_capacity = next_capacity(_size + count);
+      value_type* new_data = allocate(new_capacity);
+      value_type* slot = new_data + index;
+      try {
+        vector_ops::construct_range(_alloc, first, last, slot);
+        vector_ops::relocate_around(_alloc, _data, _size, index, count,
+                                    new_data);
+      } catch (...) {
+        deallocate(new_data, new_capacity);
+        throw;
+      }
+      vector_ops::destroy_range(_alloc, _data, _data + _size);
+      deallocate(_data, _capacity);
+      _data = new_data;
+      _capacity = new_capacity;
+      _size += count;
+      return iterator(slot);
+    }
 
-  _data[index] = value;
-  ++_size;
-  return iterator(_data + index);
+    // in place: the tail is shifted once, the part that lands past the old
+    // end goes to raw storage; the size covers every built slot before the
+    // range is copied over the moved-from ones
+    value_type* old_end = _data + _size;
+    size_type tail = _size - index;
+    if constexpr (trivially_copyable) {
+      std::memmove(static_cast<void*>(_data + index + count), _data + index,
+                   tail * sizeof(value_type));
+      _size += count;
+      std::copy(first, last, _data + index);
+    } else if (tail > count) {
+      vector_ops::construct_range(_alloc,
+                                  std::make_move_iterator(old_end - count),
+                                  std::make_move_iterator(old_end), old_end);
+      _size += count;
+      std::move_backward(_data + index, old_end - count, old_end);
+      std::copy(first, last, _data + index);
+    } else {
+      InputIt mid = std::next(first, static_cast<std::ptrdiff_t>(tail));
+      vector_ops::construct_range(_alloc, mid, last, old_end);
+      try {
+        vector_ops::construct_range(_alloc,
+                                    std::make_move_iterator(_data + index),
+                                    std::make_move_iterator(old_end),
+                                    old_end + (count - tail));
+      } catch (...) {
+        vector_ops::destroy_range(_alloc, old_end, old_end + (count - tail));
+        throw;
+      }
+      _size += count;
+      std::copy(first, mid, _data + index);
+    }
+    return iterator(_data + index);
+  }
 }
 
-template <typename T>
-void vector<T>::erase(iterator pos) {
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::erase(iterator pos) {
   size_type index = static_cast<size_type>(pos - begin());
   if (index >= _size) {
     throw std::out_of_range("Iterator out of range");
   }
 
-  for (size_type i = index; i < _size - 1; ++i) {
-    _data[i] = _data[i + 1];
-  }
-  --_size;
+  vector_ops::erase_at(_alloc, _data, _size, index);
 }
 
-template <typename T>
-void vector<T>::push_back(const_reference value) {
-  if (_size == _capacity) {
-    size_type new_capacity = _capacity == 0 ? 1 : _capacity * 2;
-    reserve(new_capacity);
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator
+vector<T, Allocator, Growth>::erase(const_iterator first, const_iterator last) {
+  size_type index = static_cast<size_type>(first - begin());
+  size_type stop = static_cast<size_type>(last - begin());
+  if (index > stop || stop > _size) {
+    throw std::out_of_range("Iterator out of range");
   }
-  _data[_size++] = value;
+
+  size_type count = stop - index;
+  if constexpr (trivially_copyable) {
+    std::memmove(static_cast<void*>(_data + index), _data + stop,
+                 (_size - stop) * sizeof(value_type));
+  } else {
+    std::move(_data + stop, _data + _size, _data + index);
+    vector_ops::destroy_range(_alloc, _data + _size - count, _data + _size);
+  }
+  _size -= count;
+  return iterator(_data + index);
+}
+
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::push_back(const_reference value) {
+  emplace_back(value);
+}
+
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::push_back(value_type&& value) {
+  emplace_back(std::move(value));
 }
 
-template <typename T>
-void vector<T>::pop_back() {
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::pop_back() {
   if (_size > 0) {
     --_size;
+    alloc_traits::destroy(_alloc, _data + _size);
   }
 }
 
-template <typename T>
-void vector<T>::swap(vector& other) {
-  value_type* temp_data = _data;
-  _data = other._data;
-  other._data = temp_data;
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::swap(vector& other) noexcept {
+  if constexpr (alloc_traits::propagate_on_container_swap::value) {
+    std::swap(_alloc, other._alloc);
+  }
+  std::swap(_data, other._data);
+  std::swap(_size, other._size);
+  std::swap(_capacity, other._capacity);
+}
 
-  size_type temp_size = _size;
-  _size = other._size;
-  other._size = temp_size;
+template <typename T, typename Allocator, typename Growth>
+template <typename... Args>
+typename vector<T, Allocator, Growth>::iterator
+vector<T, Allocator, Growth>::emplace(const_iterator pos, Args&&... args) {
+  size_type index = static_cast<size_type>(pos - begin());
+  if (index > _size) {
+    throw std::out_of_range("Iterator out of range");
+  }
 
-  size_type temp_capacity = _capacity;
-  _capacity = other._capacity;
-  other._capacity = temp_capacity;
+  if (_size == _capacity) {
+    return realloc_insert(index, std::forward<Args>(args)...);
+  }
+  vector_ops::emplace_in_place(_alloc, _data, _size, index,
+                               std::forward<Args>(args)...);
+  return iterator(_data + index);
 }
 
-template <typename T>
+template <typename T, typename Allocator, typename Growth>
 template <typename... Args>
-typename vector<T>::iterator vector<T>::insert_many(const_iterator pos,
-                                                    Args&&... args) {
-  size_type insert_pos = pos - _data;
+typename vector<T, Allocator, Growth>::reference
+vector<T, Allocator, Growth>::emplace_back(Args&&... args) {
+  if (_size == _capacity) {
+    return *realloc_insert(_size, std::forward<Args>(args)...);
+  }
+  construct(_data + _size, std::forward<Args>(args)...);
+  return _data[_size++];
+}
+
+template <typename T, typename Allocator, typename Growth>
+template <typename... Args>
+typename vector<T, Allocator, Growth>::iterator
+vector<T, Allocator, Growth>::insert_many(const_iterator pos, Args&&... args) {
+  size_type insert_pos = static_cast<size_type>(pos - begin());
   if (insert_pos > _size) {
     throw std::out_of_range("Iterator out of range");
   }
@@ -288,41 +481,265 @@ typename vector<T>::iterator vector<T>::insert_many(const_iterator pos,
   }
 
   if (_size + num_new_elements > _capacity) {
-    size_type new_capacity = std::max(_capacity * 2, _size + num_new_elements);
-    reserve(new_capacity);
+    return realloc_insert_many(insert_pos, std::forward<Args>(args)...);
+  }
+  vector_ops::insert_many_in_place(_alloc, _data, _size, insert_pos,
+                                   std::forward<Args>(args)...);
+  return iterator(_data + insert_pos);
+}
+
+template <typename T, typename Allocator, typename Growth>
+template <typename... Args>
+void vector<T, Allocator, Growth>::insert_many_back(Args&&... args) {
+  insert_many(end(), std::forward<Args>(args)...);
+}
+
+template <typename T, typename Allocator, typename Growth>
+template <std::ranges::input_range Range>
+void vector<T, Allocator, Growth>::append_range(Range&& range) {
+  if constexpr (std::ranges::forward_range<Range> ||
+                std::ranges::sized_range<Range>) {
+    size_type count = static_cast<size_type>(std::ranges::distance(range));
+    if (_size + count > _capacity) {
+      reserve(next_capacity(_size + count));
+    }
+  }
+  for (auto&& item : range) {
+    emplace_back(std::forward<decltype(item)>(item));
   }
+}
 
-  if (insert_pos < _size) {
-    for (size_type i = _size; i > insert_pos; --i) {
-      _data[i + num_new_elements - 1] = std::move(_data[i - 1]);
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::assign(size_type n, const_reference value) {
+  if (n > _capacity) {
+    // value may be one of the elements, so the old buffer goes last
+    value_type* new_data = allocate(n);
+    size_type built = 0;
+    try {
+      for (; built < n; ++built) {
+        construct(new_data + built, value);
+      }
+    } catch (...) {
+      vector_ops::destroy_range(_alloc, new_data, new_data + built);
+      deallocate(new_data, n);
+      throw;
+    }
+    release();
+    _data = new_data;
+    _capacity = n;
+  } else if (n > _size) {
+    std::fill(_data, _data + _size, value);
+    for (; _size < n; ++_size) {
+      construct(_data + _size, value);
     }
+  } else {
+    std::fill(_data, _data + n, value);
+    vector_ops::destroy_range(_alloc, _data + n, _data + _size);
   }
+  _size = n;
+}
 
-  size_type i = 0;
-  ((_data[insert_pos + i++] = std::forward<Args>(args)), ...);
+template <typename T, typename Allocator, typename Growth>
+template <std::input_iterator InputIt>
+void vector<T, Allocator, Growth>::assign(InputIt first, InputIt last) {
+  if constexpr (!multipass<InputIt>) {
+    clear();
+    if constexpr (measurable<InputIt>) {
+      reserve(range_length(first, last));
+    }
+    for (; first != last; ++first) {
+      emplace_back(*first);
+    }
+  } else {
+    size_type count = range_length(first, last);
+    if (count > _capacity) {
+      value_type* new_data = allocate(count);
+      try {
+        vector_ops::construct_range(_alloc, first, last, new_data);
+      } catch (...) {
+        deallocate(new_data, count);
+        throw;
+      }
+      release();
+      _data = new_data;
+      _capacity = count;
+    } else if (count > _size) {
+      InputIt mid = std::next(first, static_cast<std::ptrdiff_t>(_size));
+      std::copy(first, mid, _data);
+      vector_ops::construct_range(_alloc, mid, last, _data + _size);
+    } else {
+      std::copy(first, last, _data);
+      vector_ops::destroy_range(_alloc, _data + count, _data + _size);
+    }
+    _size = count;
+  }
+}
 
-  _size += num_new_elements;
-  return iterator(_data + insert_pos);
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::assign(
+    std::initializer_list<value_type> items) {
+  assign(items.begin(), items.end());
+}
+
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::value_type*
+vector<T, Allocator, Growth>::allocate(size_type n) {
+  return n > 0 ? alloc_traits::allocate(_alloc, n) : nullptr;
 }
 
-template <typename T>
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::deallocate(value_type* p, size_type n) {
+  if (p) {
+    alloc_traits::deallocate(_alloc, p, n);
+  }
+}
+
+template <typename T, typename Allocator, typename Growth>
 template <typename... Args>
-void vector<T>::insert_many_back(Args&&... args) {
-  size_type num_new_elements = sizeof...(Args);
+void vector<T, Allocator, Growth>::construct(value_type* p, Args&&... args) {
+  alloc_traits::construct(_alloc, p, std::forward<Args>(args)...);
+}
 
-  if (num_new_elements == 0) {
-    return;
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::release() {
+  vector_ops::destroy_range(_alloc, _data, _data + _size);
+  deallocate(_data, _capacity);
+  _data = nullptr;
+  _size = 0;
+  _capacity = 0;
+}
+
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::steal(vector& other) noexcept {
+  _data = other._data;
+  _size = other._size;
+  _capacity = other._capacity;
+  other._data = nullptr;
+  other._size = 0;
+  other._capacity = 0;
+}
+
+template <typename T, typename Allocator, typename Growth>
+template <typename InputIt>
+typename vector<T, Allocator, Growth>::size_type
+vector<T, Allocator, Growth>::range_length(InputIt first, InputIt last) {
+  if constexpr (std::sized_sentinel_for<InputIt, InputIt>) {
+    return static_cast<size_type>(last - first);
+  } else {
+    return static_cast<size_type>(std::distance(first, last));
   }
+}
 
-  if (_size + num_new_elements > _capacity) {
-    size_type new_capacity = std::max(_capacity * 2, _size + num_new_elements);
-    reserve(new_capacity);
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::size_type
+vector<T, Allocator, Growth>::next_capacity(size_type min_capacity) const {
+  return Growth::grow(_capacity, min_capacity, sizeof(value_type));
+}
+
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::reallocate(size_type new_capacity) {
+  if constexpr (resizes_in_place) {
+    if (_data && new_capacity > 0) {
+      _data = _alloc.reallocate(_data, _capacity, new_capacity);
+      _capacity = new_capacity;
+      return;
+    }
   }
+  value_type* new_data = allocate(new_capacity);
+  try {
+    vector_ops::relocate(_alloc, _data, _data + _size, new_data);
+  } catch (...) {
+    deallocate(new_data, new_capacity);
+    throw;
+  }
+  vector_ops::destroy_range(_alloc, _data, _data + _size);
+  deallocate(_data, _capacity);
+  _data = new_data;
+  _capacity = new_capacity;
+}
 
-  size_type i = 0;
-  ((_data[_size + i++] = std::forward<Args>(args)), ...);
+// Grows the buffer and constructs the new element directly in it. The element
+// is built before the old buffer is released, so args may refer into it.
+template <typename T, typename Allocator, typename Growth>
+template <typename... Args>
+typename vector<T, Allocator, Growth>::iterator
+vector<T, Allocator, Growth>::realloc_insert(size_type index, Args&&... args) {
+  if constexpr (resizes_in_place) {
+    if (_data) {
+      // the buffer is resized in place, so a copy is taken first in case
+      // args refer into it
+      value_type value(std::forward<Args>(args)...);
+      reallocate(next_capacity(_size + 1));
+      std::memmove(static_cast<void*>(_data + index + 1), _data + index,
+                   (_size - index) * sizeof(value_type));
+      construct(_data + index, value);
+      ++_size;
+      return iterator(_data + index);
+    }
+  }
+  size_type new_capacity = next_capacity(_size + 1);
+  value_type* new_data = allocate(new_capacity);
+  value_type* slot = new_data + index;
+  try {
+    construct(slot, std::forward<Args>(args)...);
+    vector_ops::relocate_around(_alloc, _data, _size, index, 1, new_data);
+  } catch (...) {
+    deallocate(new_data, new_capacity);
+    throw;
+  }
+  vector_ops::destroy_range(_alloc, _data, _data + _size);
+  deallocate(_data, _capacity);
+  _data = new_data;
+  _capacity = new_capacity;
+  ++_size;
+  return iterator(slot);
+}
 
-  _size += num_new_elements;
+template <typename T, typename Allocator, typename Growth>
+template <typename... Args>
+typename vector<T, Allocator, Growth>::iterator
+vector<T, Allocator, Growth>::realloc_insert_many(size_type index,
+                                                  Args&&... args) {
+  constexpr size_type count = sizeof...(Args);
+  if constexpr (resizes_in_place) {
+    if (_data) {
+      // the buffer is resized in place, so copies are taken first in case
+      // args refer into it
+      value_type values[] = {value_type(std::forward<Args>(args))...};
+      reallocate(next_capacity(_size + count));
+      std::memmove(static_cast<void*>(_data + index + count), _data + index,
+                   (_size - index) * sizeof(value_type));
+      std::memcpy(static_cast<void*>(_data + index), values, sizeof(values));
+      _size += count;
+      return iterator(_data + index);
+    }
+  }
+  size_type new_capacity = next_capacity(_size + count);
+  value_type* new_data = allocate(new_capacity);
+  value_type* first = new_data + index;
+  try {
+    vector_ops::construct_each(_alloc, first, std::forward<Args>(args)...);
+    vector_ops::relocate_around(_alloc, _data, _size, index, count, new_data);
+  } catch (...) {
+    deallocate(new_data, new_capacity);
+    throw;
+  }
+  vector_ops::destroy_range(_alloc, _data, _data + _size);
+  deallocate(_data, _capacity);
+  _data = new_data;
+  _capacity = new_capacity;
+  _size += count;
+  return iterator(first);
+}
+
+template <typename T, typename Allocator, typename Growth, typename Pred>
+typename vector<T, Allocator, Growth>::size_type erase_if(
+    vector<T, Allocator, Growth>& v, Pred pred) {
+  auto kept_end = std::remove_if(v.begin(), v.end(), pred);
+  auto removed = static_cast<typename vector<T, Allocator, Growth>::size_type>(
+      v.end() - kept_end);
+  v.erase(kept_end, v.end());
+  return removed;
 }
 
 }  // namespace s21
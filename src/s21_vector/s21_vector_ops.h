@@ -0,0 +1,170 @@
+#ifndef S21_VECTOR_OPS_H
+#define S21_VECTOR_OPS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace s21 {
+
+// Element handling shared by s21::vector and s21::small_vector. The
+// functions work on raw slots of a buffer the caller owns and build and
+// destroy elements through the caller's allocator, so scoped allocators
+// (std::pmr) reach the elements. Trivially copyable elements are shifted
+// and relocated with memmove/memcpy.
+namespace vector_ops {
+
+template <typename Alloc, typename T>
+void destroy_range(Alloc& alloc, T* first, T* last) {
+  if constexpr (!std::is_trivially_destructible_v<T>) {
+    for (; first != last; ++first) {
+      std::allocator_traits<Alloc>::destroy(alloc, first);
+    }
+  }
+}
+
+// Constructs [dest, dest + (last - first)) from [first, last). If a
+// constructor throws, the already built part is destroyed.
+template <typename Alloc, typename InputIt, typename T>
+void construct_range(Alloc& alloc, InputIt first, InputIt last, T* dest) {
+  T* current = dest;
+  try {
+    for (; first != last; ++first, ++current) {
+      std::allocator_traits<Alloc>::construct(alloc, current, *first);
+    }
+  } catch (...) {
+    destroy_range(alloc, dest, current);
+    throw;
+  }
+}
+
+// Constructs one element from each of args at dest onwards. If a
+// constructor throws, the already built ones are destroyed.
+template <typename Alloc, typename T, typename... Args>
+void construct_each(Alloc& alloc, T* dest, Args&&... args) {
+  T* current = dest;
+  try {
+    ((std::allocator_traits<Alloc>::construct(alloc, current,
+                                              std::forward<Args>(args)),
+      ++current),
+     ...);
+  } catch (...) {
+    destroy_range(alloc, dest, current);
+    throw;
+  }
+}
+
+// Constructs [dest, dest + (last - first)) from [first, last), moving when
+// that cannot throw and copying otherwise. Source objects are left alive.
+template <typename Alloc, typename T>
+void relocate(Alloc& alloc, T* first, T* last, T* dest) {
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    if (first != last) {
+      std::memcpy(static_cast<void*>(dest), first,
+                  (last - first) * sizeof(T));
+    }
+  } else if constexpr (std::is_nothrow_move_constructible_v<T> ||
+                       !std::is_copy_constructible_v<T>) {
+    construct_range(alloc, std::make_move_iterator(first),
+                    std::make_move_iterator(last), dest);
+  } else {
+    construct_range(alloc, first, last, dest);
+  }
+}
+
+// Relocates the size elements at data into a new buffer around the count
+// elements already built at new_data + index. If that throws, everything
+// built in new_data is destroyed; freeing it is up to the caller.
+template <typename Alloc, typename T>
+void relocate_around(Alloc& alloc, T* data, std::size_t size,
+                     std::size_t index, std::size_t count, T* new_data) {
+  T* slot = new_data + index;
+  try {
+    relocate(alloc, data, data + index, new_data);
+  } catch (...) {
+    destroy_range(alloc, slot, slot + count);
+    throw;
+  }
+  try {
+    relocate(alloc, data + index, data + size, slot + count);
+  } catch (...) {
+    destroy_range(alloc, new_data, slot + count);
+    throw;
+  }
+}
+
+// Removes the element at index, moving the ones after it down.
+template <typename Alloc, typename T>
+void erase_at(Alloc& alloc, T* data, std::size_t& size, std::size_t index) {
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    std::memmove(static_cast<void*>(data + index), data + index + 1,
+                 (size - index - 1) * sizeof(T));
+    --size;
+  } else {
+    std::move(data + index + 1, data + size, data + index);
+    --size;
+    std::allocator_traits<Alloc>::destroy(alloc, data + size);
+  }
+}
+
+// Builds an element from args at index of a buffer with room past its size
+// elements. args may refer to an element that is about to be shifted, so
+// the element is built before anything moves.
+template <typename Alloc, typename T, typename... Args>
+void emplace_in_place(Alloc& alloc, T* data, std::size_t& size,
+                      std::size_t index, Args&&... args) {
+  if (index == size) {
+    std::allocator_traits<Alloc>::construct(alloc, data + size,
+                                            std::forward<Args>(args)...);
+  } else if constexpr (std::is_trivially_copyable_v<T>) {
+    T tmp(std::forward<Args>(args)...);
+    std::memmove(static_cast<void*>(data + index + 1), data + index,
+                 (size - index) * sizeof(T));
+    data[index] = tmp;
+  } else {
+    // built past the end through the allocator, then moved into place
+    std::allocator_traits<Alloc>::construct(alloc, data + size,
+                                            std::forward<Args>(args)...);
+    ++size;
+    T tmp(std::move(data[size - 1]));
+    std::move_backward(data + index, data + size - 1, data + size);
+    data[index] = std::move(tmp);
+    return;
+  }
+  ++size;
+}
+
+// Builds one element from each of args at index of a buffer with room for
+// them past its size elements. args may refer to elements, so the new
+// values are built before anything moves: trivially copyable ones in a
+// temporary array, then the tail is moved up once and the values copied
+// into the gap; others past the end, then rotated into place.
+template <typename Alloc, typename T, typename... Args>
+void insert_many_in_place(Alloc& alloc, T* data, std::size_t& size,
+                          std::size_t index, Args&&... args) {
+  constexpr std::size_t count = sizeof...(Args);
+  if constexpr (count == 0) {
+    return;
+  } else if constexpr (std::is_trivially_copyable_v<T>) {
+    T values[] = {T(std::forward<Args>(args))...};
+    std::memmove(static_cast<void*>(data + index + count), data + index,
+                 (size - index) * sizeof(T));
+    std::memcpy(static_cast<void*>(data + index), values, sizeof(values));
+    size += count;
+  } else {
+    T* old_end = data + size;
+    construct_each(alloc, old_end, std::forward<Args>(args)...);
+    size += count;
+    std::rotate(data + index, old_end, old_end + count);
+  }
+}
+
+}  // namespace vector_ops
+
+}  // namespace s21
+
+#endif
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
 #include <list>
+#include <memory_resource>
+#include <string>
 
 #include "../src/s21_list/s21_list.h"
 
@@ -348,4 +350,105 @@ TEST(List, Insert_Many_Front) {
   EXPECT_EQ(*our_it, 1);
   ++our_it;
   EXPECT_EQ(*our_it, 2);
-}
\ No newline at end of file
+}
+
+TEST(List, Pmr_Allocates_From_Resource) {
+  alignas(std::max_align_t) std::byte buffer[4096];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                            std::pmr::null_memory_resource());
+
+  s21::pmr::S21List<int> list(&arena);
+  list.push_back(1);
+  list.push_front(0);
+  list.insert(list.end(), 2);
+
+  EXPECT_EQ(list.get_allocator().resource(), &arena);
+  int expected = 0;
+  for (auto it = list.begin(); it != list.end(); ++it, ++expected) {
+    const std::byte* node = reinterpret_cast<const std::byte*>(&*it);
+    EXPECT_TRUE(node >= buffer && node < buffer + sizeof(buffer));
+    EXPECT_EQ(*it, expected);
+  }
+}
+
+TEST(List, Splice_Keeps_Nodes_Of_Destroyed_Source) {
+  s21::S21List<std::string> list = {"a", "b"};
+  {
+    s21::S21List<std::string> other;
+    for (int i = 0; i < 40; ++i) other.push_back(std::to_string(i));
+    other.pop_front();
+    list.splice(list.end(), other);
+  }
+  list.push_back("tail");
+  EXPECT_EQ(list.size(), 42);
+  EXPECT_EQ(list.front(), "a");
+  auto third = list.begin();
+  ++third;
+  ++third;
+  EXPECT_EQ(*third, "1");
+  EXPECT_EQ(list.back(), "tail");
+}
+
+TEST(List, Compact_Lays_Nodes_Out_In_Order) {
+  s21::S21List<int> list;
+  for (int i = 0; i < 300; ++i) {
+    if (i % 2) {
+      list.push_back(i);
+    } else {
+      list.push_front(i);
+    }
+  }
+  for (int i = 0; i < 50; ++i) list.pop_back();
+  std::list<int> expected;
+  for (auto it = list.begin(); it != list.end(); ++it) expected.push_back(*it);
+
+  list.compact();
+  ASSERT_EQ(list.size(), expected.size());
+  const int* first = &*list.begin();
+  std::ptrdiff_t stride = &*(++list.begin()) - first;
+  EXPECT_GT(stride, 0);
+  std::ptrdiff_t index = 0;
+  auto it = list.begin();
+  for (int value : expected) {
+    EXPECT_EQ(*it, value);
+    EXPECT_EQ(&*it - first, stride * index);
+    ++it;
+    ++index;
+  }
+  list.push_back(-1);
+  EXPECT_EQ(list.back(), -1);
+}
+
+TEST(List, Splice_Source_And_Target_Free_Their_Own_Slabs) {
+  struct live_bytes_resource : std::pmr::memory_resource {
+    size_t live = 0;
+    void* do_allocate(size_t bytes, size_t align) override {
+      live += bytes;
+      return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t align) override {
+      live -= bytes;
+      std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+      return this == &other;
+    }
+  } resource;
+
+  s21::pmr::S21List<int> other(&resource);
+  size_t refilled = 0;
+  {
+    s21::pmr::S21List<int> list(&resource);
+    for (int i = 0; i < 100; ++i) other.push_back(i);
+    list.splice(list.end(), other);
+    size_t spliced = resource.live;
+    for (int i = 0; i < 100; ++i) other.push_back(i);
+    refilled = resource.live - spliced;
+    while (list.size() > 1) list.pop_back();
+  }
+  // the target took the spliced slabs with it, other kept its new ones
+  EXPECT_EQ(resource.live, refilled);
+  EXPECT_EQ(other.size(), 100);
+  other.clear();
+  EXPECT_EQ(resource.live, 0);
+}
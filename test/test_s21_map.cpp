@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 
 #include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "../src/s21_list/s21_list.h"
 #include "../src/s21_map/s21_map.h"
@@ -255,3 +259,512 @@ TEST(S21Map, MoveRedRightAndEraseMin) {
   EXPECT_EQ(m.size(), 5);
   EXPECT_FALSE(m.contains(15));
 }
+
+TEST(S21Map, PmrAllocatesFromResource) {
+  alignas(std::max_align_t) std::byte buffer[4096];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                            std::pmr::null_memory_resource());
+
+  s21::pmr::S21Map<int, int> m(&arena);
+  for (int i = 0; i < 20; ++i) m.insert(i, i * i);
+  m.erase(m.find(7));
+  m[42] = 1;
+
+  EXPECT_EQ(m.get_allocator().resource(), &arena);
+  EXPECT_EQ(m.size(), 20);
+  for (auto it = m.begin(); it != m.end(); ++it) {
+    const std::byte* node = reinterpret_cast<const std::byte*>(&(*it).second);
+    EXPECT_TRUE(node >= buffer && node < buffer + sizeof(buffer));
+  }
+}
+
+TEST(S21Map, TransparentLookup) {
+  using Alloc = std::allocator<std::pair<const std::string, int>>;
+  s21::S21Map<std::string, int, Alloc, std::less<>> m;
+  m.insert("one", 1);
+  m.insert("two", 2);
+  m.insert("three", 3);
+
+  std::string_view probe = "two";
+  EXPECT_TRUE(m.contains(probe));
+  EXPECT_FALSE(m.contains("four"));
+  EXPECT_EQ(m.count("three"), 1);
+  EXPECT_EQ(m.count(std::string_view("zero")), 0);
+  EXPECT_EQ((*m.find(probe)).second, 2);
+  EXPECT_EQ(m.find("four"), m.end());
+}
+
+TEST(S21Map, CustomComparatorOrdersDescending) {
+  s21::S21Map<int, int, std::allocator<std::pair<const int, int>>,
+              std::greater<int>>
+      m;
+  for (int i = 0; i < 50; ++i) m.insert((i * 7) % 50, i);
+  EXPECT_FALSE(m.insert(14, 0).second);
+  m.erase(m.find(49));
+  m.erase(m.find(20));
+
+  EXPECT_EQ(m.size(), 48);
+  int prev = 50;
+  for (auto it = m.begin(); it != m.end(); ++it) {
+    EXPECT_LT((*it).first, prev);
+    prev = (*it).first;
+  }
+  EXPECT_FALSE(m.contains(20));
+  EXPECT_EQ(m.count(21), 1);
+}
+
+namespace {
+
+struct CountedValue {
+  static inline int constructed = 0;
+  int value;
+  explicit CountedValue(int v = 0) : value(v) { ++constructed; }
+};
+
+}  // namespace
+
+TEST(S21Map, TryEmplaceConstructsOnlyForNewKeys) {
+  s21::S21Map<int, CountedValue> m;
+  CountedValue::constructed = 0;
+
+  auto first = m.try_emplace(1, 10);
+  EXPECT_TRUE(first.second);
+  EXPECT_EQ((*first.first).first, 1);
+  EXPECT_EQ(CountedValue::constructed, 1);
+
+  auto again = m.try_emplace(1, 20);
+  EXPECT_FALSE(again.second);
+  EXPECT_EQ(again.first, first.first);
+  EXPECT_EQ(m.at(1).value, 10);
+  EXPECT_EQ(CountedValue::constructed, 1);
+
+  m[1].value += 1;
+  m[2];
+  EXPECT_EQ(CountedValue::constructed, 2);
+  EXPECT_EQ(m.at(1).value, 11);
+  EXPECT_EQ(m.at(2).value, 0);
+  EXPECT_EQ(m.size(), 2);
+}
+
+TEST(S21Map, EmplaceAndRvalueInsertMoveValues) {
+  s21::S21Map<std::string, std::unique_ptr<int>> m;
+  auto [it, inserted] = m.emplace("a", std::make_unique<int>(1));
+  EXPECT_TRUE(inserted);
+  EXPECT_EQ(*(*it).second, 1);
+
+  std::string key = "b";
+  auto moved = m.try_emplace(std::move(key), std::make_unique<int>(2));
+  EXPECT_TRUE(moved.second);
+  EXPECT_EQ((*moved.first).first, "b");
+
+  std::pair<const std::string, std::unique_ptr<int>> item(
+      "c", std::make_unique<int>(3));
+  EXPECT_TRUE(m.insert(std::move(item)).second);
+  EXPECT_EQ(item.second, nullptr);
+
+  auto kept = std::make_unique<int>(4);
+  EXPECT_FALSE(m.try_emplace("a", std::move(kept)).second);
+  ASSERT_NE(kept, nullptr);
+  EXPECT_EQ(*m["a"], 1);
+  EXPECT_EQ(*m["c"], 3);
+  EXPECT_EQ(m.size(), 3);
+}
+
+TEST(S21Map, CounterWorkloadMatchesStd) {
+  s21::S21Map<int, int> m;
+  std::map<int, int> expected;
+  unsigned x = 12345;
+  for (int i = 0; i < 5000; ++i) {
+    x = x * 1103515245u + 12345u;
+    int key = static_cast<int>((x >> 16) % 700);
+    m[key]++;
+    expected[key]++;
+  }
+  auto assigned = m.insert_or_assign(3, -1);
+  EXPECT_EQ((*assigned.first).second, -1);
+  expected.insert_or_assign(3, -1);
+
+  ASSERT_EQ(m.size(), expected.size());
+  auto it = m.begin();
+  for (const auto& [key, count] : expected) {
+    EXPECT_EQ((*it).first, key);
+    EXPECT_EQ((*it).second, count);
+    ++it;
+  }
+}
+
+TEST(S21Map, CompactLaysNodesOutInKeyOrder) {
+  s21::S21Map<int, std::string> m;
+  std::map<int, std::string> expected;
+  for (int i = 0; i < 600; ++i) {
+    int key = (i * 379) % 1000;
+    m.insert(key, std::to_string(key));
+    expected.emplace(key, std::to_string(key));
+  }
+  for (int key = 0; key < 1000; key += 3) {
+    auto it = m.find(key);
+    if (it != m.end()) m.erase(it);
+    expected.erase(key);
+  }
+
+  m.compact();
+  ASSERT_EQ(m.size(), expected.size());
+  auto it = m.begin();
+  const std::byte* first = reinterpret_cast<const std::byte*>(&(*it).second);
+  std::ptrdiff_t stride = 0;
+  std::size_t index = 0;
+  for (const auto& [key, value] : expected) {
+    EXPECT_EQ((*it).first, key);
+    EXPECT_EQ((*it).second, value);
+    const std::byte* node = reinterpret_cast<const std::byte*>(&(*it).second);
+    if (index == 1) stride = node - first;
+    EXPECT_EQ(node - first, stride * static_cast<std::ptrdiff_t>(index));
+    ++it;
+    ++index;
+  }
+  EXPECT_GT(stride, 0);
+
+  m[5000] = "after";
+  m.clear();
+  EXPECT_TRUE(m.empty());
+  m.insert(1, "again");
+  EXPECT_EQ(m.at(1), "again");
+}
+
+TEST(S21Map, RankedRankSelectAndDistanceMatchOrder) {
+  s21::S21RankedMap<int, int> m;
+  std::map<int, int> expected;
+  unsigned x = 99;
+  for (int i = 0; i < 3000; ++i) {
+    x = x * 1103515245u + 12345u;
+    int key = static_cast<int>((x >> 16) % 2000);
+    if (i % 3 == 2) {
+      auto it = m.find(key);
+      if (it != m.end()) m.erase(it);
+      expected.erase(key);
+    } else {
+      m[key] = i;
+      expected[key] = i;
+    }
+  }
+  m.try_emplace(-5, 0);
+  expected.try_emplace(-5, 0);
+
+  ASSERT_EQ(m.size(), expected.size());
+  std::size_t index = 0;
+  for (const auto& [key, value] : expected) {
+    auto it = m.select(index);
+    ASSERT_NE(it, m.end());
+    EXPECT_EQ((*it).first, key);
+    EXPECT_EQ(m.rank(key), index);
+    EXPECT_EQ(m.rank(key + 1), index + 1);
+    EXPECT_EQ(m.index_of(it), index);
+    ++index;
+  }
+  EXPECT_EQ(m.select(m.size()), m.end());
+  EXPECT_EQ(m.index_of(m.end()), m.size());
+  EXPECT_EQ(m.rank(5000), m.size());
+  EXPECT_EQ(m.rank(-100), 0);
+  EXPECT_EQ(m.distance(m.begin(), m.end()),
+            static_cast<std::ptrdiff_t>(m.size()));
+  EXPECT_EQ(m.distance(m.select(10), m.select(3)), -7);
+
+  s21::S21RankedMap<int, int> copy(m);
+  copy.compact();
+  EXPECT_EQ((*copy.select(42)).first, (*m.select(42)).first);
+}
+
+TEST(S21Map, SortedUniqueConstructorBuildsValidTree) {
+  for (int n : {0, 1, 2, 3, 4, 7, 8, 26, 27, 100, 1000}) {
+    std::vector<std::pair<int, std::string>> items;
+    for (int i = 0; i < n; ++i) items.emplace_back(i * 2, std::to_string(i));
+
+    s21::S21RankedMap<int, std::string> m(s21::sorted_unique, items.begin(),
+                                          items.end());
+    ASSERT_EQ(m.size(), static_cast<std::size_t>(n));
+    auto it = m.begin();
+    for (int i = 0; i < n; ++i, ++it) {
+      EXPECT_EQ((*it).first, i * 2);
+      EXPECT_EQ((*m.select(i)).first, i * 2);
+    }
+    EXPECT_EQ(it, m.end());
+
+    // the built tree keeps working as a regular map
+    for (int i = 0; i < n; i += 3) m.try_emplace(i * 2 + 1, "odd");
+    for (int i = 0; i < n; i += 2) m.erase(m.find(i * 2));
+    std::size_t index = 0;
+    int prev = -1;
+    for (auto jt = m.begin(); jt != m.end(); ++jt, ++index) {
+      EXPECT_GT((*jt).first, prev);
+      EXPECT_EQ(m.index_of(jt), index);
+      prev = (*jt).first;
+    }
+    EXPECT_EQ(index, m.size());
+  }
+}
+
+TEST(S21Map, MergeRelinksNodesLikeStd) {
+  for (int small : {3, 400}) {
+    s21::S21Map<int, std::string> m;
+    s21::S21Map<int, std::string> other;
+    std::map<int, std::string> expected;
+    std::map<int, std::string> expected_other;
+    for (int i = 0; i < 500; ++i) {
+      m.insert(i * 3, "m");
+      expected.emplace(i * 3, "m");
+    }
+    for (int i = 0; i < small; ++i) {
+      other.insert(i * 5, "o");
+      expected_other.emplace(i * 5, "o");
+    }
+    const std::string* moved = &(*other.find(small > 3 ? 5 : 10)).second;
+
+    m.merge(other);
+    expected.merge(expected_other);
+    EXPECT_EQ(&(*m.find(small > 3 ? 5 : 10)).second, moved);
+
+    other.insert(1, "left behind");
+    expected_other.emplace(1, "left behind");
+    ASSERT_EQ(other.size(), expected_other.size());
+    auto ot = other.begin();
+    for (const auto& [key, value] : expected_other) {
+      EXPECT_EQ((*ot).first, key);
+      EXPECT_EQ((*ot).second, value);
+      ++ot;
+    }
+    other = s21::S21Map<int, std::string>();
+
+    m[-1] = "new";
+    expected[-1] = "new";
+    ASSERT_EQ(m.size(), expected.size());
+    auto it = m.begin();
+    for (const auto& [key, value] : expected) {
+      EXPECT_EQ((*it).first, key);
+      EXPECT_EQ((*it).second, value);
+      ++it;
+    }
+  }
+}
+
+TEST(S21Map, NodeHandlesMoveEntriesBetweenMaps) {
+  struct counting_resource : std::pmr::memory_resource {
+    int allocations = 0;
+    void* do_allocate(size_t bytes, size_t align) override {
+      ++allocations;
+      return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t align) override {
+      std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+      return this == &other;
+    }
+  } resource;
+
+  s21::pmr::S21Map<int, std::string> shard(&resource);
+  s21::pmr::S21Map<int, std::string>::node_type kept;
+  {
+    s21::pmr::S21Map<int, std::string> source(&resource);
+    for (int i = 0; i < 100; ++i) source.insert(i, std::to_string(i));
+    auto after = source.find(41);
+
+    // every handle gets a node of its own, linking it allocates nothing
+    int before = resource.allocations;
+    auto nh = source.extract(40);
+    ASSERT_FALSE(nh.empty());
+    EXPECT_EQ(nh.key(), 40);
+    EXPECT_EQ(nh.mapped(), "40");
+    EXPECT_EQ((*after).first, 41);
+    EXPECT_FALSE(source.contains(40));
+    EXPECT_EQ(resource.allocations, before + 1);
+
+    nh.key() = 1000;
+    auto result = source.insert(std::move(nh));
+    EXPECT_TRUE(result.inserted);
+    EXPECT_TRUE(result.node.empty());
+    EXPECT_EQ((*result.position).second, "40");
+
+    for (int i = 0; i < 100; i += 2) {
+      if (i == 40) continue;
+      auto moved = shard.insert(source.extract(i));
+      EXPECT_TRUE(moved.inserted);
+    }
+    kept = source.extract(1);
+    EXPECT_EQ(resource.allocations, before + 51);
+
+    auto taken = source.extract(3);
+    taken.key() = 1000;
+    auto refused = shard.insert(source.extract(1000));
+    ASSERT_TRUE(refused.inserted);
+    auto duplicate = shard.insert(std::move(taken));
+    EXPECT_FALSE(duplicate.inserted);
+    EXPECT_EQ(duplicate.node.mapped(), "3");
+    EXPECT_EQ(duplicate.position, shard.find(1000));
+
+    EXPECT_TRUE(source.extract(-5).empty());
+    EXPECT_TRUE(source.extract(source.end()).empty());
+  }
+
+  // source is gone, its nodes still live in shard and in kept
+  ASSERT_EQ(shard.size(), 50);
+  int expected = 0;
+  for (auto it = shard.begin(); it != shard.end(); ++it) {
+    if (expected == 40) expected += 2;
+    if (expected == 100) expected = 1000;
+    EXPECT_EQ((*it).first, expected);
+    EXPECT_EQ((*it).second, expected == 1000 ? "40" : std::to_string(expected));
+    expected += 2;
+  }
+  EXPECT_EQ(kept.mapped(), "1");
+  shard.insert(std::move(kept));
+  EXPECT_EQ(shard.at(1), "1");
+  shard.erase(shard.find(0));
+  shard[7] = "7";
+  EXPECT_EQ(shard.size(), 51);
+}
+
+TEST(S21Map, RankedNodeHandlesKeepSubtreeSizes) {
+  s21::S21RankedMap<int, int> a;
+  s21::S21RankedMap<int, int> b;
+  for (int i = 0; i < 64; ++i) a.insert(i, i);
+  for (int i = 0; i < 64; i += 3) b.insert(a.extract(i));
+  ASSERT_EQ(a.size() + b.size(), 64);
+  for (size_t k = 0; k < a.size(); ++k) {
+    EXPECT_EQ(a.index_of(a.select(k)), k);
+  }
+  for (size_t k = 0; k < b.size(); ++k) {
+    EXPECT_EQ((*b.select(k)).first, static_cast<int>(k) * 3);
+  }
+  EXPECT_EQ(b.rank(30), 10);
+}
+
+TEST(S21Map, NodeHandlesAndMergesKeepMemoryBounded) {
+  struct live_bytes_resource : std::pmr::memory_resource {
+    size_t live = 0;
+    void* do_allocate(size_t bytes, size_t align) override {
+      live += bytes;
+      return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t align) override {
+      live -= bytes;
+      std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+      return this == &other;
+    }
+  } resource;
+
+  s21::pmr::S21Map<int, int> m(&resource);
+  for (int i = 0; i < 1000; ++i) m.insert(i, i);
+  size_t base = resource.live;
+
+  // dropped handles give their storage back
+  for (int round = 0; round < 100000; ++round) {
+    int key = round % 1000;
+    { auto nh = m.extract(key); }
+    m.insert(key, round);
+  }
+  EXPECT_LE(resource.live, base);
+
+  // re-keying through a handle reuses the node it freed
+  for (int round = 0; round < 100000; ++round) {
+    auto nh = m.extract(round % 1000);
+    nh.key() = 1000 + round % 1000;
+    m.insert(std::move(nh));
+    nh = m.extract(1000 + round % 1000);
+    nh.key() = round % 1000;
+    m.insert(std::move(nh));
+  }
+  EXPECT_LE(resource.live, base);
+
+  // so does a container that took a node and went away
+  for (int round = 0; round < 1000; ++round) {
+    {
+      s21::pmr::S21Map<int, int> other(&resource);
+      other.insert(m.extract(round));
+    }
+    m.insert(round, round);
+  }
+  EXPECT_LE(resource.live, base);
+
+  // merging duplicates only leaves both maps on their own storage
+  for (int round = 0; round < 2000; ++round) {
+    s21::pmr::S21Map<int, int> duplicates(&resource);
+    for (int i = 0; i < 50; ++i) duplicates.insert(i * 7, -i);
+    m.merge(duplicates);
+    EXPECT_EQ(duplicates.size(), 50);
+  }
+  EXPECT_LE(resource.live, base);
+  EXPECT_EQ(m.size(), 1000);
+  EXPECT_EQ(m.at(7), 7);
+}
+
+TEST(S21Map, NodeHandlesLeaveNoStorageShared) {
+  struct live_bytes_resource : std::pmr::memory_resource {
+    size_t live = 0;
+    void* do_allocate(size_t bytes, size_t align) override {
+      live += bytes;
+      return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t align) override {
+      live -= bytes;
+      std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+      return this == &other;
+    }
+  } resource;
+
+  s21::pmr::S21Map<int, int> shard(&resource);
+  size_t source_bytes = 0;
+  {
+    s21::pmr::S21Map<int, int> source(&resource);
+    for (int i = 0; i < 1000; ++i) source.insert(i, i);
+    source_bytes = resource.live;
+    for (int i = 0; i < 1000; i += 10) shard.insert(source.extract(i));
+  }
+  // the source gave all of its slabs back, the shard owns what it took
+  ASSERT_EQ(shard.size(), 100);
+  EXPECT_LT(resource.live, source_bytes / 2);
+  EXPECT_EQ(shard.at(990), 990);
+
+  shard.clear();
+  EXPECT_EQ(resource.live, 0);
+  shard.insert(1, 1);
+}
+
+TEST(S21Map, MergeSourceAndTargetFreeTheirOwnSlabs) {
+  struct live_bytes_resource : std::pmr::memory_resource {
+    size_t live = 0;
+    void* do_allocate(size_t bytes, size_t align) override {
+      live += bytes;
+      return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t align) override {
+      live -= bytes;
+      std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+      return this == &other;
+    }
+  } resource;
+
+  s21::pmr::S21Map<int, int> other(&resource);
+  size_t kept_bytes = 0;
+  {
+    s21::pmr::S21Map<int, int> target(&resource);
+    for (int i = 0; i < 100; i += 2) target.insert(i, i);
+    for (int i = 0; i < 100; ++i) other.insert(i, -i);
+    size_t before = resource.live;
+    target.merge(other);
+    kept_bytes = resource.live - before;
+    ASSERT_EQ(target.size(), 100);
+    ASSERT_EQ(other.size(), 50);
+  }
+  // the target took the merged slabs with it, other kept the pool its
+  // remaining keys moved to
+  EXPECT_EQ(resource.live, kept_bytes);
+  EXPECT_EQ(other.at(2), -2);
+  other.clear();
+  EXPECT_EQ(resource.live, 0);
+}
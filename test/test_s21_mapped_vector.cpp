@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#include "../src/s21_mapped_vector/s21_mapped_vector.h"
+
+namespace {
+
+struct Record {
+  int id;
+  double value;
+};
+
+// Fresh file path in the temp directory, removed when the test ends.
+class MappedVectorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = (std::filesystem::temp_directory_path() /
+             ("s21_mapped_vector_" +
+              std::string(::testing::UnitTest::GetInstance()
+                              ->current_test_info()
+                              ->name())))
+                .string();
+    std::filesystem::remove(path_);
+  }
+  void TearDown() override { std::filesystem::remove(path_); }
+
+  std::string path_;
+};
+
+}  // namespace
+
+TEST_F(MappedVectorTest, DefaultIsClosed) {
+  s21::mapped_vector<int> v;
+  EXPECT_FALSE(v.is_open());
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(v.begin(), v.end());
+}
+
+TEST_F(MappedVectorTest, CreatesEmptyFile) {
+  s21::mapped_vector<int> v(path_);
+  EXPECT_TRUE(v.is_open());
+  EXPECT_TRUE(v.writable());
+  EXPECT_EQ(v.size(), 0);
+  EXPECT_TRUE(std::filesystem::exists(path_));
+}
+
+TEST_F(MappedVectorTest, AppendPersistsAcrossReopen) {
+  {
+    s21::mapped_vector<Record> v(path_);
+    for (int i = 0; i < 1000; ++i) v.push_back({i, i * 0.5});
+    EXPECT_GE(v.capacity(), 1000);
+  }
+  EXPECT_EQ(std::filesystem::file_size(path_), 1000 * sizeof(Record));
+
+  using open_mode = s21::mapped_vector<Record>::open_mode;
+  s21::mapped_vector<Record> v(path_, open_mode::read_only);
+  ASSERT_EQ(v.size(), 1000);
+  EXPECT_EQ(v[999].id, 999);
+  EXPECT_EQ(v.at(10).value, 5.0);
+  int expected = 0;
+  for (const Record& r : v) EXPECT_EQ(r.id, expected++);
+}
+
+TEST_F(MappedVectorTest, WritesThroughReferencesAndSync) {
+  s21::mapped_vector<int> v(path_);
+  int items[] = {1, 2, 3};
+  v.append(items, 3);
+  v[1] = 20;
+  v.sync();
+
+  std::ifstream in(path_, std::ios::binary);
+  int on_disk[3] = {};
+  in.read(reinterpret_cast<char*>(on_disk), sizeof(on_disk));
+  EXPECT_EQ(on_disk[0], 1);
+  EXPECT_EQ(on_disk[1], 20);
+  EXPECT_EQ(on_disk[2], 3);
+}
+
+TEST_F(MappedVectorTest, SyncLeavesOnlyElementsInFile) {
+  s21::mapped_vector<int> v(path_);
+  for (int i = 0; i < 5; ++i) v.push_back(i);
+  ASSERT_GT(v.capacity(), v.size());
+  v.sync();
+  EXPECT_EQ(v.capacity(), 5);
+  EXPECT_EQ(std::filesystem::file_size(path_), 5 * sizeof(int));
+
+  // a second mapping stands in for a reader, or a reopen after a crash
+  using open_mode = s21::mapped_vector<int>::open_mode;
+  s21::mapped_vector<int> reader(path_, open_mode::read_only);
+  ASSERT_EQ(reader.size(), 5);
+  EXPECT_EQ(reader.back(), 4);
+
+  v.push_back(5);
+  v.sync();
+  EXPECT_EQ(std::filesystem::file_size(path_), 6 * sizeof(int));
+  EXPECT_EQ(v[5], 5);
+}
+
+TEST_F(MappedVectorTest, AppendFromItself) {
+  s21::mapped_vector<int> v(path_);
+  v.push_back(7);
+  v.push_back(8);
+  v.append(v.data(), v.size());
+  v.push_back(v[0]);
+  ASSERT_EQ(v.size(), 5);
+  EXPECT_EQ(v[2], 7);
+  EXPECT_EQ(v[3], 8);
+  EXPECT_EQ(v.back(), 7);
+}
+
+TEST_F(MappedVectorTest, PopBackShrinksFileOnClose) {
+  s21::mapped_vector<int> v(path_);
+  for (int i = 0; i < 10; ++i) v.push_back(i);
+  v.pop_back();
+  v.close();
+  EXPECT_FALSE(v.is_open());
+  EXPECT_EQ(std::filesystem::file_size(path_), 9 * sizeof(int));
+}
+
+TEST_F(MappedVectorTest, ReadOnlyDoesNotGrowOrWriteBack) {
+  {
+    s21::mapped_vector<int> v(path_);
+    v.push_back(1);
+  }
+  s21::mapped_vector<int> v(path_,
+                            s21::mapped_vector<int>::open_mode::read_only);
+  EXPECT_FALSE(v.writable());
+  EXPECT_THROW(v.push_back(2), std::logic_error);
+  v[0] = 42;
+  v.close();
+
+  v.open(path_, s21::mapped_vector<int>::open_mode::read_only);
+  EXPECT_EQ(v.front(), 1);
+}
+
+TEST_F(MappedVectorTest, MoveTransfersMapping) {
+  s21::mapped_vector<int> v(path_);
+  v.push_back(5);
+  s21::mapped_vector<int> moved(std::move(v));
+  EXPECT_FALSE(v.is_open());
+  EXPECT_EQ(moved[0], 5);
+  s21::mapped_vector<int> assigned;
+  assigned = std::move(moved);
+  EXPECT_EQ(assigned.size(), 1);
+}
+
+TEST_F(MappedVectorTest, OpenErrors) {
+  using open_mode = s21::mapped_vector<int>::open_mode;
+  EXPECT_THROW(s21::mapped_vector<int>(path_, open_mode::read_only),
+               std::system_error);
+  {
+    std::ofstream out(path_, std::ios::binary);
+    out << "abcde";
+  }
+  EXPECT_THROW(s21::mapped_vector<int>{path_}, std::invalid_argument);
+  s21::mapped_vector<int> v;
+  EXPECT_THROW(v.at(0), std::out_of_range);
+}
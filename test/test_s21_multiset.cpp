@@ -1,6 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <iterator>
+#include <memory_resource>
 #include <set>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "../src/s21_multiset/s21_multiset.h"
@@ -243,3 +248,150 @@ TEST(MultisetTest, LargeMultiset) {
     prev = *it;
   }
 }
+
+TEST(MultisetTest, PmrAllocatesFromResource) {
+  alignas(std::max_align_t) std::byte buffer[4096];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                            std::pmr::null_memory_resource());
+
+  s21::pmr::multiset<int> ms(&arena);
+  for (int i = 0; i < 20; ++i) ms.insert(i % 5);
+  ms.erase(ms.begin());
+
+  EXPECT_EQ(ms.get_allocator().resource(), &arena);
+  EXPECT_EQ(ms.size(), 19);
+  EXPECT_EQ(ms.count(3), 4);
+  for (auto it = ms.begin(); it != ms.end(); ++it) {
+    const std::byte* node = reinterpret_cast<const std::byte*>(&*it);
+    EXPECT_TRUE(node >= buffer && node < buffer + sizeof(buffer));
+  }
+}
+
+TEST(MultisetTest, TransparentLookup) {
+  s21::multiset<std::string, std::allocator<std::string>, std::less<>> ms;
+  for (const char* word : {"b", "a", "c", "b", "b", "d"}) ms.insert(word);
+
+  std::string_view probe = "b";
+  EXPECT_EQ(ms.count(probe), 3);
+  EXPECT_EQ(ms.count("z"), 0);
+  EXPECT_TRUE(ms.contains("d"));
+  EXPECT_EQ(*ms.find(probe), "b");
+  EXPECT_EQ(*ms.lower_bound("b"), "b");
+  EXPECT_EQ(*ms.upper_bound(probe), "c");
+  auto [lo, hi] = ms.equal_range("b");
+  EXPECT_EQ(std::distance(lo, hi), 3);
+}
+
+TEST(MultisetTest, CustomComparatorOrdersDescending) {
+  s21::multiset<int, std::allocator<int>, std::greater<int>> ms;
+  for (int i = 0; i < 30; ++i) ms.insert(i % 10);
+
+  std::vector<int> expected;
+  for (int i = 9; i >= 0; --i) expected.insert(expected.end(), 3, i);
+  EXPECT_TRUE(std::equal(ms.begin(), ms.end(), expected.begin(),
+                         expected.end()));
+  EXPECT_EQ(ms.count(4), 3);
+  EXPECT_EQ(*ms.lower_bound(20), 9);
+  EXPECT_EQ(*ms.upper_bound(5), 4);
+  EXPECT_EQ(ms.lower_bound(-1), ms.end());
+}
+
+TEST(MultisetTest, CompactLaysNodesOutInKeyOrder) {
+  s21::multiset<int> ms;
+  std::multiset<int> expected;
+  for (int i = 0; i < 500; ++i) {
+    ms.insert((i * 37) % 101);
+    expected.insert((i * 37) % 101);
+  }
+  for (int i = 0; i < 100; ++i) {
+    ms.erase(ms.find(i));
+    expected.erase(expected.find(i));
+  }
+
+  ms.compact();
+  ASSERT_EQ(ms.size(), expected.size());
+  EXPECT_TRUE(std::equal(ms.begin(), ms.end(), expected.begin()));
+  const int* first = &*ms.begin();
+  std::ptrdiff_t stride = &*std::next(ms.begin()) - first;
+  EXPECT_GT(stride, 0);
+  std::ptrdiff_t index = 0;
+  for (auto it = ms.begin(); it != ms.end(); ++it, ++index) {
+    EXPECT_EQ(&*it - first, stride * index);
+  }
+
+  ms.insert(7);
+  EXPECT_EQ(ms.count(7), expected.count(7) + 1);
+  ms.clear();
+  ms.insert(3);
+  EXPECT_EQ(ms.size(), 1);
+}
+
+TEST(MultisetTest, NodeHandlesAndMergeRelinkNodes) {
+  s21::multiset<std::string> shard;
+  shard.insert("b");
+  {
+    s21::multiset<std::string> source = {"a", "b", "b", "c"};
+    const std::string* second_b = &*std::next(source.lower_bound("b"));
+    auto nh = source.extract(source.find("a"));
+    ASSERT_FALSE(nh.empty());
+    EXPECT_EQ(nh.value(), "a");
+    nh.value() = "d";
+    auto it = source.insert(std::move(nh));
+    EXPECT_TRUE(nh.empty());
+    EXPECT_EQ(*it, "d");
+    EXPECT_EQ(source.size(), 4);
+    EXPECT_TRUE(source.extract("zzz").empty());
+    EXPECT_EQ(source.insert(decltype(nh)()), source.end());
+
+    shard.merge(source);
+    EXPECT_TRUE(source.empty());
+    EXPECT_EQ(&*std::next(shard.lower_bound("b"), 2), second_b);
+    source.insert("x");
+    shard.insert(source.extract("x"));
+  }
+
+  std::vector<std::string> expected = {"b", "b", "b", "c", "d", "x"};
+  EXPECT_TRUE(std::equal(shard.begin(), shard.end(), expected.begin(),
+                         expected.end()));
+  shard.erase(shard.find("c"));
+  shard.insert("a");
+  EXPECT_EQ(*shard.begin(), "a");
+  EXPECT_EQ(shard.size(), 6);
+}
+
+TEST(MultisetTest, MergeSourceAndTargetFreeTheirOwnSlabs) {
+  struct live_bytes_resource : std::pmr::memory_resource {
+    size_t live = 0;
+    void* do_allocate(size_t bytes, size_t align) override {
+      live += bytes;
+      return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t align) override {
+      live -= bytes;
+      std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+      return this == &other;
+    }
+  } resource;
+
+  s21::pmr::multiset<int> other(&resource);
+  size_t empty = resource.live;
+  size_t refilled = 0;
+  {
+    s21::pmr::multiset<int> target(&resource);
+    target.insert(-1);
+    for (int i = 0; i < 100; ++i) other.insert(i % 10);
+    size_t before = resource.live;
+    target.merge(other);
+    EXPECT_EQ(resource.live, before);
+    for (int i = 0; i < 100; ++i) other.insert(i);
+    refilled = resource.live - before;
+    for (int i = 0; i < 10; ++i) target.erase(target.find(i));
+  }
+  // the target took the merged slabs with it, other kept its new ones
+  EXPECT_EQ(resource.live, empty + refilled);
+  EXPECT_EQ(other.size(), 100);
+  other.clear();
+  EXPECT_EQ(resource.live, empty);
+}
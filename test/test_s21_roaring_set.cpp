@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "../src/s21_roaring_set/s21_roaring_set.h"
+#include "../src/s21_set/s21_set.h"
+
+namespace {
+
+// sparse keys, a dense block past the array limit and a long range, so
+// every chunk kind shows up
+std::vector<std::uint32_t> mixed_keys(unsigned seed) {
+  std::mt19937 gen(seed);
+  std::vector<std::uint32_t> keys;
+  for (int i = 0; i < 3000; ++i) keys.push_back(gen());
+  for (int i = 0; i < 6000; ++i) keys.push_back((7u << 16) | (gen() & 0xFFFF));
+  for (std::uint32_t key = 0x90000; key < 0x90000 + 70000; ++key) {
+    keys.push_back(key);
+  }
+  keys.push_back(0);
+  keys.push_back(UINT32_MAX);
+  return keys;
+}
+
+template <typename Set>
+std::vector<std::uint32_t> contents(const Set& s) {
+  return std::vector<std::uint32_t>(s.begin(), s.end());
+}
+
+}  // namespace
+
+TEST(RoaringSetTest, DefaultConstructor) {
+  s21::roaring_set<> s;
+  EXPECT_TRUE(s.empty());
+  EXPECT_EQ(s.size(), 0);
+  EXPECT_EQ(s.begin(), s.end());
+  EXPECT_FALSE(s.contains(0));
+}
+
+TEST(RoaringSetTest, InsertEraseMatchStd) {
+  std::mt19937 gen(20);
+  std::uniform_int_distribution<std::uint32_t> key_of(0, 300000);
+  s21::roaring_set<> s;
+  std::set<std::uint32_t> expected;
+  for (int step = 0; step < 60000; ++step) {
+    std::uint32_t key = key_of(gen);
+    if (step % 4 == 0) {
+      ASSERT_EQ(s.erase(key), expected.erase(key)) << step;
+    } else {
+      auto [it, inserted] = s.insert(key);
+      ASSERT_EQ(inserted, expected.insert(key).second) << step;
+      ASSERT_EQ(*it, key);
+    }
+    std::uint32_t probe = key_of(gen);
+    ASSERT_EQ(s.contains(probe), expected.count(probe) == 1) << step;
+  }
+  EXPECT_EQ(s.size(), expected.size());
+  EXPECT_EQ(contents(s), contents(expected));
+}
+
+TEST(RoaringSetTest, IterationAcrossChunkKinds) {
+  std::vector<std::uint32_t> keys = mixed_keys(1);
+  s21::roaring_set<> s(keys.begin(), keys.end());
+  std::set<std::uint32_t> expected(keys.begin(), keys.end());
+  EXPECT_EQ(s.size(), expected.size());
+  EXPECT_EQ(contents(s), contents(expected));
+
+  std::vector<std::uint32_t> backwards;
+  for (auto it = s.end(); it != s.begin();) backwards.push_back(*--it);
+  EXPECT_TRUE(std::equal(backwards.begin(), backwards.end(),
+                         expected.rbegin(), expected.rend()));
+
+  s.run_optimize();
+  EXPECT_EQ(contents(s), contents(expected));
+  backwards.clear();
+  for (auto it = s.end(); it != s.begin();) backwards.push_back(*--it);
+  EXPECT_TRUE(std::equal(backwards.begin(), backwards.end(),
+                         expected.rbegin(), expected.rend()));
+}
+
+TEST(RoaringSetTest, FindAndBounds) {
+  std::vector<std::uint32_t> keys = mixed_keys(2);
+  s21::roaring_set<> s(keys.begin(), keys.end());
+  std::set<std::uint32_t> expected(keys.begin(), keys.end());
+  for (int pass = 0; pass < 2; ++pass) {
+    std::mt19937 gen(3);
+    for (int i = 0; i < 20000; ++i) {
+      std::uint32_t probe = i % 2 ? gen() : 0x90000 + gen() % 80000;
+      auto lower = expected.lower_bound(probe);
+      auto it = s.lower_bound(probe);
+      ASSERT_EQ(it == s.end(), lower == expected.end()) << probe;
+      if (lower != expected.end()) {
+        ASSERT_EQ(*it, *lower);
+      }
+      auto upper = expected.upper_bound(probe);
+      auto up = s.upper_bound(probe);
+      ASSERT_EQ(up == s.end(), upper == expected.end()) << probe;
+      if (upper != expected.end()) {
+        ASSERT_EQ(*up, *upper);
+      }
+      ASSERT_EQ(s.count(probe), expected.count(probe));
+      ASSERT_EQ(s.find(probe) != s.end(), expected.count(probe) == 1);
+    }
+    s.run_optimize();
+  }
+  EXPECT_EQ(*s.find(UINT32_MAX), UINT32_MAX);
+  EXPECT_EQ(s.upper_bound(UINT32_MAX), s.end());
+}
+
+TEST(RoaringSetTest, RunsStayCorrectUnderEdits) {
+  s21::roaring_set<> s;
+  std::set<std::uint32_t> expected;
+  for (std::uint32_t key = 1000; key < 60000; ++key) {
+    s.insert(key);
+    expected.insert(key);
+  }
+  s.run_optimize();
+  std::size_t compact = s.memory_usage();
+  EXPECT_LT(compact, 200);
+
+  std::mt19937 gen(4);
+  for (int i = 0; i < 3000; ++i) {
+    std::uint32_t key = gen() % 70000;
+    if (i % 2) {
+      ASSERT_EQ(s.erase(key), expected.erase(key));
+    } else {
+      ASSERT_EQ(s.insert(key).second, expected.insert(key).second);
+    }
+  }
+  EXPECT_EQ(s.size(), expected.size());
+  EXPECT_EQ(contents(s), contents(expected));
+}
+
+TEST(RoaringSetTest, SetAlgebraMatchesStd) {
+  std::vector<std::uint32_t> left = mixed_keys(5);
+  std::vector<std::uint32_t> right = mixed_keys(6);
+  for (std::uint32_t key = 0x90000 + 30000; key < 0x90000 + 100000; key += 3) {
+    right.push_back(key);
+  }
+  std::set<std::uint32_t> ra(left.begin(), left.end());
+  std::set<std::uint32_t> rb(right.begin(), right.end());
+
+  for (int optimized = 0; optimized < 2; ++optimized) {
+    s21::roaring_set<> a(left.begin(), left.end());
+    s21::roaring_set<> b(right.begin(), right.end());
+    if (optimized) {
+      a.run_optimize();
+      b.run_optimize();
+    }
+    auto check = [&](const s21::roaring_set<>& result, auto algorithm) {
+      std::vector<std::uint32_t> expected;
+      algorithm(ra.begin(), ra.end(), rb.begin(), rb.end(),
+                std::back_inserter(expected));
+      ASSERT_EQ(result.size(), expected.size());
+      ASSERT_EQ(contents(result), expected);
+    };
+    check(s21::set_union(a, b), [](auto... args) {
+      return std::set_union(args...);
+    });
+    check(s21::set_intersection(a, b), [](auto... args) {
+      return std::set_intersection(args...);
+    });
+    check(s21::set_difference(a, b), [](auto... args) {
+      return std::set_difference(args...);
+    });
+    check(s21::set_symmetric_difference(a, b), [](auto... args) {
+      return std::set_symmetric_difference(args...);
+    });
+
+    a.merge(b);
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(a.size(), s21::set_union(a, b).size());
+  }
+}
+
+TEST(RoaringSetTest, DenseIdsTakeAboutABitEach) {
+  std::vector<std::uint32_t> ids;
+  std::mt19937 gen(8);
+  for (std::uint32_t id = 0; id < 2000000; ++id) {
+    if (gen() % 4 != 0) ids.push_back(id);
+  }
+  s21::roaring_set<> s(ids.begin(), ids.end());
+  EXPECT_EQ(s.size(), ids.size());
+  EXPECT_LT(s.memory_usage(), ids.size() / 4);
+}
+
+TEST(RoaringSetTest, CopyMoveSwapAndInsertMany) {
+  s21::roaring_set<> s = {5, 1, 70000, 1};
+  auto results = s.insert_many(2u, 5u, 200000u);
+  EXPECT_TRUE(results[0].second);
+  EXPECT_FALSE(results[1].second);
+  EXPECT_EQ(*results[2].first, 200000u);
+
+  s21::roaring_set<> copy(s);
+  EXPECT_EQ(contents(copy), (std::vector<std::uint32_t>{1, 2, 5, 70000,
+                                                        200000}));
+  s21::roaring_set<> moved(std::move(copy));
+  EXPECT_TRUE(copy.empty());
+  s21::roaring_set<> other = {9};
+  moved.swap(other);
+  EXPECT_EQ(moved.size(), 1);
+  EXPECT_EQ(other.size(), 5);
+  other.erase(other.find(70000));
+  other = moved;
+  EXPECT_EQ(contents(other), std::vector<std::uint32_t>{9});
+}
+
+TEST(RoaringSetTest, PmrAllocatesFromResource) {
+  std::pmr::monotonic_buffer_resource arena;
+  std::pmr::memory_resource* previous =
+      std::pmr::set_default_resource(std::pmr::null_memory_resource());
+  {
+    s21::pmr::roaring_set s(&arena);
+    for (std::uint32_t key = 0; key < 10000; key += 2) s.insert(key);
+    s21::pmr::roaring_set copy(s, &arena);
+    s.run_optimize();
+    auto both = s21::set_intersection(s, copy);
+    EXPECT_EQ(both.size(), 5000);
+    EXPECT_EQ(both.get_allocator().resource(), &arena);
+  }
+  std::pmr::set_default_resource(previous);
+}
+
+TEST(RoaringSetTest, PmrMoveAssignAcrossResourcesCopies) {
+  std::pmr::monotonic_buffer_resource target_arena;
+  s21::pmr::roaring_set target(&target_arena);
+  target.insert(1);
+  {
+    std::pmr::monotonic_buffer_resource source_arena;
+    s21::pmr::roaring_set source(&source_arena);
+    for (std::uint32_t key = 0; key < 20000; key += 3) source.insert(key);
+    for (std::uint32_t key = 70000; key < 140000; ++key) source.insert(key);
+    target = std::move(source);
+    EXPECT_TRUE(source.empty());
+  }
+  EXPECT_EQ(target.get_allocator().resource(), &target_arena);
+  EXPECT_EQ(target.size(), 6667 + 70000);
+  std::size_t seen = 0;
+  for (std::uint32_t key : target) {
+    EXPECT_TRUE(key % 3 == 0 || key >= 70000);
+    ++seen;
+  }
+  EXPECT_EQ(seen, target.size());
+  static_assert(!std::is_nothrow_move_assignable_v<s21::pmr::roaring_set>);
+  static_assert(std::is_nothrow_move_assignable_v<s21::roaring_set<>>);
+}
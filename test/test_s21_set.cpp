@@ -1,5 +1,13 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "../src/s21_set/s21_set.h"
 
 TEST(SetTest, DefaultConstructor) {
@@ -626,3 +634,567 @@ TEST(SetTest, InsertManyWithMoveSemantics) {
     EXPECT_TRUE(results[i].second) << "Failed at index " << i;
   }
 }
+
+TEST(SetTest, PmrAllocatesFromResource) {
+  alignas(std::max_align_t) std::byte buffer[4096];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                            std::pmr::null_memory_resource());
+
+  s21::pmr::set<int> s(&arena);
+  for (int i = 10; i > 0; --i) s.insert(i);
+
+  EXPECT_EQ(s.get_allocator().resource(), &arena);
+  EXPECT_EQ(s.size(), 10);
+  EXPECT_EQ(*s.begin(), 1);
+  const std::byte* data = reinterpret_cast<const std::byte*>(&*s.begin());
+  EXPECT_TRUE(data >= buffer && data < buffer + sizeof(buffer));
+}
+
+TEST(SetTest, RangeConstructorSortsAndDeduplicates) {
+  std::string words[] = {"pear", "apple", "fig", "apple", "kiwi", "fig"};
+  s21::set<std::string> s(std::begin(words), std::end(words));
+  EXPECT_EQ(s.size(), 4);
+  EXPECT_EQ(*s.begin(), "apple");
+  EXPECT_TRUE(std::is_sorted(s.begin(), s.end()));
+  EXPECT_TRUE(s.contains("kiwi"));
+}
+
+TEST(SetTest, VectorConstructorRadixSortsIntegralKeys) {
+  s21::vector<long long> keys;
+  std::mt19937_64 gen(42);
+  std::set<long long> reference;
+  for (int i = 0; i < 20000; ++i) {
+    long long key = static_cast<long long>(gen() % 5000) - 2500;
+    if (i % 7 == 0) key *= 1000000007LL;
+    keys.push_back(key);
+    reference.insert(key);
+  }
+  s21::set<long long> s(std::move(keys));
+  ASSERT_EQ(s.size(), reference.size());
+  EXPECT_TRUE(std::equal(s.begin(), s.end(), reference.begin()));
+}
+
+TEST(SetTest, RadixSortUnsignedAndSmallKeys) {
+  s21::vector<unsigned char> bytes;
+  for (int i = 0; i < 1000; ++i) bytes.push_back((i * 37) % 256);
+  s21::set<unsigned char> s(std::move(bytes));
+  EXPECT_EQ(s.size(), 256);
+  EXPECT_EQ(*s.begin(), 0);
+
+  s21::vector<unsigned> same(500);
+  for (auto& x : same) x = 7;
+  s21::set<unsigned> one(std::move(same));
+  EXPECT_EQ(one.size(), 1);
+}
+
+TEST(SetTest, CopyConstructorKeepsOrder) {
+  s21::set<int> s1 = {5, 1, 3, 1};
+  s21::set<int> s2(s1);
+  EXPECT_EQ(s2.size(), 3);
+  EXPECT_TRUE(std::equal(s1.begin(), s1.end(), s2.begin()));
+}
+
+TEST(SetTest, MergeInterleavedLinear) {
+  s21::vector<int> evens, thirds;
+  for (int i = 0; i < 30000; i += 2) evens.push_back(i);
+  for (int i = 0; i < 30000; i += 3) thirds.push_back(i);
+  s21::set<int> a(std::move(evens));
+  s21::set<int> b(std::move(thirds));
+  a.merge(b);
+
+  std::set<int> reference;
+  for (int i = 0; i < 30000; ++i) {
+    if (i % 2 == 0 || i % 3 == 0) reference.insert(i);
+  }
+  ASSERT_EQ(a.size(), reference.size());
+  EXPECT_TRUE(std::equal(a.begin(), a.end(), reference.begin()));
+  EXPECT_TRUE(b.empty());
+}
+
+TEST(SetTest, MergeAppendsDisjointTail) {
+  s21::set<std::string> a = {"a", "b"};
+  s21::set<std::string> b = {"c", "d"};
+  a.merge(b);
+  EXPECT_EQ(a.size(), 4);
+  EXPECT_EQ(*(--a.end()), "d");
+}
+
+TEST(SetTest, InsertManyRepeatedArgumentsAndValidIterators) {
+  s21::set<int> s = {10, 20};
+  auto results = s.insert_many(15, 5, 15, 20, 25);
+  ASSERT_EQ(results.size(), 5);
+  EXPECT_TRUE(results[0].second);
+  EXPECT_TRUE(results[1].second);
+  EXPECT_FALSE(results[2].second);
+  EXPECT_FALSE(results[3].second);
+  EXPECT_TRUE(results[4].second);
+  int expected[] = {15, 5, 15, 20, 25};
+  for (int i = 0; i < 5; ++i) EXPECT_EQ(*results[i].first, expected[i]);
+  EXPECT_EQ(s.size(), 5);
+  EXPECT_TRUE(std::is_sorted(s.begin(), s.end()));
+}
+
+TEST(SetTest, InsertManyNoArguments) {
+  s21::set<int> s = {1};
+  auto results = s.insert_many();
+  EXPECT_TRUE(results.empty());
+  EXPECT_EQ(s.size(), 1);
+}
+
+TEST(SetTest, HintedInsertAscendingAtEnd) {
+  s21::set<int> s;
+  for (int i = 0; i < 1000; ++i) {
+    auto it = s.insert(s.end(), i);
+    EXPECT_EQ(*it, i);
+  }
+  EXPECT_EQ(s.size(), 1000);
+  EXPECT_TRUE(std::is_sorted(s.begin(), s.end()));
+}
+
+TEST(SetTest, HintedInsertWrongHintOrDuplicate) {
+  s21::set<int> s = {10, 20, 30};
+  auto it = s.insert(s.begin(), 25);
+  EXPECT_EQ(*it, 25);
+  it = s.insert(s.find(30), 20);
+  EXPECT_EQ(*it, 20);
+  it = s.insert(s.find(20), 15);
+  EXPECT_EQ(*it, 15);
+  EXPECT_EQ(s.size(), 5);
+  int expected[] = {10, 15, 20, 25, 30};
+  EXPECT_TRUE(std::equal(s.begin(), s.end(), std::begin(expected)));
+}
+
+TEST(SetTest, InsertAndEraseReturnPositions) {
+  s21::set<int> s = {1, 3, 5};
+  auto [it, inserted] = s.insert(4);
+  EXPECT_TRUE(inserted);
+  EXPECT_EQ(*(it - 1), 3);
+  EXPECT_EQ(*(it + 1), 5);
+  s.erase(it - 1);
+  int expected[] = {1, 4, 5};
+  EXPECT_TRUE(std::equal(s.begin(), s.end(), std::begin(expected)));
+}
+
+TEST(SetTest, SearchIndexBuiltByBulkLoad) {
+  s21::vector<int> keys;
+  for (int i = 0; i < 10000; ++i) keys.push_back(3 * i);
+  s21::set<int> s(std::move(keys));
+  ASSERT_TRUE(s.has_search_index());
+  for (int i = -3; i < 30003; ++i) {
+    bool expected = i >= 0 && i % 3 == 0 && i < 30000;
+    ASSERT_EQ(s.contains(i), expected) << i;
+    auto it = s.find(i);
+    if (expected) {
+      ASSERT_NE(it, s.end());
+      ASSERT_EQ(*it, i);
+    } else {
+      ASSERT_EQ(it, s.end());
+    }
+  }
+}
+
+TEST(SetTest, SearchIndexEveryTreeShape) {
+  const int min_size = s21::set<int>::search_index_min_size;
+  for (int n = min_size; n < min_size + 70; ++n) {
+    s21::vector<int> keys;
+    for (int i = 0; i < n; ++i) keys.push_back(2 * i);
+    const s21::set<int> s(std::move(keys));
+    ASSERT_TRUE(s.has_search_index());
+    for (int i = 0; i < n; ++i) {
+      auto it = s.find(2 * i);
+      ASSERT_NE(it, s.end());
+      ASSERT_EQ(*it, 2 * i);
+      ASSERT_FALSE(s.contains(2 * i + 1));
+    }
+  }
+}
+
+TEST(SetTest, SearchIndexStaleAfterInsertUntilRebuilt) {
+  s21::vector<std::string> keys;
+  for (int i = 0; i < 5000; ++i) keys.push_back(std::to_string(i));
+  s21::set<std::string> s(std::move(keys));
+  EXPECT_TRUE(s.has_search_index());
+  s.insert("new");
+  EXPECT_FALSE(s.has_search_index());
+  EXPECT_TRUE(s.contains("new"));
+  s.erase(s.find("42"));
+  EXPECT_FALSE(s.contains("42"));
+  s.rebuild_index();
+  EXPECT_TRUE(s.has_search_index());
+  EXPECT_TRUE(s.contains("new"));
+  EXPECT_FALSE(s.contains("42"));
+  EXPECT_EQ(*s.find("4999"), "4999");
+
+  s21::set<std::string> copy(s);
+  EXPECT_TRUE(copy.has_search_index());
+  s.clear();
+  EXPECT_FALSE(s.has_search_index());
+}
+
+template <typename T>
+void ExpectBranchlessLowerBoundMatchesStd(T step) {
+  for (int n = 0; n < 70; ++n) {
+    s21::vector<T> keys;
+    for (int i = 0; i < n; ++i) keys.push_back(static_cast<T>(i * step));
+    const T* first = keys.data();
+    for (int i = -1; i <= n; ++i) {
+      for (T key : {static_cast<T>(i * step), static_cast<T>(i * step + 1)}) {
+        ASSERT_EQ(s21::branchless_lower_bound(first, keys.size(), key),
+                  std::lower_bound(first, first + keys.size(), key))
+            << "n = " << n << ", key = " << key;
+      }
+    }
+  }
+}
+
+TEST(SetTest, BranchlessLowerBoundMatchesStd) {
+  ExpectBranchlessLowerBoundMatchesStd<int>(3);
+  ExpectBranchlessLowerBoundMatchesStd<unsigned>(3);
+  ExpectBranchlessLowerBoundMatchesStd<int64_t>(3);
+  ExpectBranchlessLowerBoundMatchesStd<uint64_t>(3);
+  ExpectBranchlessLowerBoundMatchesStd<short>(3);
+  ExpectBranchlessLowerBoundMatchesStd<float>(3.0f);
+  ExpectBranchlessLowerBoundMatchesStd<double>(2.5);
+}
+
+TEST(SetTest, BranchlessLowerBoundFullKeyRange) {
+  // unsigned keys above the signed maximum and negative keys below zero
+  // exercise the sign handling of the vector kernels
+  s21::vector<uint64_t> wide;
+  s21::vector<int> mixed;
+  for (int i = 0; i < 40; ++i) {
+    wide.push_back(uint64_t(i) << 58);
+    mixed.push_back((i - 20) * 100000000);
+  }
+  for (std::size_t i = 0; i < wide.size(); ++i) {
+    EXPECT_EQ(s21::branchless_lower_bound(wide.data(), wide.size(), wide[i]),
+              wide.data() + i);
+    EXPECT_EQ(
+        s21::branchless_lower_bound(mixed.data(), mixed.size(), mixed[i] - 1),
+        mixed.data() + i);
+  }
+}
+
+TEST(SetTest, ArithmeticKeysFindAndInsert) {
+  std::mt19937 gen(5);
+  s21::set<double> s;
+  std::set<double> reference;
+  for (int i = 0; i < 3000; ++i) {
+    double key = static_cast<double>(gen() % 5000) / 4;
+    EXPECT_EQ(s.insert(key).second, reference.insert(key).second);
+  }
+  ASSERT_TRUE(std::equal(s.begin(), s.end(), reference.begin(),
+                         reference.end()));
+  for (int i = 0; i < 5000; ++i) {
+    double key = static_cast<double>(i) / 4;
+    auto it = s.find(key);
+    if (reference.count(key)) {
+      ASSERT_NE(it, s.end());
+      EXPECT_EQ(*it, key);
+    } else {
+      EXPECT_EQ(it, s.end());
+    }
+  }
+
+  s21::set<uint64_t> wide = {~uint64_t(0), 0, uint64_t(1) << 63};
+  EXPECT_TRUE(wide.contains(~uint64_t(0)));
+  EXPECT_TRUE(wide.contains(uint64_t(1) << 63));
+  EXPECT_FALSE(wide.contains(1));
+}
+
+TEST(SetTest, LowerUpperBoundAndEqualRange) {
+  s21::set<int> s = {10, 20, 30, 40};
+  EXPECT_EQ(*s.lower_bound(20), 20);
+  EXPECT_EQ(*s.lower_bound(21), 30);
+  EXPECT_EQ(*s.upper_bound(20), 30);
+  EXPECT_EQ(*s.upper_bound(5), 10);
+  EXPECT_EQ(s.lower_bound(41), s.end());
+  EXPECT_EQ(s.upper_bound(40), s.end());
+
+  auto [first, last] = s.equal_range(30);
+  EXPECT_EQ(*first, 30);
+  EXPECT_EQ(*last, 40);
+  auto missing = s.equal_range(25);
+  EXPECT_EQ(missing.first, missing.second);
+  EXPECT_EQ(*missing.first, 30);
+
+  const s21::set<std::string>& words = s21::set<std::string>{"b", "d"};
+  EXPECT_EQ(*words.lower_bound("c"), "d");
+  EXPECT_EQ(words.upper_bound("d"), words.end());
+  EXPECT_EQ(words.equal_range("a").first, words.begin());
+}
+
+TEST(SetTest, RangeView) {
+  s21::set<int> s = {1, 3, 5, 7, 9, 11};
+  std::vector<int> window;
+  for (int key : s.range(3, 9)) window.push_back(key);
+  EXPECT_EQ(window, (std::vector<int>{3, 5, 7}));
+
+  EXPECT_EQ(std::ranges::distance(s.range(4, 5)), 0);
+  EXPECT_EQ(std::ranges::distance(s.range(0, 100)), 6);
+  EXPECT_TRUE(s.range(9, 3).empty());
+  EXPECT_TRUE(s.range(12, 20).empty());
+}
+
+TEST(SetTest, OrderedQueriesMatchStdWithAndWithoutIndex) {
+  s21::vector<int> keys;
+  std::set<int> reference;
+  for (int i = 0; i < 6000; ++i) {
+    keys.push_back(3 * i);
+    reference.insert(3 * i);
+  }
+  s21::set<int> s(std::move(keys));
+  for (bool indexed : {true, false}) {
+    ASSERT_EQ(s.has_search_index(), indexed);
+    for (int key = -2; key < 18010; key += 7) {
+      auto lower = std::distance(reference.begin(), reference.lower_bound(key));
+      auto upper = std::distance(reference.begin(), reference.upper_bound(key));
+      ASSERT_EQ(std::distance(s.begin(), s.lower_bound(key)), lower);
+      ASSERT_EQ(std::distance(s.begin(), s.upper_bound(key)), upper);
+      auto window = s.range(key, key + 100);
+      ASSERT_EQ(std::ranges::distance(window),
+                std::distance(reference.lower_bound(key),
+                              reference.lower_bound(key + 100)));
+    }
+    s.insert(-100);
+    s.erase(s.begin());
+  }
+}
+
+TEST(SetTest, SetAlgebraMatchesStd) {
+  std::mt19937 gen(17);
+  // similar sizes take the linear merge, skewed ones the galloping search
+  for (auto [n, m] : {std::pair{0, 0}, {0, 50}, {50, 0}, {300, 300},
+                      {1000, 7}, {7, 1000}, {5000, 1}, {20000, 600}}) {
+    s21::vector<int> left_keys, right_keys;
+    for (int i = 0; i < n; ++i) left_keys.push_back(gen() % 30000);
+    for (int i = 0; i < m; ++i) right_keys.push_back(gen() % 30000);
+    s21::set<int> a(left_keys.begin(), left_keys.end());
+    s21::set<int> b(right_keys.begin(), right_keys.end());
+    std::set<int> ra(a.begin(), a.end());
+    std::set<int> rb(b.begin(), b.end());
+
+    auto check = [&](const s21::set<int>& result, auto algorithm) {
+      std::vector<int> expected;
+      algorithm(ra.begin(), ra.end(), rb.begin(), rb.end(),
+                std::back_inserter(expected));
+      ASSERT_TRUE(std::equal(result.begin(), result.end(), expected.begin(),
+                             expected.end()))
+          << n << " x " << m;
+      for (int key : expected) ASSERT_TRUE(result.contains(key));
+    };
+    check(s21::set_union(a, b), [](auto... args) {
+      return std::set_union(args...);
+    });
+    check(s21::set_intersection(a, b), [](auto... args) {
+      return std::set_intersection(args...);
+    });
+    check(s21::set_difference(a, b), [](auto... args) {
+      return std::set_difference(args...);
+    });
+    check(s21::set_symmetric_difference(a, b), [](auto... args) {
+      return std::set_symmetric_difference(args...);
+    });
+  }
+}
+
+TEST(SetTest, SetAlgebraStrings) {
+  s21::set<std::string> a = {"apple", "kiwi", "lime", "pear"};
+  s21::set<std::string> b = {"kiwi", "pear", "plum"};
+  auto only_a = s21::set_difference(a, b);
+  auto either = s21::set_symmetric_difference(a, b);
+  EXPECT_EQ(s21::set_intersection(a, b).size(), 2);
+  EXPECT_TRUE(std::equal(only_a.begin(), only_a.end(),
+                         std::vector<std::string>{"apple", "lime"}.begin()));
+  EXPECT_EQ(either.size(), 3);
+  EXPECT_TRUE(either.contains("plum"));
+  EXPECT_EQ(s21::set_union(a, b).size(), 5);
+}
+
+TEST(SetTest, TransparentLookup) {
+  s21::set<std::string, std::allocator<std::string>, std::less<>> s = {
+      "apple", "kiwi", "lime", "pear"};
+  std::string_view probe = "lime";
+  EXPECT_TRUE(s.contains(probe));
+  EXPECT_FALSE(s.contains("plum"));
+  EXPECT_EQ(s.count("kiwi"), 1);
+  EXPECT_EQ(s.count(std::string_view("fig")), 0);
+  EXPECT_EQ(*s.find(probe), "lime");
+  EXPECT_EQ(s.find("fig"), s.end());
+  EXPECT_EQ(*s.lower_bound("l"), "lime");
+  EXPECT_EQ(*s.upper_bound(std::string_view("kiwi")), "lime");
+  auto [lo, hi] = s.equal_range("pear");
+  EXPECT_EQ(std::distance(lo, hi), 1);
+
+  s.rebuild_index();
+  EXPECT_TRUE(s.contains(std::string_view("apple")));
+  EXPECT_EQ(*s.lower_bound("m"), "pear");
+}
+
+TEST(SetTest, CustomComparatorOrdersDescending) {
+  s21::set<int, std::allocator<int>, std::greater<int>> s{std::greater<int>()};
+  std::vector<int> keys(200);
+  for (int i = 0; i < 200; ++i) keys[i] = (i * 37) % 200;
+  for (int key : keys) s.insert(key);
+  s.insert(5);
+
+  EXPECT_EQ(s.size(), 200);
+  EXPECT_TRUE(std::is_sorted(s.begin(), s.end(), std::greater<int>()));
+  EXPECT_EQ(*s.begin(), 199);
+  s.rebuild_index();
+  for (int key = -3; key < 203; ++key) {
+    EXPECT_EQ(s.contains(key), key >= 0 && key < 200) << key;
+    EXPECT_EQ(s.count(key), key >= 0 && key < 200 ? 1u : 0u) << key;
+  }
+  EXPECT_EQ(*s.lower_bound(250), 199);
+  EXPECT_EQ(*s.upper_bound(100), 99);
+  EXPECT_EQ(s.lower_bound(-1), s.end());
+
+  s21::set<int, std::allocator<int>, std::greater<int>> other;
+  for (int key = 150; key < 300; ++key) other.insert(key);
+  auto both = s21::set_intersection(s, other);
+  EXPECT_EQ(both.size(), 50);
+  EXPECT_EQ(*both.begin(), 199);
+}
+
+TEST(SetTest, BufferedWritesMatchStd) {
+  std::mt19937 gen(19);
+  std::uniform_int_distribution<int> key_of(0, 3000);
+  s21::set<int> s;
+  std::set<int> expected;
+  for (int step = 0; step < 20000; ++step) {
+    int key = key_of(gen);
+    if (step % 3 == 0) {
+      ASSERT_EQ(s.buffered_erase(key), expected.erase(key)) << step;
+    } else {
+      ASSERT_EQ(s.buffered_insert(key), expected.insert(key).second) << step;
+    }
+    ASSERT_EQ(s.size(), expected.size());
+    int probe = key_of(gen);
+    ASSERT_EQ(s.contains(probe), expected.count(probe) == 1) << step;
+    if (step % 997 == 0) {
+      // an ordered query merges the buffer
+      auto it = s.lower_bound(probe);
+      auto std_it = expected.lower_bound(probe);
+      ASSERT_EQ(it == s.end(), std_it == expected.end());
+      if (std_it != expected.end()) {
+        ASSERT_EQ(*it, *std_it);
+      }
+      ASSERT_EQ(s.pending_writes(), 0);
+    }
+  }
+  EXPECT_TRUE(std::equal(s.begin(), s.end(), expected.begin(), expected.end()));
+}
+
+TEST(SetTest, BufferedWritesTombstonesAndFlush) {
+  s21::set<int> s = {1, 2, 3, 4, 5};
+  EXPECT_EQ(s.buffered_erase(3), 1);
+  EXPECT_EQ(s.buffered_erase(3), 0);
+  EXPECT_FALSE(s.contains(3));
+  EXPECT_TRUE(s.buffered_insert(3));  // drops the tombstone
+  EXPECT_FALSE(s.buffered_insert(3));
+  EXPECT_TRUE(s.buffered_insert(9));
+  EXPECT_EQ(s.buffered_erase(9), 1);  // never reaches the keys
+  EXPECT_EQ(s.buffered_erase(4), 1);
+  EXPECT_TRUE(s.buffered_insert(0));
+  EXPECT_EQ(s.pending_writes(), 2);
+  EXPECT_EQ(s.size(), 5);
+  EXPECT_EQ(s.count(0), 1);
+  EXPECT_EQ(s.count(4), 0);
+
+  const s21::set<int> copy(s);
+  EXPECT_EQ(copy.pending_writes(), 2);
+  EXPECT_TRUE(std::equal(copy.begin(), copy.end(),
+                         std::vector<int>{0, 1, 2, 3, 5}.begin()));
+
+  s.flush();
+  EXPECT_EQ(s.pending_writes(), 0);
+  EXPECT_TRUE(std::equal(s.begin(), s.end(), copy.begin(), copy.end()));
+
+  // the buffer merges on its own once it outgrows its limit
+  s21::set<int> grown;
+  for (int key = 1000; key > 0; --key) grown.buffered_insert(key);
+  EXPECT_LT(grown.pending_writes(), 1000);
+  EXPECT_EQ(grown.size(), 1000);
+  EXPECT_EQ(*grown.begin(), 1);
+
+  s21::set<int> indexed;
+  for (int key = 0; key < 3 * 4096; ++key) indexed.buffered_insert(key);
+  indexed.flush();
+  EXPECT_TRUE(indexed.has_search_index());
+  EXPECT_TRUE(indexed.contains(4096));
+}
+
+TEST(SetTest, ConstReadsSeePendingWritesWithoutMerging) {
+  std::mt19937 gen(23);
+  std::uniform_int_distribution<int> key_of(0, 6000);
+  s21::set<int> s;
+  std::set<int> expected;
+  for (int key = 0; key < 6000; key += 2) {
+    s.insert(key);
+    expected.insert(key);
+  }
+  s.flush();
+  const s21::set<int>& view = s;
+  for (int step = 0; step < 3000; ++step) {
+    int key = key_of(gen);
+    if (step % 2 == 0) {
+      ASSERT_EQ(s.buffered_erase(key), expected.erase(key)) << step;
+    } else {
+      ASSERT_EQ(s.buffered_insert(key), expected.insert(key).second) << step;
+    }
+    size_t pending = view.pending_writes();
+
+    int probe = key_of(gen);
+    auto held = view.lower_bound(probe);
+    auto std_lower = expected.lower_bound(probe);
+    ASSERT_EQ(held == view.end(), std_lower == expected.end()) << step;
+    if (std_lower != expected.end()) {
+      ASSERT_EQ(*held, *std_lower) << step;
+    }
+    auto std_upper = expected.upper_bound(probe);
+    auto upper = view.upper_bound(probe);
+    ASSERT_EQ(upper == view.end(), std_upper == expected.end()) << step;
+    if (std_upper != expected.end()) {
+      ASSERT_EQ(*upper, *std_upper) << step;
+    }
+    auto found = view.find(probe);
+    ASSERT_EQ(found != view.end(), expected.count(probe) == 1) << step;
+    if (found != view.end()) {
+      ASSERT_EQ(*found, probe);
+    }
+    auto [first, last] = view.equal_range(probe);
+    ASSERT_EQ(std::distance(first, last), expected.count(probe)) << step;
+    ASSERT_TRUE(first == held);
+    if (held != view.begin()) {
+      ASSERT_EQ(*std::prev(held), *std::prev(std_lower)) << step;
+    }
+    auto window = view.range(probe, probe + 40);
+    ASSERT_TRUE(std::equal(window.begin(), window.end(), std_lower,
+                           expected.lower_bound(probe + 40)))
+        << step;
+
+    // other readers neither merge the buffer nor move the held iterator
+    ASSERT_EQ(view.pending_writes(), pending);
+    if (std_lower != expected.end()) {
+      ASSERT_EQ(*held, *std_lower) << step;
+    }
+  }
+  ASSERT_GT(view.pending_writes(), 0);
+  EXPECT_EQ(std::distance(view.begin(), view.end()), view.size());
+  EXPECT_TRUE(std::equal(view.begin(), view.end(), expected.begin(),
+                         expected.end()));
+  std::vector<int> reversed(expected.rbegin(), expected.rend());
+  EXPECT_TRUE(std::equal(std::make_reverse_iterator(view.end()),
+                         std::make_reverse_iterator(view.begin()),
+                         reversed.begin(), reversed.end()));
+
+  const s21::set<int> odd = {1, 3, 5, 7, 9};
+  auto both = s21::set_intersection(view, odd);
+  EXPECT_GT(view.pending_writes(), 0);
+  std::vector<int> std_both;
+  std::set_intersection(expected.begin(), expected.end(), odd.begin(),
+                        odd.end(), std::back_inserter(std_both));
+  EXPECT_TRUE(
+      std::equal(both.begin(), both.end(), std_both.begin(), std_both.end()));
+}
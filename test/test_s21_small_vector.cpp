@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+
+#include "../src/s21_small_vector/s21_small_vector.h"
+
+namespace {
+
+// Counts heap allocations that reach the upstream resource.
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  int allocations = 0;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t align) override {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+  void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+  bool do_is_equal(const memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+}  // namespace
+
+TEST(SmallVectorTest, DefaultConstructorIsInline) {
+  s21::small_vector<int, 4> v;
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(v.capacity(), 4);
+  EXPECT_TRUE(v.is_inline());
+}
+
+TEST(SmallVectorTest, StaysInlineUpToN) {
+  CountingResource resource;
+  s21::pmr::small_vector<int, 4> v(&resource);
+  for (int i = 0; i < 4; ++i) v.push_back(i);
+  EXPECT_TRUE(v.is_inline());
+  EXPECT_EQ(resource.allocations, 0);
+  EXPECT_EQ(v.size(), 4);
+  EXPECT_EQ(v[3], 3);
+}
+
+TEST(SmallVectorTest, SpillsToHeapPastN) {
+  CountingResource resource;
+  s21::pmr::small_vector<int, 4> v(&resource);
+  for (int i = 0; i < 5; ++i) v.push_back(i);
+  EXPECT_FALSE(v.is_inline());
+  EXPECT_EQ(resource.allocations, 1);
+  EXPECT_GE(v.capacity(), 5);
+  for (int i = 0; i < 5; ++i) EXPECT_EQ(v[i], i);
+}
+
+TEST(SmallVectorTest, ShrinkToFitReturnsInline) {
+  s21::small_vector<std::string, 2> v = {"a", "b", "c"};
+  EXPECT_FALSE(v.is_inline());
+  v.pop_back();
+  v.shrink_to_fit();
+  EXPECT_TRUE(v.is_inline());
+  EXPECT_EQ(v.capacity(), 2);
+  EXPECT_EQ(v[0], "a");
+  EXPECT_EQ(v[1], "b");
+}
+
+TEST(SmallVectorTest, CopyInlineAndHeap) {
+  s21::small_vector<std::string, 2> small = {"x"};
+  s21::small_vector<std::string, 2> big = {"a", "b", "c"};
+  s21::small_vector<std::string, 2> c1(small);
+  s21::small_vector<std::string, 2> c2(big);
+  EXPECT_TRUE(c1.is_inline());
+  EXPECT_FALSE(c2.is_inline());
+  EXPECT_EQ(c1[0], "x");
+  EXPECT_EQ(c2[2], "c");
+  c1 = big;
+  EXPECT_EQ(c1.size(), 3);
+  EXPECT_EQ(c1[1], "b");
+}
+
+TEST(SmallVectorTest, MoveStealsHeapBuffer) {
+  s21::small_vector<int, 2> v = {1, 2, 3};
+  const int* heap = v.data();
+  s21::small_vector<int, 2> moved(std::move(v));
+  EXPECT_EQ(moved.data(), heap);
+  EXPECT_TRUE(v.empty());
+  EXPECT_TRUE(v.is_inline());
+}
+
+TEST(SmallVectorTest, MoveInlineMovesElements) {
+  s21::small_vector<std::string, 4> v = {"one", "two"};
+  s21::small_vector<std::string, 4> moved;
+  moved = std::move(v);
+  EXPECT_TRUE(moved.is_inline());
+  EXPECT_EQ(moved.size(), 2);
+  EXPECT_EQ(moved[1], "two");
+  EXPECT_TRUE(v.empty());
+}
+
+TEST(SmallVectorTest, SwapMixedStorage) {
+  s21::small_vector<std::string, 2> a = {"a"};
+  s21::small_vector<std::string, 2> b = {"b", "c", "d"};
+  a.swap(b);
+  EXPECT_EQ(a.size(), 3);
+  EXPECT_EQ(a[2], "d");
+  EXPECT_EQ(b.size(), 1);
+  EXPECT_EQ(b[0], "a");
+  EXPECT_TRUE(b.is_inline());
+}
+
+TEST(SmallVectorTest, InsertEraseEmplace) {
+  s21::small_vector<std::string, 3> v = {"a", "d"};
+  v.insert_many(v.begin() + 1, "b", "c");
+  v.emplace(v.end(), 2, 'e');
+  v.emplace_back("f");
+  ASSERT_EQ(v.size(), 6);
+  EXPECT_EQ(v[2], "c");
+  EXPECT_EQ(v[4], "ee");
+  v.erase(v.begin());
+  EXPECT_EQ(v.front(), "b");
+  EXPECT_EQ(v.back(), "f");
+}
+
+TEST(SmallVectorTest, PushBackOwnElementOnSpill) {
+  s21::small_vector<std::string, 2> v = {"first", "second"};
+  v.push_back(v[0]);
+  EXPECT_EQ(v[2], "first");
+}
+
+TEST(SmallVectorTest, InsertManyOwnElementsOnSpill) {
+  s21::small_vector<std::string, 2> v = {std::string(40, 'a'),
+                                         std::string(40, 'b')};
+  v.insert_many(v.begin(), v[0], v[1]);
+  ASSERT_EQ(v.size(), 4);
+  EXPECT_EQ(v[2], std::string(40, 'a'));
+  EXPECT_EQ(v[3], std::string(40, 'b'));
+  v.insert_many_back(v[1]);
+  EXPECT_EQ(v[4], std::string(40, 'b'));
+}
+
+TEST(SmallVectorTest, InsertManyOwnElementsInline) {
+  s21::small_vector<int, 8> v = {0, 1, 2, 3};
+  v.insert_many(v.begin() + 1, v[3], v[1]);
+  ASSERT_TRUE(v.is_inline());
+  ASSERT_EQ(v.size(), 6);
+  int expected[] = {0, 3, 1, 1, 2, 3};
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(v[i], expected[i]) << i;
+  }
+  v.erase(v.begin() + 2);
+  EXPECT_EQ(v[2], 1);
+  EXPECT_EQ(v.size(), 5);
+}
+
+namespace {
+
+// Copies throw once copies_left reaches zero.
+struct ThrowingCopy {
+  static int alive;
+  static int copies_left;
+
+  ThrowingCopy() { ++alive; }
+  ThrowingCopy(const ThrowingCopy&) {
+    if (copies_left == 0) {
+      throw std::runtime_error("copy failed");
+    }
+    --copies_left;
+    ++alive;
+  }
+  ThrowingCopy(ThrowingCopy&&) noexcept { ++alive; }
+  ThrowingCopy& operator=(const ThrowingCopy&) = default;
+  ThrowingCopy& operator=(ThrowingCopy&&) noexcept = default;
+  ~ThrowingCopy() { --alive; }
+};
+
+int ThrowingCopy::alive = 0;
+int ThrowingCopy::copies_left = -1;
+
+}  // namespace
+
+TEST(SmallVectorTest, InsertManyRollsBackWhenAnArgumentThrows) {
+  {
+    s21::small_vector<ThrowingCopy, 4> v(2);
+    ThrowingCopy item;
+    ThrowingCopy::copies_left = 1;
+    EXPECT_THROW(v.insert_many(v.begin(), item, item), std::runtime_error);
+    EXPECT_EQ(v.size(), 2);
+    EXPECT_EQ(ThrowingCopy::alive, 3);
+    ThrowingCopy::copies_left = 2;
+    EXPECT_THROW(v.insert_many(v.begin(), item, item, item),
+                 std::runtime_error);
+    ThrowingCopy::copies_left = -1;
+    EXPECT_EQ(v.size(), 2);
+    EXPECT_EQ(v.capacity(), 4);
+    EXPECT_EQ(ThrowingCopy::alive, 3);
+  }
+  EXPECT_EQ(ThrowingCopy::alive, 0);
+}
+
+TEST(SmallVectorTest, PmrEmplaceUsesResource) {
+  CountingResource resource;
+  std::pmr::memory_resource* previous =
+      std::pmr::set_default_resource(std::pmr::null_memory_resource());
+  s21::pmr::small_vector<std::pmr::string, 4> v(&resource);
+  v.emplace_back("a string long enough to need its own heap block");
+  EXPECT_NO_THROW(
+      v.emplace(v.begin(), "a middle string long enough to need a block"));
+  std::pmr::set_default_resource(previous);
+  ASSERT_EQ(v.size(), 2);
+  EXPECT_EQ(v[0].get_allocator().resource(), &resource);
+  EXPECT_EQ(v[1], "a string long enough to need its own heap block");
+}
+
+TEST(SmallVectorTest, AtOutOfRange) {
+  s21::small_vector<int, 2> v(2);
+  EXPECT_EQ(v.at(1), 0);
+  EXPECT_THROW(v.at(2), std::out_of_range);
+}
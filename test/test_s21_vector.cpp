@@ -1,5 +1,17 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <list>
+#include <ranges>
+#include <sstream>
+#include <string>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "../src/s21_vector/s21_mmap_allocator.h"
 #include "../src/s21_vector/s21_vector.h"
 
 TEST(VectorTest, DefaultConstructor) {
@@ -890,6 +902,656 @@ TEST(VectorTest, InsertManyMixedTypesConvertible) {
   EXPECT_DOUBLE_EQ(v[3], 4.5);
 }
 
+namespace {
+
+struct Tracked {
+  static int alive;
+  static int copies;
+  int value;
+
+  Tracked(int v = 0) : value(v) { ++alive; }
+  Tracked(const Tracked& other) : value(other.value) {
+    ++alive;
+    ++copies;
+  }
+  Tracked(Tracked&& other) noexcept : value(other.value) { ++alive; }
+  Tracked& operator=(const Tracked& other) {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+  Tracked& operator=(Tracked&& other) noexcept {
+    value = other.value;
+    return *this;
+  }
+  ~Tracked() { --alive; }
+};
+
+int Tracked::alive = 0;
+int Tracked::copies = 0;
+
+}  // namespace
+
+TEST(VectorTest, ReserveDoesNotConstructSpareSlots) {
+  Tracked::alive = 0;
+  {
+    s21::vector<Tracked> v;
+    v.reserve(100);
+    EXPECT_EQ(Tracked::alive, 0);
+    v.push_back(Tracked(1));
+    EXPECT_EQ(Tracked::alive, 1);
+  }
+  EXPECT_EQ(Tracked::alive, 0);
+}
+
+TEST(VectorTest, GrowthMovesInsteadOfCopying) {
+  Tracked::copies = 0;
+  s21::vector<Tracked> v;
+  Tracked item(7);
+  for (int i = 0; i < 100; ++i) {
+    v.push_back(item);
+  }
+  EXPECT_EQ(Tracked::copies, 100);
+  v.shrink_to_fit();
+  v.reserve(1000);
+  EXPECT_EQ(Tracked::copies, 100);
+  EXPECT_EQ(v[99].value, 7);
+}
+
+TEST(VectorTest, ClearPopEraseDestroyElements) {
+  Tracked::alive = 0;
+  s21::vector<Tracked> v;
+  for (int i = 0; i < 10; ++i) {
+    v.push_back(Tracked(i));
+  }
+  EXPECT_EQ(Tracked::alive, 10);
+
+  v.pop_back();
+  EXPECT_EQ(Tracked::alive, 9);
+
+  v.erase(v.begin() + 2);
+  EXPECT_EQ(Tracked::alive, 8);
+  EXPECT_EQ(v[2].value, 3);
+
+  v.clear();
+  EXPECT_EQ(Tracked::alive, 0);
+  EXPECT_GE(v.capacity(), 10);
+}
+
+TEST(VectorTest, PushBackOwnElementOnReallocation) {
+  s21::vector<std::string> v = {"first", "second"};
+  EXPECT_EQ(v.capacity(), 2);
+  v.push_back(v[0]);
+  v.insert(v.begin(), v[2]);
+  EXPECT_EQ(v.size(), 4);
+  EXPECT_EQ(v[0], "first");
+  EXPECT_EQ(v[3], "first");
+}
+
+TEST(VectorTest, EmplaceBackConstructsInPlace) {
+  s21::vector<std::pair<int, std::string>> v;
+  auto& ref = v.emplace_back(1, "one");
+  EXPECT_EQ(ref.first, 1);
+  EXPECT_EQ(ref.second, "one");
+
+  v.emplace_back(2, "two");
+  v.emplace_back(3, std::string(5, 'x'));
+  EXPECT_EQ(v.size(), 3);
+  EXPECT_EQ(v[1].second, "two");
+  EXPECT_EQ(v[2].second, "xxxxx");
+}
+
+TEST(VectorTest, EmplaceAtPosition) {
+  s21::vector<std::string> v = {"a", "d"};
+  auto it = v.emplace(v.begin() + 1, 2, 'b');
+  EXPECT_EQ(*it, "bb");
+  it = v.emplace(v.end(), "e");
+  EXPECT_EQ(*it, "e");
+  it = v.emplace(v.begin() + 2, "c");
+  EXPECT_EQ(v.size(), 5);
+  EXPECT_EQ(v[0], "a");
+  EXPECT_EQ(v[1], "bb");
+  EXPECT_EQ(v[2], "c");
+  EXPECT_EQ(v[3], "d");
+  EXPECT_EQ(v[4], "e");
+  EXPECT_THROW(v.emplace(v.end() + 1, "z"), std::out_of_range);
+}
+
+TEST(VectorTest, PushBackRvalueDoesNotCopy) {
+  Tracked::copies = 0;
+  s21::vector<Tracked> v;
+  for (int i = 0; i < 50; ++i) {
+    v.push_back(Tracked(i));
+  }
+  v.insert(v.begin() + 10, Tracked(100));
+  v.emplace_back(200);
+  v.insert_many(v.begin() + 1, Tracked(1), Tracked(2));
+  v.insert_many_back(Tracked(3));
+  EXPECT_EQ(Tracked::copies, 0);
+  EXPECT_EQ(v.size(), 55);
+  EXPECT_EQ(v[12].value, 100);
+  EXPECT_EQ(v[53].value, 200);
+}
+
+TEST(VectorTest, TriviallyCopyableShifts) {
+  struct Point {
+    int x;
+    double y;
+  };
+  s21::vector<Point> v;
+  for (int i = 0; i < 10; ++i) {
+    v.push_back({i, i * 0.5});
+  }
+  v.insert(v.begin() + 3, Point{100, 1.5});
+  v.insert_many(v.begin() + 1, Point{200, 2.5}, Point{300, 3.5});
+  v.erase(v.begin() + 5);
+  v.shrink_to_fit();
+
+  EXPECT_EQ(v.size(), 12);
+  EXPECT_EQ(v.capacity(), 12);
+  int expected[] = {0, 200, 300, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  for (int i = 0; i < 12; ++i) {
+    EXPECT_EQ(v[i].x, expected[i]);
+  }
+  EXPECT_DOUBLE_EQ(v[11].y, 4.5);
+}
+
+TEST(VectorTest, PmrVectorAllocatesFromResource) {
+  alignas(std::max_align_t) std::byte buffer[4096];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                            std::pmr::null_memory_resource());
+  auto in_arena = [&](const void* p) {
+    return p >= buffer && p < buffer + sizeof(buffer);
+  };
+
+  s21::pmr::vector<std::pmr::string> v(&arena);
+  v.emplace_back("a string long enough to need its own heap block");
+  v.push_back("short");
+  v.reserve(16);
+
+  EXPECT_EQ(v.get_allocator().resource(), &arena);
+  EXPECT_TRUE(in_arena(v.data()));
+  EXPECT_EQ(v[0].get_allocator().resource(), &arena);
+  EXPECT_TRUE(in_arena(v[0].data()));
+
+  s21::pmr::vector<std::pmr::string> moved(std::move(v), &arena);
+  EXPECT_EQ(moved.size(), 2);
+  EXPECT_EQ(moved[1], "short");
+}
+
+TEST(VectorTest, PmrEmplaceBuildsTemporaryFromResource) {
+  alignas(std::max_align_t) std::byte buffer[4096];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                            std::pmr::null_memory_resource());
+  std::pmr::memory_resource* previous =
+      std::pmr::set_default_resource(std::pmr::null_memory_resource());
+
+  s21::pmr::vector<std::pmr::string> v(&arena);
+  v.reserve(4);
+  v.emplace_back("a string long enough to need its own heap block");
+  v.emplace_back("another string long enough to need a heap block");
+  EXPECT_NO_THROW(
+      v.emplace(v.begin(), "a middle string long enough to need a block"));
+  std::pmr::set_default_resource(previous);
+
+  ASSERT_EQ(v.size(), 3);
+  EXPECT_EQ(v[0], "a middle string long enough to need a block");
+  EXPECT_EQ(v[0].get_allocator().resource(), &arena);
+  EXPECT_EQ(v[2], "another string long enough to need a heap block");
+}
+
+namespace {
+
+// Copies throw once copies_left reaches zero.
+struct ThrowingCopy {
+  static int alive;
+  static int copies_left;
+  int value;
+
+  ThrowingCopy(int v = 0) : value(v) { ++alive; }
+  ThrowingCopy(const ThrowingCopy& other) : value(other.value) {
+    if (copies_left == 0) {
+      throw std::runtime_error("copy failed");
+    }
+    --copies_left;
+    ++alive;
+  }
+  ThrowingCopy(ThrowingCopy&& other) noexcept : value(other.value) {
+    ++alive;
+  }
+  ThrowingCopy& operator=(const ThrowingCopy&) = default;
+  ThrowingCopy& operator=(ThrowingCopy&&) noexcept = default;
+  ~ThrowingCopy() { --alive; }
+};
+
+int ThrowingCopy::alive = 0;
+int ThrowingCopy::copies_left = -1;
+
+}  // namespace
+
+TEST(VectorTest, InsertManyRollsBackWhenAnArgumentThrows) {
+  ThrowingCopy::alive = 0;
+  {
+    s21::vector<ThrowingCopy> v;
+    v.reserve(8);
+    for (int i = 0; i < 3; ++i) {
+      v.emplace_back(i);
+    }
+    ThrowingCopy a(10), b(20);
+
+    ThrowingCopy::copies_left = 1;
+    EXPECT_THROW(v.insert_many(v.begin() + 1, a, b), std::runtime_error);
+    ASSERT_EQ(v.size(), 3);
+    EXPECT_EQ(ThrowingCopy::alive, 5);
+
+    v.shrink_to_fit();
+    ThrowingCopy::copies_left = 1;
+    EXPECT_THROW(v.insert_many(v.begin() + 1, a, b), std::runtime_error);
+    ThrowingCopy::copies_left = -1;
+    ASSERT_EQ(v.size(), 3);
+    EXPECT_EQ(v.capacity(), 3);
+    EXPECT_EQ(ThrowingCopy::alive, 5);
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_EQ(v[i].value, i);
+    }
+  }
+  EXPECT_EQ(ThrowingCopy::alive, 0);
+}
+
+TEST(VectorTest, InsertManyCopiesArgumentsThatAliasElements) {
+  s21::vector<std::string> v = {std::string(40, 'a'), std::string(40, 'b')};
+  v.shrink_to_fit();
+  ASSERT_EQ(v.size(), v.capacity());
+
+  v.insert_many(v.begin(), v[0], v[1]);
+  ASSERT_EQ(v.size(), 4);
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    EXPECT_EQ(v[i], std::string(40, i % 2 ? 'b' : 'a'));
+  }
+
+  v.shrink_to_fit();
+  v.insert_many_back(v[0], v[3]);
+  ASSERT_EQ(v.size(), 6);
+  EXPECT_EQ(v[4], std::string(40, 'a'));
+  EXPECT_EQ(v[5], std::string(40, 'b'));
+
+  v.reserve(16);
+  v.insert_many(v.begin() + 1, v[5], v[0]);
+  ASSERT_EQ(v.size(), 8);
+  EXPECT_EQ(v[1], std::string(40, 'b'));
+  EXPECT_EQ(v[2], std::string(40, 'a'));
+  EXPECT_EQ(v[3], std::string(40, 'b'));
+}
+
+TEST(VectorTest, InsertManyShiftsTriviallyCopyableTailOnce) {
+  // the tail is memmoved over the argument slots, so the values must be
+  // taken before it moves
+  s21::vector<int> v = {0, 1, 2, 3, 4, 5};
+  v.reserve(16);
+  auto it = v.insert_many(v.begin() + 1, v[4], v[1], v[5]);
+  EXPECT_EQ(it, v.begin() + 1);
+  std::vector<int> expected = {0, 4, 1, 5, 1, 2, 3, 4, 5};
+  EXPECT_TRUE(std::equal(v.begin(), v.end(), expected.begin(),
+                         expected.end()));
+  v.insert_many(v.end(), v[0], 7);
+  EXPECT_EQ(v.size(), 11);
+  EXPECT_EQ(v[9], 0);
+  EXPECT_EQ(v[10], 7);
+}
+
+TEST(VectorTest, DefaultGrowthDoubles) {
+  s21::vector<int> v;
+  v.push_back(1);
+  EXPECT_EQ(v.capacity(), 1);
+  v.push_back(2);
+  v.push_back(3);
+  EXPECT_EQ(v.capacity(), 4);
+  EXPECT_EQ(v.wasted_capacity(), 1);
+}
+
+TEST(VectorTest, OneAndHalfGrowth) {
+  s21::vector<int, std::allocator<int>, s21::growth::one_and_half> v;
+  for (int i = 0; i < 100; ++i) {
+    std::size_t before = v.capacity();
+    v.push_back(i);
+    if (before >= 2 && v.capacity() != before) {
+      EXPECT_EQ(v.capacity(), before + before / 2);
+    }
+  }
+  EXPECT_LT(v.wasted_capacity() * 3, v.capacity());
+  for (int i = 0; i < 100; ++i) EXPECT_EQ(v[i], i);
+}
+
+TEST(VectorTest, UsableSizeGrowthFillsSizeClass) {
+#if !defined(__GLIBC__)
+  GTEST_SKIP() << "the size classes are glibc's";
+#endif
+  s21::vector<char, std::allocator<char>, s21::growth::usable_size> v;
+  v.push_back('a');
+  // the smallest malloc chunk already has 24 usable bytes
+  EXPECT_EQ(v.capacity(), 24);
+  for (int i = 0; i < 1000; ++i) v.push_back('b');
+  EXPECT_EQ(s21::growth::glibc_size_class_bytes(v.capacity()), v.capacity());
+  EXPECT_EQ(v.size(), 1001);
+  EXPECT_EQ(v[0], 'a');
+}
+
+TEST(VectorTest, UsableSizeGrowthKeepsWholeElements) {
+  struct Triple {
+    char bytes[3];
+  };
+  s21::vector<Triple, std::allocator<Triple>, s21::growth::usable_size> v;
+  for (int i = 0; i < 50; ++i) v.push_back(Triple{});
+  std::size_t bytes = v.capacity() * sizeof(Triple);
+  EXPECT_GE(v.capacity(), 50);
+#if defined(__GLIBC__)
+  EXPECT_LT(s21::growth::glibc_size_class_bytes(bytes) - bytes,
+            sizeof(Triple));
+#endif
+}
+
+TEST(VectorTest, UsableSizeGrowthOnlyForStdAllocator) {
+  using s21::growth::suits;
+  using s21::growth::usable_size;
+  EXPECT_TRUE((suits<usable_size, std::allocator<int>>));
+  EXPECT_FALSE((suits<usable_size, std::pmr::polymorphic_allocator<int>>));
+  EXPECT_FALSE((suits<usable_size, s21::mmap_allocator<int>>));
+  EXPECT_TRUE((suits<s21::growth::one_and_half,
+                     std::pmr::polymorphic_allocator<int>>));
+}
+
+TEST(VectorTest, GlibcSizeClassBoundsUsableSize) {
+#if defined(__SANITIZE_ADDRESS__)
+  GTEST_SKIP() << "sanitizer allocators do not round to size classes";
+#elif defined(__GLIBC__)
+  // malloc may hand out a free chunk left by earlier allocations whole, a
+  // little larger than the size class, so the usable size only bounds the
+  // prediction from above; the prediction wastes less than a minimum chunk
+  for (std::size_t n : {1, 24, 25, 100, 1000, 4000}) {
+    void* p = std::malloc(n);
+    std::size_t usable = malloc_usable_size(p);
+    std::size_t predicted = s21::growth::glibc_size_class_bytes(n);
+    EXPECT_GE(usable, predicted) << n;
+    EXPECT_GE(predicted, n) << n;
+    EXPECT_LT(predicted - n, std::size_t{32}) << n;
+    std::free(p);
+  }
+#endif
+}
+
+TEST(VectorTest, MmapAllocatorGrowsAcrossThreshold) {
+  using Alloc = s21::mmap_allocator<int, 4096>;
+  s21::vector<int, Alloc> v;
+  for (int i = 0; i < 100000; ++i) v.push_back(i);
+  EXPECT_TRUE(Alloc::is_mapped(v.capacity()));
+  for (int i = 0; i < 100000; ++i) ASSERT_EQ(v[i], i);
+
+  v.insert(v.begin(), v[99999]);
+  EXPECT_EQ(v[0], 99999);
+  EXPECT_EQ(v[1], 0);
+  EXPECT_EQ(v.back(), 99999);
+}
+
+TEST(VectorTest, MmapAllocatorShrinksBelowThreshold) {
+  using Alloc = s21::mmap_allocator<int, 4096>;
+  s21::vector<int, Alloc> v(50000);
+  v[10] = 7;
+  while (v.size() > 100) v.pop_back();
+  v.shrink_to_fit();
+  EXPECT_FALSE(Alloc::is_mapped(v.capacity()));
+  EXPECT_EQ(v.size(), 100);
+  EXPECT_EQ(v[10], 7);
+  v.shrink_to_fit();
+  v.clear();
+  v.shrink_to_fit();
+  EXPECT_EQ(v.capacity(), 0);
+}
+
+TEST(VectorTest, HugeVectorCopyAndMove) {
+  s21::huge_vector<double> v = {1.5, 2.5};
+  v.reserve(10000000);
+  s21::huge_vector<double> copy(v);
+  s21::huge_vector<double> moved(std::move(v));
+  EXPECT_EQ(copy.size(), 2);
+  EXPECT_EQ(copy[1], 2.5);
+  EXPECT_EQ(moved.capacity(), 10000000);
+  EXPECT_EQ(moved[0], 1.5);
+}
+
+static_assert(std::contiguous_iterator<s21::vector<int>::iterator>);
+static_assert(std::contiguous_iterator<s21::vector<int>::const_iterator>);
+static_assert(std::ranges::contiguous_range<s21::vector<int>>);
+static_assert(
+    std::is_same_v<std::iterator_traits<
+                       s21::vector<int>::iterator>::iterator_category,
+                   std::random_access_iterator_tag>);
+
+TEST(VectorTest, IteratorsWorkWithStandardAlgorithms) {
+  s21::vector<int> v = {5, 3, 9, 1, 7};
+  std::sort(v.begin(), v.end());
+  EXPECT_TRUE(std::is_sorted(v.begin(), v.end()));
+  EXPECT_EQ(*std::lower_bound(v.begin(), v.end(), 6), 7);
+  EXPECT_EQ(std::ranges::max(v), 9);
+
+  int out[5] = {};
+  std::copy(v.begin(), v.end(), out);
+  EXPECT_EQ(out[4], 9);
+
+  s21::vector<int> reversed(v.size());
+  std::reverse_copy(v.begin(), v.end(), reversed.begin());
+  EXPECT_EQ(reversed.front(), 9);
+}
+
+TEST(VectorTest, IteratorRandomAccessOperations) {
+  s21::vector<int> v = {10, 20, 30, 40};
+  auto it = v.begin();
+  EXPECT_EQ(it[2], 30);
+  EXPECT_EQ(*(2 + it), 30);
+  EXPECT_TRUE(it < v.end());
+  EXPECT_TRUE(v.end() > it);
+  EXPECT_LE(it, it);
+  EXPECT_EQ(std::to_address(it + 1), v.data() + 1);
+
+  s21::vector<int>::const_iterator cit = it + 3;
+  EXPECT_TRUE(it < cit);
+  EXPECT_TRUE(cit != it);
+  EXPECT_EQ(cit - v.begin(), 3);
+  EXPECT_EQ(*cit, 40);
+
+  s21::vector<std::pair<int, int>> pairs = {{1, 2}};
+  EXPECT_EQ(pairs.begin()->second, 2);
+}
+
+TEST(VectorTest, RangeInsertInPlaceAndGrowing) {
+  std::string items[] = {"x", "y", "z"};
+  s21::vector<std::string> v = {"a", "b", "c", "d", "e"};
+  v.reserve(20);
+  // tail longer than the range
+  auto it = v.insert(v.begin() + 1, items, items + 2);
+  EXPECT_EQ(*it, "x");
+  // tail shorter than the range
+  v.insert(v.end() - 1, items, items + 3);
+  s21::vector<std::string> expected = {"a", "x", "y", "b", "c",
+                                       "d", "x", "y", "z", "e"};
+  ASSERT_EQ(v.size(), expected.size());
+  EXPECT_TRUE(std::equal(v.begin(), v.end(), expected.begin()));
+
+  s21::vector<std::string> small = {"1"};
+  small.insert(small.begin(), items, items + 3);
+  EXPECT_EQ(small.size(), 4);
+  EXPECT_EQ(small.front(), "x");
+  EXPECT_EQ(small.back(), "1");
+}
+
+TEST(VectorTest, RangeInsertTriviallyCopyableAndInitList) {
+  s21::vector<int> v = {1, 5};
+  v.insert(v.begin() + 1, {2, 3, 4});
+  int more[] = {6, 7};
+  v.insert(v.end(), more, more + 2);
+  for (int i = 0; i < 7; ++i) EXPECT_EQ(v[i], i + 1);
+}
+
+TEST(VectorTest, RangeInsertFromInputIterator) {
+  std::istringstream in("3 4 5");
+  s21::vector<int> v = {1, 2, 6};
+  v.insert(v.begin() + 2, std::istream_iterator<int>(in),
+           std::istream_iterator<int>());
+  for (int i = 0; i < 6; ++i) EXPECT_EQ(v[i], i + 1);
+}
+
+namespace {
+
+struct MoveCounted {
+  static int moves;
+  int value;
+
+  MoveCounted(int v = 0) : value(v) {}
+  MoveCounted(MoveCounted&& other) noexcept : value(other.value) { ++moves; }
+  MoveCounted& operator=(MoveCounted&& other) noexcept {
+    value = other.value;
+    ++moves;
+    return *this;
+  }
+};
+
+int MoveCounted::moves = 0;
+
+class AllocationCounter : public std::pmr::memory_resource {
+ public:
+  int allocations = 0;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t align) override {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+  void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+  bool do_is_equal(const memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+}  // namespace
+
+TEST(VectorTest, RangeInsertMeasuresMoveIterators) {
+  // std::move_iterator<T*> is a C++20 input iterator, but its C++17
+  // category is random access, so the range is measured up front
+  AllocationCounter resource;
+  s21::pmr::vector<MoveCounted> v(&resource);
+  v.reserve(1000);
+  for (int i = 0; i < 1000; ++i) v.emplace_back(i);
+  s21::vector<MoveCounted> items(1000);
+  for (int i = 0; i < 1000; ++i) items[i].value = 1000 + i;
+
+  int allocations = resource.allocations;
+  MoveCounted::moves = 0;
+  v.insert(v.begin() + 500, std::make_move_iterator(items.data()),
+           std::make_move_iterator(items.data() + items.size()));
+  EXPECT_EQ(resource.allocations, allocations + 1);
+  // each new element built once, each old one relocated once
+  EXPECT_EQ(MoveCounted::moves, 2000);
+  ASSERT_EQ(v.size(), 2000);
+  EXPECT_EQ(v[499].value, 499);
+  EXPECT_EQ(v[500].value, 1000);
+  EXPECT_EQ(v[1499].value, 1999);
+  EXPECT_EQ(v[1500].value, 500);
+
+  // in place the tail of 1500 is shifted once
+  v.reserve(4000);
+  allocations = resource.allocations;
+  MoveCounted::moves = 0;
+  v.insert(v.begin() + 500, std::make_move_iterator(items.data()),
+           std::make_move_iterator(items.data() + items.size()));
+  EXPECT_EQ(resource.allocations, allocations);
+  EXPECT_EQ(MoveCounted::moves, 1500 + 1000);
+
+  allocations = resource.allocations;
+  v.assign(std::make_move_iterator(items.data()),
+           std::make_move_iterator(items.data() + 1000));
+  EXPECT_EQ(resource.allocations, allocations);
+  EXPECT_EQ(v.size(), 1000);
+}
+
+TEST(VectorTest, RangeInsertReservesForSizedSinglePassRange) {
+  AllocationCounter resource;
+  s21::pmr::vector<int> v({1, 2, 9}, &resource);
+  std::istringstream in("3 4 5 6 7 8");
+  std::counted_iterator first(std::istream_iterator<int>(in), 6);
+  std::counted_iterator last(std::istream_iterator<int>(), 0);
+  int allocations = resource.allocations;
+  v.insert(v.begin() + 2, first, last);
+  EXPECT_EQ(resource.allocations, allocations + 1);
+  for (int i = 0; i < 9; ++i) EXPECT_EQ(v[i], i + 1);
+
+  std::istringstream again("10 11 12 13 14 15 16 17 18 19 20 21");
+  allocations = resource.allocations;
+  v.assign(std::counted_iterator(std::istream_iterator<int>(again), 12),
+           std::counted_iterator(std::istream_iterator<int>(), 0));
+  EXPECT_EQ(resource.allocations, allocations + 1);
+  ASSERT_EQ(v.size(), 12);
+  EXPECT_EQ(v[11], 21);
+}
+
+TEST(VectorTest, EraseRange) {
+  Tracked::alive = 0;
+  {
+    s21::vector<Tracked> v;
+    for (int i = 0; i < 6; ++i) v.emplace_back(i);
+    auto it = v.erase(v.begin() + 1, v.begin() + 4);
+    EXPECT_EQ(it->value, 4);
+    EXPECT_EQ(v.size(), 3);
+    EXPECT_EQ(Tracked::alive, 3);
+    EXPECT_EQ(v.erase(v.begin(), v.begin()), v.begin());
+    EXPECT_THROW(v.erase(v.begin() + 2, v.begin() + 1), std::out_of_range);
+  }
+  EXPECT_EQ(Tracked::alive, 0);
+
+  s21::vector<int> ints = {1, 2, 3, 4};
+  ints.erase(ints.begin() + 2, ints.end());
+  EXPECT_EQ(ints.size(), 2);
+  EXPECT_EQ(ints.back(), 2);
+}
+
+TEST(VectorTest, AssignVariants) {
+  s21::vector<std::string> v = {"a", "b", "c"};
+  v.assign(2, "z");
+  EXPECT_EQ(v.size(), 2);
+  EXPECT_EQ(v[1], "z");
+  v.assign(5, v[0]);
+  EXPECT_EQ(v.size(), 5);
+  EXPECT_EQ(v[4], "z");
+
+  std::string items[] = {"p", "q", "r", "s", "t", "u"};
+  v.assign(items, items + 3);
+  EXPECT_EQ(v.size(), 3);
+  EXPECT_EQ(v[2], "r");
+  v.assign(items, items + 6);
+  EXPECT_EQ(v.back(), "u");
+  v.assign({"k"});
+  EXPECT_EQ(v.size(), 1);
+  EXPECT_EQ(v.front(), "k");
+}
+
+TEST(VectorTest, AppendRange) {
+  s21::vector<int> v = {0};
+  v.append_range(std::views::iota(1, 100));
+  EXPECT_EQ(v.size(), 100);
+  EXPECT_EQ(v[99], 99);
+  std::list<int> from_list = {100, 101};
+  v.append_range(from_list);
+  EXPECT_EQ(v.back(), 101);
+}
+
+TEST(VectorTest, EraseIf) {
+  s21::vector<int> v = {1, 2, 3, 4, 5, 6, 7};
+  auto removed = s21::erase_if(v, [](int x) { return x % 2 == 0; });
+  EXPECT_EQ(removed, 3);
+  s21::vector<int> expected = {1, 3, 5, 7};
+  EXPECT_TRUE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();